@@ -0,0 +1,69 @@
+/**
+ * @file example6_mining_server.cpp
+ * @brief Node that lets external miner processes extend its chain
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Usage: example6_mining_server [socket-path] [difficulty] [blocks]
+ *
+ * Start it, then run one or more `miner` processes against the same
+ * socket. The node stops after the requested number of blocks (or on
+ * Ctrl+C) and validates the resulting chain.
+ */
+
+#include "core/blockchain.h"
+#include "mining/work_server.h"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace blockchain;
+
+namespace {
+
+std::atomic<bool> interrupted(false);
+
+void onSignal(int) {
+    interrupted.store(true);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string socketPath = argc > 1 ? argv[1] : mining::DEFAULT_SOCKET_PATH;
+    const int difficulty = argc > 2 ? std::atoi(argv[2]) : 5;
+    const size_t blocks = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    GET-WORK MINING SERVER                         ║" << std::endl;
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+
+    Blockchain chain(difficulty);
+    unsigned long height = 0;
+    mining::WorkServer server(chain, socketPath, [&height]() {
+        height++;
+        return std::vector<Transaction>{
+            Transaction("Network", "Miner", 50.0),
+            Transaction("Alice", "Bob", 1.0 + height)
+        };
+    });
+
+    if (!server.start()) {
+        return 1;
+    }
+    std::cout << "→ Waiting for miners (run: miner " << socketPath << ")" << std::endl;
+
+    while (!interrupted.load() && server.getBlocksAccepted() < blocks) {
+        server.poll(100);
+    }
+    server.shutdown();
+
+    chain.displayStats();
+    std::cout << "Rejected submissions: " << server.getSubmissionsRejected() << std::endl;
+    return chain.isChainValid() ? 0 : 1;
+}
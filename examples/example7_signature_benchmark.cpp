@@ -0,0 +1,151 @@
+/**
+ * @file example7_signature_benchmark.cpp
+ * @brief Single vs batch Ed25519 verification benchmark
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Signs transactions with Ed25519 keys, compares one-by-one and batch
+ * verification throughput across batch sizes, then adds signed blocks
+ * to a chain that requires signatures.
+ */
+
+#include "core/blockchain.h"
+#include "core/transaction_view.h"
+#include "crypto/ed25519.h"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace blockchain;
+using namespace std::chrono;
+
+/**
+ * @brief Create signed transactions between a few key holders
+ */
+std::vector<Transaction> createSignedTransactions(const std::vector<crypto::Ed25519::KeyPair>& keys,
+                                                  size_t count) {
+    std::vector<Transaction> txs;
+    txs.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const auto& from = keys[i % keys.size()];
+        const auto& to = keys[(i + 1) % keys.size()];
+        Transaction tx = Transaction::fromUnits(Transaction::addressOf(from.getPublicKey()),
+                                                Transaction::addressOf(to.getPublicKey()),
+                                                static_cast<Amount>(1000 + i));
+        tx.sign(from);
+        txs.push_back(tx);
+    }
+    return txs;
+}
+
+/**
+ * @brief Compare one-by-one and batch verification
+ */
+void compareVerification(const std::vector<crypto::Ed25519::KeyPair>& keys) {
+    std::cout << "\n" << std::string(55, '=') << std::endl;
+    std::cout << "  TEST 1: Verification Throughput (signatures/s)" << std::endl;
+    std::cout << std::string(55, '=') << "\n" << std::endl;
+
+    std::cout << "╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Batch size |    Single   |    Batch    | Speedup ║" << std::endl;
+    std::cout << "╠═══════════════════════════════════════════════════╣" << std::endl;
+
+    for (size_t batchSize : {1, 8, 64, 256, 1024}) {
+        const std::vector<Transaction> txs = createSignedTransactions(keys, batchSize);
+        const int rounds = static_cast<int>(std::max<size_t>(1, 2048 / batchSize));
+
+        bool ok = true;
+        auto start = high_resolution_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (const auto& tx : txs) {
+                ok = ok && tx.verifySignature();
+            }
+        }
+        double singleSeconds = duration<double>(high_resolution_clock::now() - start).count();
+
+        start = high_resolution_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            ok = ok && Transaction::verifySignatures(txs, true);
+        }
+        double batchSeconds = duration<double>(high_resolution_clock::now() - start).count();
+
+        const double total = static_cast<double>(rounds * batchSize);
+        std::cout << "║  " << std::right << std::setw(10) << batchSize << " | "
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(11) << total / singleSeconds << " | "
+                  << std::setw(11) << total / batchSeconds << " | "
+                  << std::setprecision(2) << std::setw(6) << singleSeconds / batchSeconds
+                  << (ok ? "x" : "!") << " ║" << std::endl;
+    }
+
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+}
+
+/**
+ * @brief Add signed blocks and reject a forged one
+ */
+void signedChain(const std::vector<crypto::Ed25519::KeyPair>& keys) {
+    const int NUM_BLOCKS = 5;
+    const size_t TXS_PER_BLOCK = 200;
+
+    std::cout << "\n" << std::string(55, '=') << std::endl;
+    std::cout << "  TEST 2: Chain With Required Signatures" << std::endl;
+    std::cout << std::string(55, '=') << "\n" << std::endl;
+
+    Blockchain chain(2);
+    chain.setRequireSignatures(true);
+    chain.addValidator("Alice", 100);
+
+    auto start = high_resolution_clock::now();
+    int accepted = 0;
+    for (int b = 0; b < NUM_BLOCKS; b++) {
+        const auto txs = createSignedTransactions(keys, TXS_PER_BLOCK);
+        accepted += (b % 2 == 0 ? chain.addBlockPoW(txs) : chain.addBlockPoS(txs)) ? 1 : 0;
+    }
+    double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+    // An unsigned transaction, and a signed one whose amount was altered on the wire
+    std::vector<Transaction> unsignedTxs = {Transaction("Mallory", "Alice", 1.0)};
+    const bool unsignedRejected = !chain.addBlockPoS(unsignedTxs);
+
+    std::vector<Transaction> forged = createSignedTransactions(keys, 4);
+    std::vector<uint8_t> wire(forged.back().encodedSize());
+    forged.back().encode(wire.data());
+    wire[17] ^= 0x40;  // amount, inside the signed body
+    TransactionView view;
+    TransactionView::parse(wire.data(), wire.size(), view);
+    forged.push_back(view.toTransaction());
+    const bool forgedRejected = !chain.addBlockPoS(forged);
+
+    std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Blocks accepted: " << std::left << std::setw(32)
+              << (std::to_string(accepted) + " / " + std::to_string(NUM_BLOCKS)) << "║" << std::endl;
+    std::cout << "║  Time: " << std::left << std::setw(43)
+              << (std::to_string(static_cast<long long>(seconds * 1000)) + " ms") << "║" << std::endl;
+    std::cout << "║  Unsigned tx rejected: " << std::left << std::setw(27)
+              << (unsignedRejected ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "║  Forged tx rejected: " << std::left << std::setw(29)
+              << (forgedRejected ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "║  Chain valid: " << std::left << std::setw(36)
+              << (chain.isChainValid() ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+}
+
+int main() {
+    std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    ED25519 SIGNATURE BENCHMARK                    ║" << std::endl;
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+
+    std::vector<crypto::Ed25519::KeyPair> keys;
+    for (int i = 0; i < 16; i++) {
+        keys.push_back(crypto::Ed25519::KeyPair::generate());
+    }
+
+    compareVerification(keys);
+    signedChain(keys);
+
+    return 0;
+}
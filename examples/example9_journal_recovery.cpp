@@ -0,0 +1,253 @@
+/**
+ * @file example9_journal_recovery.cpp
+ * @brief Group-commit journal throughput and crash recovery
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Measures how many transactions share each fsync as submitters are
+ * added, then runs a node (mempool, block builder, block store) in a
+ * child process that checkpoints every few blocks, kills it with SIGKILL
+ * while batches are in flight, tears the journal tail by hand and
+ * recovers with Blockchain::recover(). Every transaction the child
+ * acknowledged as durable must come back, pending or confirmed.
+ */
+
+#include "core/blockchain.h"
+#include "core/mempool.h"
+#include "core/block_view.h"
+#include "storage/journal.h"
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace blockchain;
+using namespace std::chrono;
+
+const std::string DIRECTORY = "journal_demo";
+
+/**
+ * @brief Submit through a journaled mempool from several threads
+ */
+void measureGroupCommit() {
+    std::cout << "\n" << std::string(55, '=') << std::endl;
+    std::cout << "  TEST 1: Group Commit" << std::endl;
+    std::cout << std::string(55, '=') << "\n" << std::endl;
+
+    std::cout << "╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Threads |    tx/s    |  fsyncs  | tx per fsync   ║" << std::endl;
+    std::cout << "╠═══════════════════════════════════════════════════╣" << std::endl;
+
+    const size_t TOTAL = 4000;
+    for (int threads : {1, 4, 16, 64}) {
+        const std::string path = DIRECTORY + "/bench.wal";
+        std::remove(path.c_str());
+        storage::Journal journal;
+        journal.open(path);
+        Mempool pool;
+        pool.setJournal(&journal);
+
+        auto start = high_resolution_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                for (size_t i = t; i < TOTAL; i += threads) {
+                    pool.submit(Transaction::fromUnits("User" + std::to_string(t), "Shop",
+                                                       static_cast<Amount>(1000 + i)),
+                                static_cast<Amount>(i));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+        std::cout << "║  " << std::right << std::setw(7) << threads
+                  << " | " << std::setw(10) << std::fixed << std::setprecision(0) << TOTAL / seconds
+                  << " | " << std::setw(8) << journal.getBatches()
+                  << " | " << std::setw(12) << std::setprecision(1)
+                  << static_cast<double>(journal.getRecords()) / journal.getBatches() << "   ║" << std::endl;
+    }
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+}
+
+/**
+ * @brief Node run by the child: submit forever, build a block every few ms
+ *
+ * The hash of each transaction is written to ackFd once submit() has
+ * returned ACCEPTED, i.e. once it is durable. Every CHECKPOINT_BLOCKS
+ * blocks the store is synced and the journal compacted.
+ */
+[[noreturn]] void runNode(int ackFd) {
+    if (!std::freopen("/dev/null", "w", stdout)) {
+        std::_Exit(1);
+    }
+    storage::Journal journal;
+    Blockchain chain(1);
+    chain.addValidator("Alice", 100);
+    if (!journal.open(DIRECTORY + "/node.wal") || !chain.attachStore(DIRECTORY + "/blocks")) {
+        std::_Exit(1);
+    }
+    chain.setJournal(&journal);
+    Mempool pool;
+    pool.setJournal(&journal);
+
+    for (int p = 0; p < 4; p++) {
+        std::thread([&, p]() {
+            for (uint64_t i = 0;; i++) {
+                Transaction tx = Transaction::fromUnits("User" + std::to_string(p), "Shop",
+                                                        static_cast<Amount>(1000 + i));
+                if (pool.submit(tx, static_cast<Amount>(i % 1000)) == SubmitStatus::ACCEPTED) {
+                    // 32-byte writes to a pipe are atomic
+                    if (write(ackFd, tx.getHash().data(), crypto::Hash256::SIZE) < 0) {
+                        std::_Exit(1);
+                    }
+                }
+            }
+        }).detach();
+    }
+    const size_t CHECKPOINT_BLOCKS = 16;
+    while (true) {
+        std::this_thread::sleep_for(milliseconds(5));
+        std::vector<Transaction> txs = pool.takeBest(500);
+        if (!txs.empty() && chain.addBlockPoS(txs) && chain.getChainLength() % CHECKPOINT_BLOCKS == 0 &&
+            !chain.checkpoint(&pool)) {
+            std::_Exit(1);
+        }
+    }
+}
+
+/**
+ * @brief Kill a node mid-batch, tear the journal and recover
+ * @return true if the node ran until killed, nothing it acknowledged was
+ *         lost and the recovered chain is valid
+ */
+bool crashAndRecover() {
+    std::cout << "\n" << std::string(55, '=') << std::endl;
+    std::cout << "  TEST 2: Crash Injection and Recovery" << std::endl;
+    std::cout << std::string(55, '=') << "\n" << std::endl;
+
+    std::remove((DIRECTORY + "/node.wal").c_str());
+    std::system(("rm -rf " + DIRECTORY + "/blocks").c_str());
+
+    int acks[2];
+    if (pipe(acks) != 0) {
+        std::cerr << "✗ pipe failed" << std::endl;
+        return false;
+    }
+    std::cout.flush();
+    pid_t child = fork();
+    if (child == 0) {
+        ::close(acks[0]);
+        runNode(acks[1]);
+    }
+    ::close(acks[1]);
+
+    // Collect acknowledgements while the node runs, then kill it without warning
+    std::unordered_set<crypto::Hash256> acknowledged;
+    std::thread reader([&]() {
+        crypto::Hash256 hash;
+        while (read(acks[0], hash.data(), crypto::Hash256::SIZE) == static_cast<ssize_t>(crypto::Hash256::SIZE)) {
+            acknowledged.insert(hash);
+        }
+    });
+    std::this_thread::sleep_for(milliseconds(500));
+    kill(child, SIGKILL);
+    int status = 0;
+    waitpid(child, &status, 0);
+    reader.join();
+    ::close(acks[0]);
+    // A node that exited on its own hit an error before the crash
+    const bool killed = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+    std::cout << "  → Node killed (signal " << (WIFSIGNALED(status) ? WTERMSIG(status) : 0) << ")" << std::endl;
+
+    // Simulate power loss mid-write: half a record at the end of the file
+    {
+        int fd = ::open((DIRECTORY + "/node.wal").c_str(), O_WRONLY | O_APPEND);
+        const uint8_t torn[16] = {100, 0, 0, 0, 0xde, 0xad, 0xbe, 0xef, 2, 1, 2, 3, 4, 5, 6, 7};
+        if (fd < 0 || write(fd, torn, sizeof(torn)) != static_cast<ssize_t>(sizeof(torn))) {
+            std::cerr << "✗ Could not tear the journal" << std::endl;
+        }
+        ::close(fd);
+    }
+
+    // Recover: stored chain first, then the journal in order
+    auto start = high_resolution_clock::now();
+    storage::Journal journal;
+    Blockchain chain(1);
+    chain.addValidator("Alice", 100);
+    Mempool pool;
+    if (!journal.open(DIRECTORY + "/node.wal") || !chain.attachStore(DIRECTORY + "/blocks")) {
+        return false;
+    }
+    const size_t storedBlocks = chain.getChainLength();
+    RecoveryStats stats;
+    bool replayed = chain.recover(journal, &pool, &stats);
+    double recoveryMs = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+
+    // Every acknowledged transaction must be pending again or confirmed on the chain
+    std::unordered_set<crypto::Hash256> confirmed;
+    std::vector<TransactionView> views;
+    for (size_t height = 0; height < chain.getChainLength(); height++) {
+        BlockView block;
+        if (!chain.getBlock(static_cast<int>(height), block)) {
+            replayed = false;
+            break;
+        }
+        block.getTransactions(views);
+        for (const auto& view : views) {
+            confirmed.insert(view.computeHash());
+        }
+    }
+    const bool valid = chain.isChainValid();
+    size_t lost = 0;
+    for (const auto& hash : acknowledged) {
+        lost += confirmed.count(hash) == 0 && !pool.contains(hash) ? 1 : 0;
+    }
+
+    std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║  Acknowledged as durable: " << std::left << std::setw(24) << acknowledged.size() << "║" << std::endl;
+    std::cout << "║  Transaction records: " << std::left << std::setw(28) << stats.transactions << "║" << std::endl;
+    std::cout << "║  Acknowledged but lost: " << std::left << std::setw(26) << lost << "║" << std::endl;
+    std::cout << "║  Block records replayed: " << std::left << std::setw(25) << stats.blocks << "║" << std::endl;
+    std::cout << "║  Chain: " << std::left << std::setw(42)
+              << (std::to_string(storedBlocks) + " stored → " + std::to_string(chain.getChainLength()) + " blocks")
+              << "║" << std::endl;
+    std::cout << "║  Pending after recovery: " << std::left << std::setw(25) << pool.size() << "║" << std::endl;
+    std::cout << "║  Recovery time (ms): " << std::left << std::setw(29) << std::fixed << std::setprecision(1)
+              << recoveryMs << "║" << std::endl;
+    std::cout << "║  Journal replayed cleanly: " << std::left << std::setw(23)
+              << (replayed ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "║  Chain valid: " << std::left << std::setw(36)
+              << (valid ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "║  No acknowledged loss: " << std::left << std::setw(27)
+              << (lost == 0 ? "YES ✓" : "NO ✗") << "║" << std::endl;
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+    return killed && !acknowledged.empty() && replayed && valid && lost == 0;
+}
+
+int main() {
+    std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    WRITE-AHEAD JOURNAL                            ║" << std::endl;
+    std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
+
+    ::mkdir(DIRECTORY.c_str(), 0755);
+    measureGroupCommit();
+    if (!crashAndRecover()) {
+        std::cerr << "✗ Crash recovery failed" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
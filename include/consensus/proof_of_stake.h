@@ -0,0 +1,112 @@
+/**
+ * @file proof_of_stake.h
+ * @brief Proof of Stake consensus mechanism
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef PROOF_OF_STAKE_H
+#define PROOF_OF_STAKE_H
+
+#include <string>
+#include <vector>
+#include <random>
+
+namespace blockchain {
+namespace consensus {
+
+/**
+ * @struct Validator
+ * @brief A participant allowed to validate blocks
+ */
+struct Validator {
+    std::string name;  ///< Validator name
+    int stake;         ///< Amount staked
+    
+    Validator(const std::string& name, int stake) : name(name), stake(stake) {}
+};
+
+/**
+ * @class ProofOfStake
+ * @brief Implements the Proof of Stake consensus algorithm
+ * 
+ * Validators are selected at random with probability proportional to
+ * their stake.
+ * 
+ * Characteristics:
+ * - Security through economic stake
+ * - No mining work, so blocks are produced almost instantly
+ * - Very low energy consumption
+ */
+class ProofOfStake {
+private:
+    std::vector<Validator> validators;  ///< Registered validators
+    std::random_device rd;              ///< Seed source
+    std::mt19937 gen;                   ///< Random generator for selection
+    
+    /**
+     * @brief Sum of all stakes
+     * @return Total stake
+     */
+    int getTotalStake() const;
+
+public:
+    /**
+     * @brief Construct Proof of Stake engine
+     */
+    ProofOfStake();
+    
+    /**
+     * @brief Register a validator
+     * @param name Validator name
+     * @param stake Amount staked (must be positive)
+     * @return true if validator was added
+     */
+    bool addValidator(const std::string& name, int stake);
+    
+    /**
+     * @brief Remove a validator
+     * @param name Validator name
+     * @return true if validator was removed
+     */
+    bool removeValidator(const std::string& name);
+    
+    /**
+     * @brief Select a validator weighted by stake
+     * @return Selected validator name
+     */
+    std::string selectValidator();
+    
+    /**
+     * @brief Check that a block was produced by a registered validator
+     * @param validatorName Name of validator
+     * @return true if validator is registered
+     */
+    bool validateBlock(const std::string& validatorName) const;
+    
+    /**
+     * @brief Look up a validator
+     * @param name Validator name
+     * @return Pointer to validator, or nullptr if not found
+     */
+    const Validator* getValidator(const std::string& name) const;
+    
+    /**
+     * @brief Display registered validators
+     */
+    void displayValidators() const;
+    
+    /**
+     * @brief Display PoS statistics
+     */
+    void displayStats() const;
+    
+    // Getters
+    size_t getValidatorCount() const { return validators.size(); }
+    const std::vector<Validator>& getValidators() const { return validators; }
+};
+
+} // namespace consensus
+} // namespace blockchain
+
+#endif // PROOF_OF_STAKE_H
@@ -0,0 +1,201 @@
+/**
+ * @file proof_of_work.h
+ * @brief Proof of Work consensus mechanism
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef PROOF_OF_WORK_H
+#define PROOF_OF_WORK_H
+
+#include "consensus/target.h"
+#include "crypto/hash_policy.h"
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace blockchain {
+namespace consensus {
+
+/**
+ * @enum NonceFormat
+ * @brief How a nonce is written between the prefix and suffix
+ */
+enum class NonceFormat {
+    DECIMAL,   ///< ASCII decimal digits (ProofOfWork::mine)
+    UINT32_LE  ///< 4-byte little-endian integer (BlockHeader)
+};
+
+/**
+ * @struct MiningResult
+ * @brief Outcome of a nonce search
+ */
+struct MiningResult {
+    bool found = false;               ///< false if cancelled or the nonce range ran out
+    uint64_t nonce = 0;               ///< Winning nonce (if found)
+    crypto::ChainHasher::Digest digest{};  ///< Digest for the winning nonce
+    uint64_t hashes = 0;              ///< Attempts made by all threads
+    long long timeMs = 0;             ///< Wall-clock search time (ms)
+    double seconds = 0.0;             ///< Wall-clock search time (s, full precision)
+    unsigned threads = 1;             ///< Worker threads used
+    
+    /**
+     * @brief Aggregate hash rate over all threads
+     * @return Hashes per second
+     */
+    double hashRate() const {
+        return seconds > 0.0 ? hashes / seconds : 0.0;
+    }
+};
+
+/**
+ * @class ProofOfWork
+ * @brief Implements the Proof of Work consensus algorithm
+ * 
+ * Miners search for a nonce such that the chain hash of the data
+ * followed by the nonce, read as a 256-bit number, does not exceed the
+ * current target.
+ * 
+ * Every RETARGET_INTERVAL blocks the target is rescaled by the time the
+ * last interval actually took versus the expected interval * blockTime,
+ * clamped to a factor of 4 either way, so block spacing stays steady as
+ * hash power changes.
+ * 
+ * Characteristics:
+ * - Security through computational work
+ * - Target controls expected mining time
+ * - Verification is a single hash
+ */
+class ProofOfWork {
+private:
+    int difficulty;            ///< Leading hex zeros implied by the target
+    Target target;             ///< Current 256-bit target
+    uint32_t bits;             ///< Compact encoding of target
+    int retargetInterval;      ///< Blocks between adjustments (0 = never)
+    int64_t targetBlockTime;   ///< Desired seconds between blocks
+    long long miningTime;      ///< Duration of last mining run (ms)
+
+public:
+    static constexpr int RETARGET_INTERVAL = 10;     ///< Default blocks per adjustment
+    static constexpr int64_t TARGET_BLOCK_TIME = 10; ///< Default seconds per block
+    static constexpr uint32_t MAX_ADJUSTMENT = 4;    ///< Max scale per adjustment
+    
+    /**
+     * @brief Construct Proof of Work engine
+     * @param difficulty Number of leading zeros required
+     */
+    explicit ProofOfWork(int difficulty = 3);
+    
+    /**
+     * @brief Mine data by searching for a valid nonce
+     * 
+     * The data is absorbed once and candidate nonces are searched with
+     * searchNonce(); the first valid nonce in ascending order wins,
+     * exactly as with a one-at-a-time search.
+     * 
+     * @param data Data to mine
+     * @param nonce Output: one past the winning nonce (unchanged if none is found)
+     * @return Valid hash, or an empty string if no nonce up to INT_MAX - 1 meets the target
+     */
+    std::string mine(const std::string& data, int& nonce);
+    
+    /**
+     * @brief Search for a nonce using a cached midstate
+     * 
+     * Hashes prefix + nonce + suffix for nonces from startNonce upward,
+     * with the nonce written as described by format. The prefix is compressed once by the caller; each attempt
+     * only runs the final block(s) holding the nonce, spread across the
+     * ChainHasher::hashSuffixBatch lanes.
+     * 
+     * With several threads the nonce space is split into interleaved
+     * chunks, one stripe per worker. All workers stop as soon as one
+     * finds a solution or the cancel flag is raised (e.g. a new tip
+     * arrived). A single thread returns the lowest valid nonce; with
+     * more threads any valid nonce may win.
+     * 
+     * @param prefix Hasher that has absorbed the fixed data before the nonce
+     * @param suffix Fixed data after the nonce
+     * @param startNonce First nonce to try
+     * @param target Digest must be at or below this value
+     * @param threads Worker threads (0 = hardware concurrency)
+     * @param cancel Optional external stop flag, polled between batches
+     * @param format Nonce encoding
+     * @param lastNonce Last nonce to try (inclusive), e.g. the end of an
+     *        assigned work range; UINT32_LE nonces stop at 2^32 - 1
+     * @return Search result with the nonce, digest and hash count; not
+     *         found if cancelled or every nonce in the range failed
+     */
+    static MiningResult searchNonce(const crypto::ChainHasher& prefix, const std::string& suffix,
+                                    uint64_t startNonce, const Target& target, unsigned threads = 1,
+                                    const std::atomic<bool>* cancel = nullptr,
+                                    NonceFormat format = NonceFormat::DECIMAL,
+                                    uint64_t lastNonce = std::numeric_limits<uint32_t>::max());
+    
+    /**
+     * @brief Check if hash meets the current target
+     * @param hash Hash to validate (64 hex characters)
+     * @return true if hash is well formed and at or below the target
+     */
+    bool validateHash(const std::string& hash) const;
+    
+    /**
+     * @brief Set mining difficulty as a number of leading hex zeros
+     * @param newDifficulty New difficulty (1-64)
+     */
+    void setDifficulty(int newDifficulty);
+    
+    /**
+     * @brief Set the current target from its compact encoding
+     * @param newBits Compact target
+     * @return false if newBits is not a valid target
+     */
+    bool setBits(uint32_t newBits);
+    
+    /**
+     * @brief Configure automatic retargeting
+     * @param interval Blocks between adjustments (0 disables retargeting)
+     * @param blockTime Desired seconds between blocks (> 0)
+     */
+    void setRetarget(int interval, int64_t blockTime);
+    
+    /**
+     * @brief Check whether a block height starts a new interval
+     * @param height Height of the block being built
+     * @return true if the target is recomputed at this height
+     */
+    bool isRetargetHeight(size_t height) const;
+    
+    /**
+     * @brief Compute the target for the next interval
+     * 
+     * Scales the previous target by actualTimespan / expected timespan,
+     * with the ratio clamped to [1/MAX_ADJUSTMENT, MAX_ADJUSTMENT] and
+     * the result capped at a one-zero target. Deterministic, so
+     * validators can recompute it from block timestamps.
+     * 
+     * @param previousBits Compact target of the last interval
+     * @param actualTimespan Seconds the last interval took
+     * @return Compact target for the next interval
+     */
+    uint32_t retarget(uint32_t previousBits, int64_t actualTimespan) const;
+    
+    /**
+     * @brief Display mining statistics
+     */
+    void displayStats() const;
+    
+    // Getters
+    int getDifficulty() const { return difficulty; }
+    const Target& getTarget() const { return target; }
+    uint32_t getBits() const { return bits; }
+    int getRetargetInterval() const { return retargetInterval; }
+    int64_t getTargetBlockTime() const { return targetBlockTime; }
+    long long getMiningTime() const { return miningTime; }
+};
+
+} // namespace consensus
+} // namespace blockchain
+
+#endif // PROOF_OF_WORK_H
@@ -0,0 +1,121 @@
+/**
+ * @file target.h
+ * @brief 256-bit Proof of Work target with compact encoding
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef TARGET_H
+#define TARGET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace blockchain {
+namespace consensus {
+
+/**
+ * @class Target
+ * @brief Unsigned 256-bit threshold a block hash must not exceed
+ *
+ * A digest meets the target when, read as a big-endian 256-bit number,
+ * it is less than or equal to the target. The value is kept as eight
+ * 32-bit words, most significant first, so the check loads one digest
+ * word at a time and almost always decides on the first one.
+ *
+ * Blocks carry the target in the 32-bit compact form used by Bitcoin's
+ * nBits: the top byte is the length of the value in bytes and the low
+ * 23 bits are its leading mantissa. Encoding keeps only those 23 bits
+ * and rounds the value down.
+ */
+class Target {
+private:
+    uint32_t words[8] = {};  ///< Value, most significant word first
+
+public:
+    static constexpr int MAX_DIFFICULTY = 64;  ///< Hex digits in a digest
+
+    Target() = default;
+
+    /**
+     * @brief Target equivalent to a number of leading hex zeros
+     *
+     * The result is 2^(256 - 4 * zeros) - 1, so a digest meets it exactly
+     * when its hex form starts with that many '0' characters.
+     *
+     * @param zeros Leading zero hex digits (0-64)
+     * @return Matching target
+     */
+    static Target fromDifficulty(int zeros);
+
+    /**
+     * @brief Decode a compact target
+     * @param bits Compact encoding
+     * @param out Decoded target
+     * @return false if bits is negative or overflows 256 bits
+     */
+    static bool fromCompact(uint32_t bits, Target& out);
+
+    /**
+     * @brief Decode a compact target
+     * @param bits Compact encoding
+     * @return Decoded target
+     * @throws std::invalid_argument if bits is negative or overflows
+     */
+    static Target fromCompact(uint32_t bits);
+
+    /**
+     * @brief Compact encoding (rounds the value down to 23 mantissa bits)
+     * @return Compact bits
+     */
+    uint32_t toCompact() const;
+
+    /**
+     * @brief Check a digest against the target
+     * @param digest 32-byte big-endian digest
+     * @return true if digest <= target
+     */
+    bool isMetBy(const uint8_t* digest) const;
+
+    /**
+     * @brief Multiply the target by numerator / denominator
+     *
+     * Rounds down and saturates at 2^256 - 1.
+     *
+     * @param numerator Scale numerator
+     * @param denominator Scale denominator (non-zero)
+     * @return Scaled target
+     */
+    Target scaled(uint32_t numerator, uint32_t denominator) const;
+
+    /**
+     * @brief Number of leading zero hex digits of the value
+     * @return 0-64
+     */
+    int leadingZeroHexDigits() const;
+
+    /**
+     * @brief Expected hashes needed to meet the target
+     * @return 2^256 / (target + 1), approximated as a double
+     */
+    double expectedHashes() const;
+
+    /**
+     * @brief Hex representation (64 characters)
+     * @return Lowercase hex string
+     */
+    std::string toHex() const;
+
+    bool isZero() const;
+
+    bool operator==(const Target& other) const;
+    bool operator!=(const Target& other) const { return !(*this == other); }
+    bool operator<(const Target& other) const;
+    bool operator>(const Target& other) const { return other < *this; }
+};
+
+} // namespace consensus
+} // namespace blockchain
+
+#endif // TARGET_H
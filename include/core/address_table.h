@@ -0,0 +1,91 @@
+/**
+ * @file address_table.h
+ * @brief Process-wide interning of address strings
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef ADDRESS_TABLE_H
+#define ADDRESS_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace blockchain {
+
+/// Compact handle for an interned address
+using AddressId = uint32_t;
+
+/**
+ * @class AddressTable
+ * @brief Maps each distinct address to a 32-bit ID, and back
+ *
+ * Entries are never removed, so an ID stays valid (and resolve()'s
+ * reference stays stable) for the life of the process. Strings live in
+ * fixed-size chunks that are never moved: resolve() reads them without
+ * locking, and intern() only takes the write lock for an address it has
+ * not seen. Equal addresses always get equal IDs, so comparing two
+ * addresses is an integer compare.
+ */
+class AddressTable {
+public:
+    static constexpr AddressId EMPTY = 0;  ///< ID of the empty address
+
+    /**
+     * @brief The table shared by the whole process
+     */
+    static AddressTable& instance();
+
+    /**
+     * @brief Get the ID of an address, adding it if new
+     * @param address Address string
+     * @return Its ID
+     * @throws std::length_error if every 32-bit ID is taken
+     */
+    AddressId intern(std::string_view address);
+
+    /**
+     * @brief Look up an address without adding it
+     * @param address Address string
+     * @param id Output: its ID
+     * @return false if the address was never interned
+     */
+    bool find(std::string_view address, AddressId& id) const;
+
+    /**
+     * @brief Get the address behind an ID
+     * @param id ID returned by intern()
+     * @return The address (valid for the life of the process)
+     */
+    const std::string& resolve(AddressId id) const;
+
+    /**
+     * @brief Number of interned addresses
+     */
+    size_t size() const { return count.load(std::memory_order_acquire); }
+
+    AddressTable(const AddressTable&) = delete;
+    AddressTable& operator=(const AddressTable&) = delete;
+
+private:
+    static constexpr size_t CHUNK_BITS = 16;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;   ///< Addresses per chunk
+    static constexpr size_t MAX_CHUNKS = size_t(1) << (32 - CHUNK_BITS);
+
+    std::atomic<std::string*> chunks[MAX_CHUNKS];        ///< Address storage, allocated on demand
+    std::atomic<size_t> count;                           ///< Addresses stored
+    mutable std::shared_mutex mutex;                     ///< Guards ids and appends
+    std::unordered_map<std::string_view, AddressId> ids; ///< Keys view into chunks
+
+    AddressTable();
+    ~AddressTable();
+};
+
+} // namespace blockchain
+
+#endif // ADDRESS_TABLE_H
@@ -0,0 +1,42 @@
+/**
+ * @file amount.h
+ * @brief Fixed-point currency amounts
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef AMOUNT_H
+#define AMOUNT_H
+
+#include <cstdint>
+#include <string>
+
+namespace blockchain {
+
+/// Amount in base units (1 coin = COIN units)
+using Amount = int64_t;
+
+/// Base units per coin (8 decimal places)
+constexpr Amount COIN = 100000000;
+
+/// Largest amount a single transaction may carry (21 million coins)
+constexpr Amount MAX_MONEY = 21000000 * COIN;
+
+/**
+ * @brief Convert a coin value to base units, rounding to the nearest unit
+ * @param coins Value in coins
+ * @param out Output: value in base units
+ * @return false if coins is not finite or exceeds MAX_MONEY in magnitude
+ */
+bool toAmount(double coins, Amount& out);
+
+/**
+ * @brief Format base units as a decimal coin value
+ * @param amount Value in base units
+ * @return e.g. "10.50000000" (always 8 decimals, exact)
+ */
+std::string formatAmount(Amount amount);
+
+} // namespace blockchain
+
+#endif // AMOUNT_H
@@ -9,9 +9,14 @@
 #define BLOCK_H
 
 #include "core/transaction.h"
+#include "core/transaction_validator.h"
 #include "core/merkle_tree.h"
+#include "core/block_header.h"
+#include "consensus/proof_of_work.h"
+#include <atomic>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <ctime>
 
 namespace blockchain {
@@ -30,35 +35,52 @@ enum class ConsensusType {
  * @class Block
  * @brief Represents a block in the blockchain
  * 
- * A block contains:
- * - Index (position in chain)
- * - Timestamp
- * - Previous block hash
- * - Merkle root of transactions
- * - Nonce (for PoW)
- * - Current block hash
- * - List of transactions
- * - Consensus information
+ * A block is a fixed-size BlockHeader plus a body:
+ * - Header: index, timestamp, previous block hash, Merkle root of
+ *   transactions, validator commitment and nonce (for PoW)
+ * - Body: list of transactions
+ * - Cached header hash and consensus information
+ * 
+ * Only the header is hashed, through its canonical binary encoding.
+ * 
+ * The whole block is stored and sent in this layout (little-endian),
+ * which BlockView reads in place:
+ * 
+ * | Offset  | Size | Field                                   |
+ * |---------|------|-----------------------------------------|
+ * | 0       | 116  | header (BlockHeader::encode)            |
+ * | 116     | 1    | consensus type                          |
+ * | 117     | 2    | validator length                        |
+ * | 119     | n    | validator                               |
+ * | 119 + n | 4    | transaction count                       |
+ * | 123 + n | ...  | transactions (Transaction::encode each) |
  */
 class Block {
 private:
-    int index;                              ///< Block index in chain
-    time_t timestamp;                       ///< Block creation time
-    std::string previousHash;               ///< Hash of previous block
-    std::string merkleRoot;                 ///< Merkle root of transactions
-    int nonce;                              ///< Nonce for PoW
-    std::string hash;                       ///< Current block hash
+    BlockHeader header;                     ///< Hashed header fields
+    crypto::Hash256 hash;                   ///< Current block hash
     std::vector<Transaction> transactions;  ///< Transactions in block
     ConsensusType consensusType;            ///< Consensus mechanism used
-    std::string validator;                  ///< Validator name (for PoS)
+    AddressId validator;                    ///< Validator name (for PoS, interned)
     
     /**
      * @brief Calculate hash of block
-     * @return SHA-256 hash of block data
+     * @return Chain hash of the encoded header
+     */
+    crypto::Hash256 calculateHash() const;
+    
+    /**
+     * @brief Construct from decoded fields (BlockView)
      */
-    std::string calculateHash() const;
+    Block(const BlockHeader& header, std::vector<Transaction> transactions,
+          ConsensusType consensusType, std::string_view validatorName);
+    
+    friend class BlockView;
 
 public:
+    static constexpr size_t MIN_ENCODED_SIZE = BlockHeader::SIZE + 7;   ///< No validator, no transactions
+    static constexpr size_t MAX_VALIDATOR_LENGTH = 0xFFFF;              ///< Bytes per validator name
+
     /**
      * @brief Construct a new Block
      * @param index Block index
@@ -66,16 +88,84 @@ public:
      * @param transactions Vector of transactions
      */
     Block(int index, 
-          const std::string& previousHash, 
+          const crypto::Hash256& previousHash, 
           const std::vector<Transaction>& transactions);
     
+    /**
+     * @brief Construct a Block whose Merkle tree is already built
+     * 
+     * Lets block assembly keep a MerkleTree current with append() as
+     * transactions arrive instead of rebuilding it for every template.
+     * 
+     * @param index Block index
+     * @param previousHash Hash of previous block
+     * @param transactions Vector of transactions
+     * @param merkleTree Tree over exactly these transactions, in order
+     */
+    Block(int index, 
+          const crypto::Hash256& previousHash, 
+          const std::vector<Transaction>& transactions,
+          const MerkleTree& merkleTree);
+    
     /**
      * @brief Mine block using Proof of Work
+     * 
+     * Sets the header target to the one equivalent to difficulty, then
+     * mines it. The first 112 header bytes are hashed once; every nonce
+     * attempt only compresses the final block that contains the nonce.
+     * 
      * @param difficulty Number of leading zeros required
      * @return Mining time in milliseconds
      */
     long long mineBlock(int difficulty);
     
+    /**
+     * @brief Mine block against the target already in its header
+     * 
+     * Searches from the header's nonce to 2^32 - 1; if none of them
+     * works, rolls the timestamp and starts again from nonce 0.
+     * 
+     * @param threads Worker threads (0 = hardware concurrency)
+     * @param cancel Optional flag that aborts the search (e.g. new tip)
+     * @return Search result; not found if cancelled or bits is invalid
+     */
+    consensus::MiningResult mine(unsigned threads = 0, const std::atomic<bool>* cancel = nullptr);
+    
+    /**
+     * @brief Mine block using Proof of Work on several threads
+     * 
+     * The nonce space is split across the workers; all of them stop as
+     * soon as one finds a valid hash or cancel is set. The resulting
+     * block passes isValid() exactly like one mined by mineBlock().
+     * 
+     * @param difficulty Number of leading zeros required
+     * @param threads Worker threads (0 = hardware concurrency)
+     * @param cancel Optional flag that aborts the search (e.g. new tip)
+     * @return Search result with aggregate hash rate; the block is left
+     *         unchanged if the search was cancelled
+     */
+    consensus::MiningResult mineBlockParallel(int difficulty, unsigned threads = 0,
+                                              const std::atomic<bool>* cancel = nullptr);
+    
+    /**
+     * @brief Move the header timestamp one second forward
+     * 
+     * Opens a fresh nonce space once every nonce of the current header
+     * has been tried. Resets the nonce to 0; the hash is recomputed by
+     * mine() or setProofOfWork().
+     */
+    void rollTimestamp();
+    
+    /**
+     * @brief Record a nonce found outside this object (e.g. by a remote miner)
+     * 
+     * Marks the block as Proof of Work and recomputes its hash; whether
+     * the nonce meets the target is left to isValid().
+     * 
+     * @param nonce Nonce to put in the header
+     */
+    void setProofOfWork(uint32_t nonce);
+    
     /**
      * @brief Validate block using Proof of Stake
      * @param validatorName Name of validator
@@ -90,20 +180,75 @@ public:
     
     /**
      * @brief Check if block is valid
-     * @param difficulty PoW difficulty (if applicable)
+     * 
+     * PoW blocks must always meet the target in their own header, and
+     * the header's Merkle root must match the transactions. Transactions,
+     * including any signatures, are checked by a TransactionValidator
+     * across worker threads.
+     * 
+     * @param difficulty Additional leading-zero requirement for PoW (0 = none)
+     * @param validator Validator whose cache skips transactions checked
+     *        before (nullptr = uncached)
+     * @param parallel false to check the transactions on the calling
+     *        thread only (the caller is one of several workers)
      * @return true if block is valid
      */
-    bool isValid(int difficulty = 0) const;
+    bool isValid(int difficulty = 0, TransactionValidator* validator = nullptr, bool parallel = true) const;
+    
+    /**
+     * @brief Build the Merkle inclusion proof for one of the transactions
+     * 
+     * Rebuilds the tree from the body, so this is for the full node that
+     * serves proofs; light clients only need verifyTransactionProof().
+     * 
+     * @param transactionHash Hash of the transaction (Transaction::getHash)
+     * @param proof Output: path to getMerkleRoot()
+     * @return false if the transaction is not in this block
+     */
+    bool getTransactionProof(const crypto::Hash256& transactionHash, MerkleProof& proof) const;
+    
+    /**
+     * @brief Check that a transaction is committed to by a Merkle root
+     * @param transactionHash Hash of the transaction
+     * @param proof Path from getTransactionProof()
+     * @param merkleRoot Root from the block header
+     * @return true if the proof is valid
+     */
+    static bool verifyTransactionProof(const crypto::Hash256& transactionHash, const MerkleProof& proof,
+                                       const crypto::Hash256& merkleRoot);
+    
+    /**
+     * @brief Size of the binary encoding
+     * @return Bytes written by encode()
+     */
+    size_t encodedSize() const;
+    
+    /**
+     * @brief Write the binary encoding
+     * @param out Buffer of at least encodedSize() bytes
+     * @throws std::invalid_argument if the validator name is longer than
+     *         MAX_VALIDATOR_LENGTH bytes
+     */
+    void encode(uint8_t* out) const;
+    
+    /**
+     * @brief Set the compact PoW target (before mining or validating)
+     * @param bits Compact target
+     */
+    void setBits(uint32_t bits) { header.bits = bits; }
     
     // Getters
-    int getIndex() const { return index; }
-    std::string getHash() const { return hash; }
-    std::string getPreviousHash() const { return previousHash; }
-    std::string getMerkleRoot() const { return merkleRoot; }
-    int getNonce() const { return nonce; }
-    time_t getTimestamp() const { return timestamp; }
+    const BlockHeader& getHeader() const { return header; }
+    int getIndex() const { return static_cast<int>(header.index); }
+    const crypto::Hash256& getHash() const { return hash; }
+    const crypto::Hash256& getPreviousHash() const { return header.previousHash; }
+    const crypto::Hash256& getMerkleRoot() const { return header.merkleRoot; }
+    uint32_t getNonce() const { return header.nonce; }
+    uint32_t getBits() const { return header.bits; }
+    time_t getTimestamp() const { return static_cast<time_t>(header.timestamp); }
     ConsensusType getConsensusType() const { return consensusType; }
-    std::string getValidator() const { return validator; }
+    const std::string& getValidator() const { return AddressTable::instance().resolve(validator); }
+    AddressId getValidatorId() const { return validator; }
     const std::vector<Transaction>& getTransactions() const { return transactions; }
 };
 
@@ -0,0 +1,85 @@
+/**
+ * @file block_header.h
+ * @brief Fixed-layout block header with canonical binary encoding
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef BLOCK_HEADER_H
+#define BLOCK_HEADER_H
+
+#include "crypto/hash256.h"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace blockchain {
+
+/**
+ * @struct BlockHeader
+ * @brief The hashed part of a block
+ * 
+ * The header is a plain value with no heap members, so mining and
+ * validation loops work on a single small object. Its canonical 116-byte
+ * encoding is the fields in declaration order, integers little-endian:
+ * 
+ * | Offset | Size | Field        |
+ * |--------|------|--------------|
+ * | 0      | 32   | previousHash |
+ * | 32     | 32   | merkleRoot   |
+ * | 64     | 32   | validator    |
+ * | 96     | 8    | timestamp    |
+ * | 104    | 4    | index        |
+ * | 108    | 4    | bits         |
+ * | 112    | 4    | nonce        |
+ * 
+ * The nonce is last so it always lands in the final compression block; the
+ * first 112 bytes can be hashed once and reused for every attempt. The
+ * encoding must stay under 120 bytes so the padded tail fits one block.
+ */
+struct BlockHeader {
+    static constexpr size_t SIZE = 116;          ///< Encoded size in bytes
+    static constexpr size_t NONCE_OFFSET = 112;  ///< Offset of the nonce
+    
+    crypto::Hash256 previousHash;  ///< Hash of previous block
+    crypto::Hash256 merkleRoot;    ///< Merkle root of transactions
+    crypto::Hash256 validator;     ///< Hash of the validator name (zero if none)
+    int64_t timestamp = 0;         ///< Block creation time (seconds since epoch)
+    uint32_t index = 0;            ///< Block index in chain
+    uint32_t bits = 0;             ///< Compact PoW target (consensus::Target)
+    uint32_t nonce = 0;            ///< Nonce for PoW
+    
+    /**
+     * @brief Write the canonical encoding
+     * @param out Buffer of SIZE bytes
+     */
+    void encode(uint8_t* out) const;
+    
+    /**
+     * @brief Read a header from its canonical encoding
+     * @param in Buffer of SIZE bytes
+     * @return Decoded header
+     */
+    static BlockHeader decode(const uint8_t* in);
+    
+    /**
+     * @brief Chain hash (crypto::ChainHasher) of the canonical encoding
+     * @return Header digest (the block hash)
+     */
+    crypto::Hash256 hash() const;
+    
+    /**
+     * @brief Validator commitment stored in the header
+     * @param name Validator name
+     * @return Chain hash of the name, or all zeros for an empty name
+     */
+    static crypto::Hash256 validatorDigest(const std::string& name);
+};
+
+static_assert(BlockHeader::SIZE < 120, "Nonce tail must fit one compression block");
+static_assert(std::is_trivially_copyable<BlockHeader>::value, "BlockHeader must be trivially copyable");
+
+} // namespace blockchain
+
+#endif // BLOCK_HEADER_H
@@ -0,0 +1,79 @@
+/**
+ * @file block_view.h
+ * @brief Zero-copy reader for encoded blocks
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef BLOCK_VIEW_H
+#define BLOCK_VIEW_H
+
+#include "core/block.h"
+#include "core/transaction_view.h"
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+
+/**
+ * @class BlockView
+ * @brief Reads the fields of an encoded block in place
+ *
+ * Like TransactionView, a view only points into the caller's buffer
+ * (e.g. a memory-mapped block file), which must outlive it. Parsing
+ * checks that every transaction encoding is in bounds but allocates
+ * nothing; toBlock() materialises a heap Block only when one is needed.
+ */
+class BlockView {
+private:
+    const uint8_t* data = nullptr;  ///< Start of the encoding
+    size_t size = 0;                ///< Length of the encoding
+    size_t validatorLength = 0;     ///< Bytes of validator name
+    uint32_t transactionCount = 0;  ///< Encoded transactions
+
+    size_t transactionsOffset() const { return Block::MIN_ENCODED_SIZE + validatorLength; }
+
+public:
+    BlockView() = default;
+
+    /**
+     * @brief Parse one encoded block at the start of a buffer
+     * @param buffer Encoded bytes
+     * @param length Bytes available in buffer
+     * @param view Output: view of the block
+     * @return false if the bytes are truncated or malformed
+     */
+    static bool parse(const uint8_t* buffer, size_t length, BlockView& view);
+
+    /**
+     * @brief Chain hash of the encoded header
+     * @return Same value as Block::getHash() of the decoded block
+     */
+    crypto::Hash256 computeHash() const;
+
+    /**
+     * @brief View every transaction in order
+     * @param views Output: one view per transaction (replaced)
+     */
+    void getTransactions(std::vector<TransactionView>& views) const;
+
+    /**
+     * @brief Materialise the block
+     * @return Block with the same fields and hash
+     */
+    Block toBlock() const;
+
+    // Getters
+    const uint8_t* getData() const { return data; }
+    size_t getEncodedSize() const { return size; }
+    BlockHeader getHeader() const { return BlockHeader::decode(data); }
+    ConsensusType getConsensusType() const { return static_cast<ConsensusType>(data[BlockHeader::SIZE]); }
+    std::string_view getValidator() const;
+    uint32_t getTransactionCount() const { return transactionCount; }
+};
+
+} // namespace blockchain
+
+#endif // BLOCK_VIEW_H
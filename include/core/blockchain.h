@@ -0,0 +1,541 @@
+/**
+ * @file blockchain.h
+ * @brief Blockchain management
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef BLOCKCHAIN_H
+#define BLOCKCHAIN_H
+
+#include "core/block.h"
+#include "core/block_view.h"
+#include "core/transaction.h"
+#include "core/replay_filter.h"
+#include "consensus/proof_of_work.h"
+#include "consensus/proof_of_stake.h"
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+
+namespace blockchain {
+
+class Mempool;
+
+namespace storage {
+class BlockStore;
+class Journal;
+struct SnapshotHeader;
+}
+
+/**
+ * @struct Checkpoint
+ * @brief A block trusted to be valid together with everything below it
+ */
+struct Checkpoint {
+    size_t height;          ///< Block height
+    crypto::Hash256 hash;   ///< Expected block hash at that height
+};
+
+#ifdef BLOCKCHAIN_STORAGE
+/**
+ * @struct RecoveryStats
+ * @brief Records applied by Blockchain::recover()
+ */
+struct RecoveryStats {
+    size_t blocks = 0;          ///< Block records, including ones the store already held
+    size_t transactions = 0;    ///< Pending transaction records
+};
+#endif
+
+/**
+ * @class Blockchain
+ * @brief Manages the chain of blocks
+ * 
+ * Responsibilities:
+ * - Create the genesis block
+ * - Append blocks using Proof of Work or Proof of Stake
+ * - Retarget PoW every interval from block timestamps
+ * - Validate transactions in parallel, batch-verifying signatures
+ * - Reject blocks that repeat a confirmed transaction
+ * - Persist blocks to a BlockStore, keeping only recent ones in memory
+ * - Log accepted blocks to a write-ahead Journal before applying them
+ * - Save and resume from chain snapshots
+ *   (the last three need POSIX file I/O and are only built with
+ *   BLOCKCHAIN_STORAGE, which CMake defines on Unix)
+ * - Validate chain integrity across threads, trusting history below
+ *   assume-valid checkpoints
+ * - Report chain statistics
+ */
+class Blockchain {
+private:
+    std::deque<Block> chain;           ///< Resident blocks, oldest first
+    size_t chainBase = 0;              ///< Height of chain.front()
+    consensus::ProofOfWork pow;        ///< PoW engine (current target)
+    consensus::ProofOfStake pos;       ///< PoS engine
+    bool requireSignatures = false;    ///< Reject unsigned transactions
+    unsigned miningThreads = 0;        ///< Nonce search threads for addBlockPoW (0 = hardware)
+    mutable TransactionValidator transactionValidator;  ///< Parallel checks, caches passed transactions
+    ReplayFilter replayFilter;         ///< IDs of confirmed transactions
+#ifdef BLOCKCHAIN_STORAGE
+    std::unique_ptr<storage::BlockStore> store;  ///< Persisted blocks (null if none)
+    size_t residentBlocks = 0;         ///< Blocks kept in memory with a store
+    storage::Journal* journal = nullptr;  ///< Write-ahead log (not owned, may be null)
+#endif
+    std::vector<storage::SnapshotHeader> archivedHeaders;  ///< Headers of blocks below chainBase without a store
+    size_t archivedTransactionsBase = 0;  ///< Height of archivedTransactions.front()
+    std::vector<std::vector<crypto::Hash256>> archivedTransactions;  ///< IDs of archived blocks the replay filter covers
+    std::vector<Checkpoint> checkpoints;  ///< Assume-valid blocks, by increasing height
+    bool fullValidation = false;       ///< Ignore checkpoints in isChainValid()
+    
+    /**
+     * @brief Create the first block of the chain
+     * @return Genesis block
+     */
+    Block createGenesisBlock();
+    
+    /**
+     * @brief Recompute the retargeted bits for a block height
+     * 
+     * Uses the bits of the block before height and the time between the
+     * first and last block of the interval that just ended.
+     * 
+     * @param height Retarget height (pow.isRetargetHeight(height))
+     * @return Compact target expected at height
+     */
+    uint32_t retargetBits(size_t height) const;
+    
+    /**
+     * @brief Compact target a block at a height must carry
+     * 
+     * The retargeted target at retarget heights, otherwise the target of
+     * the block before it.
+     * 
+     * @param height Block height (> 0)
+     * @return Compact target expected at height
+     */
+    uint32_t expectedBits(size_t height) const;
+    
+    /**
+     * @brief Target for the next block, retargeting the engine if due
+     * @return Compact target to put in the new block
+     */
+    uint32_t nextWorkBits();
+    
+    /**
+     * @brief Find a transaction that is already confirmed or listed twice
+     * 
+     * Recent blocks are checked exactly through replayFilter; a filter
+     * match on older history is confirmed by scanning, newest first, only
+     * the blocks below the window whose IDs the filter holds. Blocks known
+     * by their header only are scanned through archivedTransactions.
+     * 
+     * @param transactions Transactions of a candidate block
+     * @return Index of the first replayed transaction, or transactions.size()
+     */
+    size_t findReplay(const std::vector<Transaction>& transactions) const;
+    
+    /**
+     * @brief Append a block and record its transactions as confirmed
+     * 
+     * The block is made durable in the journal first (if requested and
+     * one is set), then written to the store; the oldest resident block
+     * is dropped from memory once there are more than residentBlocks.
+     * 
+     * @param block Block that passed validation
+     * @param logged Whether to record it in the journal
+     * @return false if the journal or the store could not write it
+     */
+    bool appendBlock(const Block& block, bool logged = true);
+    
+    /**
+     * @brief Block at a height if it is held in memory
+     * @param height Block height
+     * @return Pointer to block, or nullptr if not resident
+     */
+    const Block* residentBlock(size_t height) const;
+    
+    /**
+     * @brief Load a block from memory or, failing that, from the store
+     * @param height Block height (< getChainLength())
+     * @param loaded Holds the block if it had to be read from the store
+     * @return Pointer to block, or nullptr if the store cannot read it
+     */
+    const Block* loadBlock(size_t height, std::unique_ptr<Block>& loaded) const;
+    
+    /**
+     * @brief Header at a height, from memory, the store or archivedHeaders
+     * @param height Block height (< getChainLength())
+     */
+    BlockHeader headerAt(size_t height) const;
+    
+    /**
+     * @brief Link of a block into the chain, without rehashing it
+     * @param height Block height (< getChainLength())
+     * @param previousHash Output: hash the block names as its parent
+     * @param hash Output: the block's recorded hash
+     * @return false if the block cannot be read
+     */
+    bool linkAt(size_t height, crypto::Hash256& previousHash, crypto::Hash256& hash) const;
+    
+    /**
+     * @brief Why a block failed isChainValid(), in the order checks run
+     */
+    enum class BlockFault {
+        NONE,
+        UNREADABLE,         ///< Block cannot be read
+        PREVIOUS_HASH,      ///< Does not name the previous block's hash
+        INVALID,            ///< Block::isValid() (or the archived header check) failed
+        RETARGET,           ///< Target differs from the schedule (expectedBits)
+        VALIDATOR           ///< PoS block by an unregistered validator
+    };
+    
+    /**
+     * @brief Run every isChainValid() check of one block except its link
+     * 
+     * Safe to call from several threads at once; the transactions are
+     * checked on the calling thread.
+     * 
+     * @param height Block height (>= 1)
+     * @param assumedValid Heights below this only report their link
+     * @param validators Digests of the registered validators' names
+     * @param previousHash Output: hash the block names as its parent
+     * @param hash Output: the block's hash
+     * @return First failed check; previousHash and hash are set unless UNREADABLE
+     */
+    BlockFault checkBlock(size_t height, size_t assumedValid, const std::vector<crypto::Hash256>& validators,
+                          crypto::Hash256& previousHash, crypto::Hash256& hash) const;
+    
+    /**
+     * @brief Height below which isChainValid() only checks linkage
+     * @return Highest checkpoint on the chain, or 0 with fullValidation
+     */
+    size_t assumeValidHeight() const;
+    
+    /**
+     * @brief Check a block known only by its header (loaded from a snapshot)
+     * 
+     * Covers what the header commits to: the PoW target for PoW blocks and
+     * a registered validator for PoS blocks. Transactions are not available.
+     * 
+     * @param entry Archived header
+     * @param validators Digests of the registered validators' names
+     * @return true if the header is valid
+     */
+    static bool isArchivedHeaderValid(const storage::SnapshotHeader& entry,
+                                      const std::vector<crypto::Hash256>& validators);
+
+public:
+    /**
+     * @brief Construct a blockchain with a genesis block
+     * @param difficulty PoW difficulty (number of leading zeros)
+     */
+    explicit Blockchain(int difficulty = 3);
+    
+    ~Blockchain();
+    
+    static constexpr size_t DEFAULT_RESIDENT_BLOCKS = 256;  ///< Blocks kept in memory with a store
+    static constexpr size_t SNAPSHOT_BLOCKS = 256;          ///< Newest blocks saved in full in a snapshot
+    static constexpr size_t VALIDATION_GRAIN = 64;          ///< Heights per isChainValid() work item
+    
+    /**
+     * @brief Register a PoS validator
+     * @param name Validator name
+     * @param stake Amount staked
+     * @return true if validator was added
+     */
+    bool addValidator(const std::string& name, int stake);
+    
+    /**
+     * @brief Add a block mined with Proof of Work
+     * 
+     * The nonce search runs on the threads set by setMiningThreads().
+     * 
+     * @param transactions Transactions to include
+     * @return true if block was added
+     */
+    bool addBlockPoW(const std::vector<Transaction>& transactions);
+    
+    /**
+     * @brief Build an unmined PoW block on top of the current tip
+     * 
+     * The block carries the target due at its height (retargeting the
+     * engine if needed) and can be mined elsewhere, then handed back
+     * through submitBlock().
+     * 
+     * @param transactions Transactions to include
+     * @return Block template with nonce 0
+     */
+    Block createBlockTemplate(const std::vector<Transaction>& transactions);
+    
+    /**
+     * @brief Append a block mined outside the chain
+     * 
+     * The block must extend the current tip, carry the current target,
+     * pass Block::isValid() and carry valid transaction signatures.
+     * 
+     * @param block Mined block
+     * @return true if block was added
+     */
+    bool submitBlock(const Block& block);
+    
+    /**
+     * @brief Add a block validated with Proof of Stake
+     * @param transactions Transactions to include
+     * @return true if block was added
+     */
+    bool addBlockPoS(const std::vector<Transaction>& transactions);
+    
+    /**
+     * @brief Validate the whole chain
+     * 
+     * Every checkpoint on the chain must match the block at its height.
+     * Blocks below the highest such checkpoint only have their linkage
+     * checked; the checkpoint and everything above it are fully validated.
+     * 
+     * Blocks are checked independently on the validation threads in
+     * runs of VALIDATION_GRAIN heights; the links between runs are then
+     * verified in one sequential pass. The error reported is the one a
+     * block-by-block walk would hit first.
+     * 
+     * @return true if every block and link is valid
+     */
+    bool isChainValid() const;
+    
+    /**
+     * @brief Trust a block and its ancestors as valid (assume-valid)
+     * 
+     * Replaces any checkpoint already set at the same height.
+     * 
+     * @param height Block height
+     * @param hash Expected hash of the block at that height
+     */
+    void addCheckpoint(size_t height, const crypto::Hash256& hash);
+    
+    /**
+     * @brief Remove every checkpoint
+     */
+    void clearCheckpoints() { checkpoints.clear(); }
+    
+    /**
+     * @brief Validate every block in isChainValid(), e.g. for an audit
+     * 
+     * Checkpoints are still compared against the chain.
+     * 
+     * @param full true to ignore the assume-valid shortcut
+     */
+    void setFullValidation(bool full) { fullValidation = full; }
+    
+    /**
+     * @brief Get the most recent block
+     * @return Last block in chain
+     */
+    const Block& getLastBlock() const;
+    
+    /**
+     * @brief Get a block held in memory by index
+     * 
+     * Without a store or snapshot every block is resident. Once
+     * attachStore() or loadSnapshot() is used, only the most recent
+     * blocks (at most residentBlocks) are, and this returns nullptr for
+     * every older height even though the block exists. Callers that may
+     * run with a store must fall back to getBlock(int, BlockView&);
+     * blocks restored from a snapshot without a store have no body at all.
+     * 
+     * @param index Block index
+     * @return Pointer to block, or nullptr if out of range or not resident
+     */
+    const Block* getBlock(int index) const;
+    
+    /**
+     * @brief Get any stored block, read in place from the mapped block files
+     * @param index Block index
+     * @param view Output: view valid while the chain is alive
+     * @return false if there is no store or index is out of range
+     */
+    bool getBlock(int index, BlockView& view) const;
+    
+#ifdef BLOCKCHAIN_STORAGE
+    /**
+     * @brief Persist the chain in a BlockStore directory
+     * 
+     * An empty store receives the current chain. A store that already
+     * holds the current chain (e.g. after loadSnapshot()) only adds the
+     * blocks stored beyond its tip, each checked like recoverBlock().
+     * Any other store replaces the chain, but only while it holds just
+     * the genesis block: the newest stored blocks are loaded into memory,
+     * the rest stay on disk, and the whole stored chain must pass
+     * isChainValid(). Validators are not stored, so register them (or
+     * load a snapshot) first. Afterwards every appended block is written
+     * to the store and at most residentBlocks stay in memory.
+     * 
+     * @param directory Store directory (created if missing)
+     * @param residentBlocks Blocks kept in memory (at least 1)
+     * @param segmentSize Bytes per segment file for new blocks
+     *        (0 = BlockStore::DEFAULT_SEGMENT_SIZE)
+     * @return false if a store is already attached or cannot be opened,
+     *         if an empty store is given a chain restored without bodies,
+     *         if a different store would replace more than genesis, or if
+     *         a stored block fails validation
+     */
+    bool attachStore(const std::string& directory, size_t residentBlocks = DEFAULT_RESIDENT_BLOCKS,
+                     uint64_t segmentSize = 0);
+    
+    /**
+     * @brief Save the chain state to a snapshot file
+     * 
+     * Captures the header of every block, the newest SNAPSHOT_BLOCKS
+     * blocks in full, the validators, the PoW settings, the replay
+     * filter and the transaction IDs of the older blocks it covers (see
+     * storage::ChainSnapshot). Blocks that are only on disk are read from
+     * the store.
+     * 
+     * @param path Snapshot file (replaced atomically)
+     * @return false on an I/O error
+     */
+    bool saveSnapshot(const std::string& path) const;
+    
+    /**
+     * @brief Replace the chain state with a saved snapshot
+     * 
+     * Nothing is re-added or re-mined: the tail blocks, validators, PoW
+     * settings and replay filter are restored as saved, so the cost is
+     * proportional to the snapshot size. Blocks older than the saved tail
+     * are known by their headers only; isChainValid() checks their
+     * linkage, PoW targets and validators. For those the replay filter
+     * covers, the saved transaction IDs confirm filter matches exactly.
+     * Attach the store afterwards to bring their bodies back and catch up
+     * on blocks stored after the snapshot was taken.
+     * 
+     * @param path Snapshot file
+     * @return false if the file cannot be read or a store is attached;
+     *         the chain is unchanged then
+     */
+    bool loadSnapshot(const std::string& path);
+    
+    /**
+     * @brief Log every accepted block to a write-ahead journal
+     * 
+     * A block is only appended once its journal record is durable.
+     * Concurrent writers (e.g. a Mempool on the same journal) share each
+     * fsync through group commit. Recover with recover() before setting
+     * the journal, so replayed blocks are not logged twice, and bound its
+     * size with checkpoint().
+     * 
+     * @param journal Open journal that outlives the chain (nullptr to stop logging)
+     */
+    void setJournal(storage::Journal* journal) { this->journal = journal; }
+#endif
+    
+    /**
+     * @brief Re-apply a block replayed from a journal
+     * 
+     * A block the chain already holds is skipped. Otherwise it must extend
+     * the tip and pass the checks isChainValid() applies to it (including
+     * the validator for PoS blocks); it is appended without being logged.
+     * 
+     * @param block Block from a journal record
+     * @return false if the block neither is on the chain nor extends it
+     */
+    bool recoverBlock(const Block& block);
+    
+#ifdef BLOCKCHAIN_STORAGE
+    /**
+     * @brief Rebuild the chain and pool from a journal after a crash
+     * 
+     * Replays the records in order: blocks go through recoverBlock() and
+     * their transactions leave pool; pending transactions are submitted
+     * to pool again with their fee. Call it after attachStore() and before
+     * the chain or pool is given the journal.
+     * 
+     * @param journal Open journal
+     * @param pool Mempool to refill (nullptr to skip transaction records)
+     * @param stats Optional output: records applied
+     * @return false if a record is malformed or a block does not fit the chain
+     */
+    bool recover(const storage::Journal& journal, Mempool* pool = nullptr, RecoveryStats* stats = nullptr);
+    
+    /**
+     * @brief Persist the chain and drop the journal records it no longer needs
+     * 
+     * Syncs the store, so every accepted block is durable without its
+     * journal record, then compacts the journal down to the transactions
+     * still pending in pool and whatever was logged meanwhile. Call it
+     * from the thread that adds blocks, between blocks.
+     * 
+     * @param pool Mempool sharing the journal (nullptr if nothing else logs to it)
+     * @return false without a store or journal, or on an I/O error
+     */
+    bool checkpoint(Mempool* pool = nullptr);
+#endif
+    
+    /**
+     * @brief Set the PoW difficulty the chain starts from
+     * 
+     * Every block must carry its predecessor's target except at retarget
+     * heights, so the difficulty is fixed by the genesis block. It can
+     * only be changed while the chain holds nothing else; later targets
+     * follow the retarget schedule (setRetarget).
+     * 
+     * @param difficulty New difficulty in leading hex zeros (1-64)
+     * @return false if blocks were already added or a store is attached
+     */
+    bool setDifficulty(int difficulty);
+    
+    /**
+     * @brief Configure automatic PoW retargeting
+     * @param interval Blocks between adjustments (0 disables retargeting)
+     * @param blockTime Desired seconds between blocks
+     */
+    void setRetarget(int interval, int64_t blockTime);
+    
+    /**
+     * @brief Require every transaction in a new block to be signed
+     * 
+     * Signed transactions are always verified; when off (the default),
+     * unsigned ones are accepted too.
+     * 
+     * @param required true to reject unsigned transactions
+     */
+    void setRequireSignatures(bool required) { requireSignatures = required; }
+    
+    /**
+     * @brief Set the threads used to validate transactions and the chain
+     * @param threads Worker threads (0 = hardware concurrency)
+     */
+    void setValidationThreads(unsigned threads) { transactionValidator.setThreads(threads); }
+    
+    /**
+     * @brief Set the threads addBlockPoW() uses to search for a nonce
+     * @param threads Worker threads (0 = hardware concurrency)
+     */
+    void setMiningThreads(unsigned threads) { miningThreads = threads; }
+    
+    /**
+     * @brief Display every block
+     */
+    void displayChain() const;
+    
+    /**
+     * @brief Display chain statistics
+     */
+    void displayStats() const;
+    
+    // Getters
+    size_t getChainLength() const { return chainBase + chain.size(); }
+    int getDifficulty() const { return pow.getDifficulty(); }
+    bool getRequireSignatures() const { return requireSignatures; }
+    unsigned getMiningThreads() const { return miningThreads; }
+    bool getFullValidation() const { return fullValidation; }
+    const std::vector<Checkpoint>& getCheckpoints() const { return checkpoints; }
+    const consensus::ProofOfWork& getPoW() const { return pow; }
+    const consensus::ProofOfStake& getPoS() const { return pos; }
+#ifdef BLOCKCHAIN_STORAGE
+    const storage::BlockStore* getStore() const { return store.get(); }
+#endif
+};
+
+} // namespace blockchain
+
+#endif // BLOCKCHAIN_H
@@ -0,0 +1,237 @@
+/**
+ * @file mempool.h
+ * @brief Concurrent fee-prioritised pool of pending transactions
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include "core/transaction.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+
+namespace storage {
+class Journal;
+}
+
+/**
+ * @enum SubmitStatus
+ * @brief Outcome of Mempool::submit()
+ */
+enum class SubmitStatus {
+    ACCEPTED,       ///< Added to the pool
+    DUPLICATE,      ///< Same transaction ID already pending
+    INVALID,        ///< Fails Transaction::isValid() or has a negative fee
+    POOL_FULL,      ///< No room and the fee does not beat the cheapest entry (back off)
+    NOT_DURABLE     ///< The journal could not record it (not added)
+};
+
+/**
+ * @class Mempool
+ * @brief Pending transactions ordered by fee, safe for many producers
+ *
+ * The pool is split into SHARDS partitions by transaction ID, each with
+ * its own lock, so concurrent submitters rarely touch the same mutex.
+ * Within a shard entries are ordered by fee (highest first), then by
+ * arrival, and indexed by ID for duplicate checks and removal.
+ *
+ * The transaction and byte limits apply to the pool as a whole. A
+ * submission reserves its slot and bytes on the shared atomic totals and
+ * rolls the reservation back if that overshoots either limit. It then
+ * locks every shard and evicts the cheapest entries pool-wide if it pays
+ * more than they do. Otherwise it is refused with POOL_FULL so the
+ * producer can back off, or block in waitForSpace().
+ *
+ * takeBest() hands the block builder the highest-fee transactions across
+ * all shards in one call. The fee is a priority carried by the pool entry;
+ * the chain itself does not transfer it.
+ *
+ * With a journal, a transaction is queued for logging under the shard
+ * lock, only once it is admitted, so duplicates and refused submissions
+ * never reach the log. submit() then waits for the fsync with no lock
+ * held and returns ACCEPTED once the record is durable; if the journal
+ * fails the entry is withdrawn and NOT_DURABLE returned. Many submitters
+ * share each fsync through group commit.
+ */
+class Mempool {
+public:
+    static constexpr size_t SHARDS = 16;                            ///< Independently locked partitions
+    static constexpr size_t DEFAULT_MAX_TRANSACTIONS = 1 << 20;     ///< Default count limit
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(256) << 20;  ///< Default encoded-size limit
+
+    /**
+     * @brief Construct an empty pool
+     * @param maxTransactions Pending transaction limit
+     * @param maxBytes Limit on the sum of Transaction::encodedSize()
+     */
+    explicit Mempool(size_t maxTransactions = DEFAULT_MAX_TRANSACTIONS,
+                     size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * @brief Add a pending transaction
+     * @param tx Transaction to add
+     * @param fee Priority; higher fees are taken first
+     * @return ACCEPTED, or why the transaction was not added
+     */
+    SubmitStatus submit(const Transaction& tx, Amount fee);
+
+    /**
+     * @brief Remove and return the highest-fee transactions
+     * @param limit Maximum number to take
+     * @param totalFee Optional output: sum of their fees
+     * @return Up to limit transactions, highest fee first
+     */
+    std::vector<Transaction> takeBest(size_t limit, Amount* totalFee = nullptr);
+
+    /**
+     * @brief Drop transactions that were confirmed elsewhere
+     * @param transactions Transactions to remove (unknown IDs are ignored)
+     * @return Number removed
+     */
+    size_t remove(const std::vector<Transaction>& transactions);
+
+    /**
+     * @brief Check whether a transaction is pending
+     * @param id Transaction digest
+     */
+    bool contains(const crypto::Hash256& id) const;
+
+    /**
+     * @brief Copy every pending transaction with its fee
+     *
+     * Shards are visited one at a time, so entries submitted or taken
+     * meanwhile may or may not appear.
+     *
+     * @return Pending transactions and fees, in no particular order
+     */
+    std::vector<std::pair<Transaction, Amount>> getPending() const;
+
+    /**
+     * @brief Wait until transactions leave the pool
+     *
+     * Returns once any entry is taken or removed after the call; a
+     * producer that got POOL_FULL can then retry.
+     *
+     * @param timeout Longest time to wait
+     * @return false if nothing left the pool within timeout
+     */
+    bool waitForSpace(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Forget every pending transaction
+     */
+    void clear();
+
+#ifdef BLOCKCHAIN_STORAGE
+    /**
+     * @brief Log accepted transactions to a write-ahead journal
+     *
+     * Replay the journal into the pool before setting it, so recovered
+     * transactions are not logged twice.
+     *
+     * @param journal Open journal that outlives the pool (nullptr to stop logging)
+     */
+    void setJournal(storage::Journal* journal) { this->journal = journal; }
+#endif
+
+    // Getters
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    size_t getBytes() const { return bytes.load(std::memory_order_relaxed); }
+    size_t getMaxTransactions() const { return maxTransactions; }
+    size_t getMaxBytes() const { return maxBytes; }
+
+    Mempool(const Mempool&) = delete;
+    Mempool& operator=(const Mempool&) = delete;
+
+private:
+    /// Position in a shard: highest fee first, then earliest arrival
+    struct Priority {
+        Amount fee;
+        uint64_t arrival;
+
+        bool operator<(const Priority& other) const {
+            return fee != other.fee ? fee > other.fee : arrival < other.arrival;
+        }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::map<Priority, Transaction> byFee;                  ///< Ordered entries
+        std::unordered_map<crypto::Hash256, Priority> byId;     ///< ID index into byFee
+        size_t bytes = 0;                                       ///< Encoded size held
+    };
+
+    std::array<Shard, SHARDS> shards;
+    size_t maxTransactions;
+    size_t maxBytes;
+    std::atomic<uint64_t> arrivals;     ///< Arrival counter for FIFO among equal fees
+    std::atomic<size_t> count;          ///< Entries across all shards, including reservations
+    std::atomic<size_t> bytes;          ///< Bytes across all shards, including reservations
+
+    std::mutex spaceMutex;                  ///< Guards removals for waitForSpace()
+    std::condition_variable spaceFreed;     ///< Signalled when entries leave
+    uint64_t removals = 0;                  ///< Bumped on every take/remove
+
+    storage::Journal* journal = nullptr;    ///< Write-ahead log (not owned, may be null)
+
+    static size_t shardIndex(const crypto::Hash256& id) { return id.bytes[0] % SHARDS; }
+
+    /**
+     * @brief Admit a transaction that did not fit, evicting cheaper entries
+     *
+     * Holds every shard lock, so the totals are exact while it decides.
+     */
+    SubmitStatus submitEvicting(const Transaction& tx, Amount fee, size_t size,
+                                const std::vector<uint8_t>& record, uint64_t& sequence);
+
+    /**
+     * @brief Queue an admitted transaction's journal record (shard lock held)
+     * @param record Journal::encodeTransaction() payload, unused without a journal
+     * @param sequence Output: value for Journal::waitDurable(), 0 without a journal
+     * @return false if the journal refused the record
+     */
+    bool logLocked(const std::vector<uint8_t>& record, uint64_t& sequence);
+
+    /**
+     * @brief Claim one entry and size bytes on the pool-wide totals
+     * @return false (with nothing claimed) if either limit would be exceeded
+     */
+    bool reserve(size_t size);
+
+    /**
+     * @brief Return a reservation that will not be used
+     */
+    void release(size_t size);
+
+    /**
+     * @brief Add an entry whose reservation is already made to a locked shard
+     */
+    void insertLocked(Shard& shard, const Transaction& tx, Amount fee, size_t size);
+
+    /**
+     * @brief Erase one entry from a locked shard
+     */
+    void eraseLocked(Shard& shard, std::map<Priority, Transaction>::iterator it);
+
+    /**
+     * @brief Wake producers blocked in waitForSpace()
+     */
+    void notifySpace();
+};
+
+} // namespace blockchain
+
+#endif // MEMPOOL_H
@@ -9,18 +9,36 @@
 #define MERKLE_TREE_H
 
 #include "core/transaction.h"
+#include "crypto/hash256.h"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
-#include <string>
 
 namespace blockchain {
 
+/**
+ * @struct MerkleProof
+ * @brief Path from one leaf to the root
+ * 
+ * Bit k of leafIndex tells whether the running hash is the left (0) or
+ * right (1) child at level k, and siblings[k] is the other child. The
+ * leaf count pins down where the padding of odd levels is, so a proof
+ * for a padded duplicate slot cannot pass as a real leaf.
+ */
+struct MerkleProof {
+    uint32_t leafIndex = 0;                 ///< Position of the leaf
+    uint32_t leafCount = 0;                 ///< Leaves in the tree
+    std::vector<crypto::Hash256> siblings;  ///< Sibling at each level, bottom up
+};
+
 /**
  * @class MerkleTree
  * @brief Implements a Merkle Tree for efficient transaction verification
  * 
  * A Merkle Tree is a binary tree where:
  * - Leaf nodes contain hashes of transactions
- * - Internal nodes contain hashes of their children
+ * - Internal nodes contain the hash of their children's 64 concatenated bytes
  * - The root hash represents all transactions
  * 
  * Benefits:
@@ -28,21 +46,76 @@ namespace blockchain {
  * - Tamper detection
  * - Reduced storage requirements for SPV clients
  * 
+ * Every level lives in one contiguous array, leaves first and the root
+ * last. A level with an odd number of nodes gets a copy of its last
+ * node appended, so each pair of neighbours is already the 64-byte
+ * message for its parent and a whole level is hashed in one batch
+ * straight into the next level's slots. Wide levels are split across
+ * worker threads.
+ * 
+ * The tree can also be grown one leaf at a time with append() or edited
+ * with replace(). Both re-hash only the path from the leaf to the root
+ * and give the same root as building the tree from scratch. Each level
+ * keeps spare slots (doubled when full, like std::vector), so appends
+ * are amortised O(log n).
+ * 
+ * Trees built only for their root (block construction and validation)
+ * pay nothing for lookups: the leaf index behind findLeaf() and
+ * verifyTransaction() is built on the first such call.
+ * 
  * @note Uses iterative approach for better performance and stack safety
  */
 class MerkleTree {
 private:
-    std::vector<std::string> leaves;  ///< Transaction hashes (leaf nodes)
-    std::string root;                 ///< Merkle root hash
+    std::vector<crypto::Hash256> nodes;    ///< All levels, leaves first, root last
+    std::vector<size_t> levelOffsets;      ///< Start of each level in nodes
+    size_t leafCount = 0;                  ///< Number of transaction hashes
+    size_t capacity = 0;                   ///< Leaves the layout has room for
+    crypto::Hash256 root;                  ///< Merkle root hash
+    
+    /// First index of each leaf, built by the first lookup (a copy starts without one)
+    struct LeafIndex {
+        std::mutex mutex;
+        bool built = false;
+        std::unordered_map<crypto::Hash256, size_t> positions;
+        
+        LeafIndex() = default;
+        LeafIndex(const LeafIndex&) {}
+        LeafIndex& operator=(const LeafIndex&);
+    };
+    mutable LeafIndex leafLookup;
+    
+    /**
+     * @brief Look up a leaf, indexing all leaves on first use
+     * @return false if the hash is not a leaf
+     */
+    bool lookupLeaf(const crypto::Hash256& transactionHash, size_t& index) const;
+    
+    /**
+     * @brief Size the node array for newCapacity leaves, keeping the
+     *        current levels, and record level offsets
+     */
+    void layoutLevels(size_t newCapacity);
     
     /**
-     * @brief Build tree iteratively from leaf nodes to root
-     * @param nodes Initial leaf nodes
-     * @return Root hash
+     * @brief Hash every level above the leaves, bottom up
+     * 
+     * Expects the leaves in place; pads odd levels and sets root.
      */
-    std::string buildTreeIterative(std::vector<std::string> nodes);
+    void buildLevels();
+    
+    /**
+     * @brief Re-hash the ancestors of one leaf and update the root
+     * @param leafIndex Leaf whose value changed
+     */
+    void updatePath(size_t leafIndex);
 
 public:
+    /**
+     * @brief Construct an empty tree to be filled with append()
+     */
+    MerkleTree() = default;
+    
     /**
      * @brief Construct Merkle Tree from transactions
      * @param transactions Vector of transactions
@@ -53,19 +126,43 @@ public:
      * @brief Construct Merkle Tree from transaction hashes
      * @param transactionHashes Vector of pre-computed hashes
      */
-    explicit MerkleTree(const std::vector<std::string>& transactionHashes);
+    explicit MerkleTree(const std::vector<crypto::Hash256>& transactionHashes);
+    
+    /**
+     * @brief Add a leaf after the last one
+     * 
+     * Re-hashes O(log n) nodes; the root equals that of a tree built
+     * from all leaves at once.
+     * 
+     * @param transactionHash New leaf
+     */
+    void append(const crypto::Hash256& transactionHash);
+    
+    /**
+     * @brief Overwrite a leaf and re-hash its path to the root
+     * @param leafIndex Position of the leaf
+     * @param transactionHash New leaf value
+     * @throws std::out_of_range if leafIndex is not a leaf
+     */
+    void replace(size_t leafIndex, const crypto::Hash256& transactionHash);
     
     /**
      * @brief Get Merkle root hash
-     * @return Root hash as hex string
+     * @return Root hash (all zero for an empty tree)
      */
-    std::string getRoot() const { return root; }
+    const crypto::Hash256& getRoot() const { return root; }
     
     /**
      * @brief Get leaf hashes
-     * @return Vector of leaf node hashes
+     * @return Copy of the leaf node hashes, in transaction order
+     */
+    std::vector<crypto::Hash256> getLeaves() const;
+    
+    /**
+     * @brief Get the number of leaves
+     * @return Number of transaction hashes
      */
-    const std::vector<std::string>& getLeaves() const { return leaves; }
+    size_t getLeafCount() const { return leafCount; }
     
     /**
      * @brief Display tree information
@@ -77,7 +174,43 @@ public:
      * @param transactionHash Hash of transaction to verify
      * @return true if transaction is in tree
      */
-    bool verifyTransaction(const std::string& transactionHash) const;
+    bool verifyTransaction(const crypto::Hash256& transactionHash) const;
+    
+    /**
+     * @brief Find the position of a leaf in O(1) after the first lookup
+     * @param transactionHash Leaf to look up
+     * @param index Output: first position of the leaf
+     * @return false if the hash is not a leaf
+     */
+    bool findLeaf(const crypto::Hash256& transactionHash, size_t& index) const;
+    
+    /**
+     * @brief Build the inclusion proof for a leaf
+     * @param leafIndex Position of the leaf
+     * @return Sibling path with ceil(log2(leaves)) entries
+     * @throws std::out_of_range if leafIndex is not a leaf
+     */
+    MerkleProof getProof(size_t leafIndex) const;
+    
+    /**
+     * @brief Check an inclusion proof against a root
+     * 
+     * Needs only the leaf, the proof and the root, so a light client
+     * holding block headers can verify a transaction with one hash per
+     * level.
+     * 
+     * The index must be below the leaf count and the path exactly as
+     * long as that tree is deep. The sibling of a node that was padded
+     * must be its own copy, and a right child may not equal its left
+     * sibling, since only padding duplicates a node (CVE-2012-2459).
+     * 
+     * @param leaf Transaction hash
+     * @param proof Sibling path from getProof()
+     * @param root Expected Merkle root
+     * @return true if the path leads from leaf to root
+     */
+    static bool verifyProof(const crypto::Hash256& leaf, const MerkleProof& proof,
+                            const crypto::Hash256& root);
 };
 
 } // namespace blockchain
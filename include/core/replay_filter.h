@@ -0,0 +1,200 @@
+/**
+ * @file replay_filter.h
+ * @brief Bounded-memory detection of transactions already on the chain
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef REPLAY_FILTER_H
+#define REPLAY_FILTER_H
+
+#include "crypto/hash256.h"
+#include <deque>
+#include <unordered_set>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+
+/**
+ * @enum ReplayCheck
+ * @brief Outcome of ReplayFilter::check()
+ */
+enum class ReplayCheck {
+    ABSENT,     ///< Definitely not recorded
+    CONFIRMED,  ///< Recorded in the recent-block window (exact)
+    POSSIBLE    ///< The filter matched: recorded earlier, or a false positive
+};
+
+/**
+ * @class CuckooFilter
+ * @brief Approximate set of 256-bit digests in a fixed amount of memory
+ *
+ * Each digest is stored as a 16-bit fingerprint in one of two buckets of
+ * BUCKET_SIZE slots, so contains() reads at most two buckets. There are
+ * no false negatives; the false-positive rate is about
+ * 2 * BUCKET_SIZE / 2^16 (~0.012%) when full. Digests are already
+ * uniformly distributed, so bucket indices and fingerprints are taken
+ * straight from their bytes.
+ */
+class CuckooFilter {
+public:
+    static constexpr size_t BUCKET_SIZE = 4;    ///< Fingerprints per bucket
+    static constexpr size_t MAX_KICKS = 500;    ///< Relocations before insert() gives up
+
+    /**
+     * @brief Construct an empty filter
+     * @param capacity Digests it must hold (memory is allocated on first insert)
+     */
+    explicit CuckooFilter(size_t capacity);
+
+    /**
+     * @brief Add a digest
+     * @return false if the filter is full; it then holds one digest in a
+     *         spare slot and accepts nothing more until clear()
+     */
+    bool insert(const crypto::Hash256& digest);
+
+    /**
+     * @brief Check whether a digest may have been added
+     */
+    bool contains(const crypto::Hash256& digest) const;
+
+    /**
+     * @brief Forget every digest (keeps the allocation)
+     */
+    void clear();
+
+    /**
+     * @brief Append the filter's exact state to a buffer
+     * @param out Buffer to extend
+     */
+    void encode(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Restore a state written by encode()
+     * @param data Encoded bytes
+     * @param length Bytes available
+     * @param offset In: where the state starts; out: just past it
+     * @return false if the bytes are truncated or inconsistent
+     */
+    bool decode(const uint8_t* data, size_t length, size_t& offset);
+
+    /**
+     * @brief Whether size() reached the capacity or an insert failed
+     */
+    bool isFull() const { return count >= capacity || hasVictim; }
+
+    // Getters
+    size_t size() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    size_t memoryBytes() const { return slots.capacity() * sizeof(uint16_t); }
+
+private:
+    size_t capacity;                ///< Digests accepted before isFull()
+    size_t bucketMask;              ///< Bucket count - 1 (a power of two)
+    std::vector<uint16_t> slots;    ///< Fingerprints, 0 = empty
+    size_t count = 0;
+    uint16_t victim = 0;            ///< Fingerprint evicted by a failed insert
+    size_t victimBucket = 0;
+    bool hasVictim = false;
+
+    static uint16_t fingerprintOf(const crypto::Hash256& digest);
+    size_t alternateBucket(size_t bucket, uint16_t fingerprint) const;
+    bool bucketHas(size_t bucket, uint16_t fingerprint) const;
+    bool bucketAdd(size_t bucket, uint16_t fingerprint);
+};
+
+/**
+ * @class ReplayFilter
+ * @brief Tracks confirmed transaction IDs so a block cannot repeat one
+ *
+ * IDs of the most recent blocks are kept exactly. When a block leaves
+ * that window its IDs move into a cuckoo filter, so memory stays fixed
+ * however long the chain grows and check() costs O(1) expected time.
+ * A filter match is reported as POSSIBLE: the caller confirms it against
+ * the getFilteredBlocks() blocks just below the window, which only
+ * happens for real replays and the rare false positive.
+ *
+ * Two filter generations are kept. When the current one fills, the older
+ * one is dropped and the current one takes its place, so at least
+ * filterCapacity IDs beyond the window are always covered; a replay of
+ * anything older than that is no longer detected.
+ *
+ * Not thread-safe; the owning Blockchain serialises access.
+ */
+class ReplayFilter {
+public:
+    static constexpr size_t DEFAULT_WINDOW_BLOCKS = 64;                     ///< Blocks kept exactly
+    static constexpr size_t DEFAULT_FILTER_CAPACITY = size_t(1) << 20;      ///< IDs per generation
+
+    /**
+     * @brief Construct an empty filter
+     * @param windowBlocks Most recent blocks whose IDs are kept exactly (at least 1)
+     * @param filterCapacity IDs held by each filter generation
+     */
+    explicit ReplayFilter(size_t windowBlocks = DEFAULT_WINDOW_BLOCKS,
+                          size_t filterCapacity = DEFAULT_FILTER_CAPACITY);
+
+    /**
+     * @brief Check whether a transaction ID was recorded
+     * @param id Transaction digest
+     */
+    ReplayCheck check(const crypto::Hash256& id) const;
+
+    /**
+     * @brief Record the transaction IDs of the next block on the chain
+     * @param ids Digests of the block's transactions
+     */
+    void recordBlock(const std::vector<crypto::Hash256>& ids);
+
+    /**
+     * @brief Forget everything
+     */
+    void clear();
+
+    /**
+     * @brief Append the window and both filter generations to a buffer
+     *
+     * Restoring this is much cheaper than re-hashing the transactions
+     * of every block the filter covers.
+     *
+     * @param out Buffer to extend
+     */
+    void encode(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Restore a state written by encode()
+     * @param data Encoded bytes
+     * @param length Bytes available
+     * @param offset In: where the state starts; out: just past it
+     * @return false if the bytes are truncated or inconsistent (the
+     *         filter is left cleared)
+     */
+    bool decode(const uint8_t* data, size_t length, size_t& offset);
+
+    // Getters
+    size_t getWindowBlocks() const { return windowBlocks; }
+    size_t getFilterCapacity() const { return current.getCapacity(); }
+    size_t getRecentBlocks() const { return recentBlocks.size(); }
+    size_t getRecentCount() const { return recent.size(); }
+    size_t getFilteredCount() const { return current.size() + previous.size(); }
+    size_t getFilteredBlocks() const { return currentBlocks + previousBlocks; }
+    size_t getFilterMemory() const { return current.memoryBytes() + previous.memoryBytes(); }
+
+private:
+    size_t windowBlocks;
+    std::deque<std::vector<crypto::Hash256>> recentBlocks;  ///< IDs per block, oldest first
+    std::unordered_set<crypto::Hash256> recent;              ///< Every ID in recentBlocks
+    CuckooFilter current;                                    ///< Receives IDs leaving the window
+    CuckooFilter previous;                                   ///< Older generation
+    size_t currentBlocks = 0;                                ///< Blocks with IDs in current
+    size_t previousBlocks = 0;                               ///< Blocks with IDs in previous
+
+    void retire(const std::vector<crypto::Hash256>& ids);
+};
+
+} // namespace blockchain
+
+#endif // REPLAY_FILTER_H
@@ -8,11 +8,21 @@
 #ifndef TRANSACTION_H
 #define TRANSACTION_H
 
+#include "core/address_table.h"
+#include "core/amount.h"
+#include "crypto/ed25519.h"
+#include "crypto/hash256.h"
 #include <string>
+#include <string_view>
+#include <vector>
 #include <ctime>
+#include <cstdint>
+#include <cstddef>
 
 namespace blockchain {
 
+class TransactionView;
+
 /**
  * @class Transaction
  * @brief Represents a single transaction in the blockchain
@@ -20,36 +30,92 @@ namespace blockchain {
  * A transaction records the transfer of value from one party to another.
  * Each transaction includes:
  * - Unique identifier
- * - Sender address
- * - Receiver address
- * - Amount being transferred
+ * - Sender address (interned in AddressTable)
+ * - Receiver address (interned in AddressTable)
+ * - Amount being transferred, in fixed-point base units
  * - Timestamp
+ * 
+ * A transaction never changes after construction, so its digest is
+ * computed once there and the ID is the full 256-bit digest in hex. A
+ * per-process sequence number is part of the hashed data, so identical
+ * payloads created in the same second still get distinct IDs.
+ * 
+ * The digest covers the body of the compact binary encoding (version 2,
+ * little-endian), which is also the wire format:
+ * 
+ * | Offset     | Size | Field              |
+ * |------------|------|--------------------|
+ * | 0          | 1    | version            |
+ * | 1          | 8    | timestamp          |
+ * | 9          | 8    | sequence           |
+ * | 17         | 8    | amount (units)     |
+ * | 25         | 1    | sender length      |
+ * | 26         | n    | sender             |
+ * | 26 + n     | 1    | receiver length    |
+ * | 27 + n     | m    | receiver           |
+ * | 27 + n + m | 1    | signature flag     |
+ * | 28 + n + m | 64   | signature (if set) |
+ * 
+ * The signature is an Ed25519 signature of the digest by the key whose
+ * hex encoding is the sender address (see addressOf()). It is witness
+ * data: it follows the hashed body, so signing does not change the ID.
+ * TransactionView reads the same bytes in place.
  */
 class Transaction {
 private:
-    std::string id;          ///< Unique transaction identifier
-    std::string sender;      ///< Sender's address
-    std::string receiver;    ///< Receiver's address
-    double amount;           ///< Amount being transferred
+    AddressId sender;        ///< Sender's address
+    AddressId receiver;      ///< Receiver's address
+    Amount amount;           ///< Amount being transferred (base units)
     time_t timestamp;        ///< Transaction creation time
+    uint64_t sequence;       ///< Disambiguates otherwise identical payloads
+    crypto::Hash256 hash;    ///< Cached digest of the canonical encoding
+    crypto::Ed25519::Signature signature{};  ///< Sender's signature of hash
+    bool hasSignature = false;               ///< Whether signature is set
+    
+    /**
+     * @brief Construct from every encoded field (decoding, factories)
+     * @throws std::invalid_argument if an address is too long to encode
+     */
+    Transaction(std::string_view sender, std::string_view receiver, Amount amount,
+                time_t timestamp, uint64_t sequence);
     
     /**
-     * @brief Generate unique transaction ID
-     * @return Generated ID string
+     * @brief Hash the canonical encoding
      */
-    std::string generateId();
+    void computeDigest();
+    
+    friend class TransactionView;
 
 public:
+    static constexpr uint8_t ENCODING_VERSION = 2;          ///< Current wire format
+    static constexpr size_t MAX_ADDRESS_LENGTH = 255;       ///< Bytes per address
+    static constexpr size_t MIN_BODY_SIZE = 27;             ///< Hashed bytes with empty addresses
+    static constexpr size_t MIN_ENCODED_SIZE = MIN_BODY_SIZE + 1;   ///< Unsigned, empty addresses
+    static constexpr size_t MAX_ENCODED_SIZE =
+        MIN_ENCODED_SIZE + 2 * MAX_ADDRESS_LENGTH + crypto::Ed25519::SIGNATURE_SIZE;
+    
     /**
      * @brief Construct a new Transaction
      * @param sender Sender's address
      * @param receiver Receiver's address
-     * @param amount Amount to transfer
+     * @param amount Amount to transfer in coins, rounded to the nearest base unit
+     * @throws std::invalid_argument if the amount is out of range or an
+     *         address is longer than MAX_ADDRESS_LENGTH bytes
      */
-    Transaction(const std::string& sender, 
-                const std::string& receiver, 
+    Transaction(const std::string& sender,
+                const std::string& receiver,
                 double amount);
     
+    /**
+     * @brief Create a transaction with an exact amount
+     * @param sender Sender's address
+     * @param receiver Receiver's address
+     * @param amount Amount in base units
+     * @return New transaction stamped with the current time
+     * @throws std::invalid_argument if an address is too long to encode
+     */
+    static Transaction fromUnits(const std::string& sender, const std::string& receiver, Amount amount);
+    
     /**
      * @brief Convert transaction to string representation
      * @return String representation of transaction
@@ -57,10 +123,32 @@ public:
     std::string toString() const;
     
     /**
-     * @brief Calculate hash of transaction
-     * @return SHA-256 hash of transaction data
+     * @brief Get hash of transaction
+     * @return Chain hash of the binary encoding (computed at construction)
+     */
+    const crypto::Hash256& getHash() const { return hash; }
+    
+    /**
+     * @brief Length of the hashed part of the encoding
+     * @return Bytes covered by getHash()
+     */
+    size_t bodySize() const {
+        return MIN_BODY_SIZE + getSender().size() + getReceiver().size();
+    }
+    
+    /**
+     * @brief Length of the binary encoding
+     * @return Bytes written by encode()
+     */
+    size_t encodedSize() const {
+        return bodySize() + 1 + (hasSignature ? crypto::Ed25519::SIGNATURE_SIZE : 0);
+    }
+    
+    /**
+     * @brief Write the binary encoding
+     * @param out Buffer of at least encodedSize() bytes
      */
-    std::string getHash() const;
+    void encode(uint8_t* out) const;
     
     /**
      * @brief Display transaction details
@@ -73,12 +161,70 @@ public:
      */
     bool isValid() const;
     
+    /**
+     * @brief Validation rules shared with TransactionView
+     * @param sender Sender's address
+     * @param receiver Receiver's address
+     * @param amount Amount in base units
+     * @return true if the fields describe a valid transfer
+     */
+    static bool isValidTransfer(std::string_view sender, std::string_view receiver, Amount amount);
+    
+    /**
+     * @brief Address controlled by an Ed25519 key
+     * @param publicKey Public key
+     * @return Lowercase hex of the key (64 characters)
+     */
+    static std::string addressOf(const crypto::Ed25519::PublicKey& publicKey);
+    
+    /**
+     * @brief Sign the transaction digest
+     * @param key Key pair whose address is the sender
+     * @throws std::invalid_argument if the sender is not addressOf(key)
+     */
+    void sign(const crypto::Ed25519::KeyPair& key);
+    
+    /**
+     * @brief Decode the sender address as a public key
+     * @param publicKey Output: sender's key
+     * @return false if the sender is not a key address
+     */
+    bool getSenderKey(crypto::Ed25519::PublicKey& publicKey) const;
+    
+    /**
+     * @brief Verify this transaction's signature on its own
+     * @return true if signed by the sender's key
+     */
+    bool verifySignature() const;
+    
+    /**
+     * @brief Batch-verify the signatures of many transactions
+     * 
+     * Every signed transaction is checked in one Ed25519::verifyBatch()
+     * call. A signed transaction whose sender is not a key address fails.
+     * 
+     * @param transactions Transactions to check
+     * @param requireSigned Also fail if any transaction is unsigned
+     * @return true if all signatures are valid
+     */
+    static bool verifySignatures(const std::vector<Transaction>& transactions, bool requireSigned);
+    
+    /**
+     * @brief Unique transaction identifier
+     * @return Hex of getHash(), formatted on each call
+     */
+    std::string getId() const { return hash.toHex(); }
+    
     // Getters
-    std::string getId() const { return id; }
-    std::string getSender() const { return sender; }
-    std::string getReceiver() const { return receiver; }
-    double getAmount() const { return amount; }
+    const std::string& getSender() const { return AddressTable::instance().resolve(sender); }
+    const std::string& getReceiver() const { return AddressTable::instance().resolve(receiver); }
+    AddressId getSenderId() const { return sender; }
+    AddressId getReceiverId() const { return receiver; }
+    Amount getAmount() const { return amount; }
     time_t getTimestamp() const { return timestamp; }
+    uint64_t getSequence() const { return sequence; }
+    bool isSigned() const { return hasSignature; }
+    const crypto::Ed25519::Signature& getSignature() const { return signature; }
 };
 
 } // namespace blockchain
@@ -0,0 +1,158 @@
+/**
+ * @file transaction_validator.h
+ * @brief Parallel transaction validation with a validated-digest cache
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef TRANSACTION_VALIDATOR_H
+#define TRANSACTION_VALIDATOR_H
+
+#include "core/transaction.h"
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <cstddef>
+
+namespace blockchain {
+
+/**
+ * @struct ValidationResult
+ * @brief Outcome of validating a list of transactions
+ */
+struct ValidationResult {
+    bool valid = true;          ///< Whether every transaction passed
+    size_t failedIndex = 0;     ///< Lowest index of a failing transaction (if !valid)
+    std::string reason;         ///< Why that transaction failed (if !valid)
+    size_t cacheHits = 0;       ///< Transactions accepted without re-checking
+};
+
+/**
+ * @class ValidatedCache
+ * @brief Bounded set of transactions that already passed validation
+ *
+ * Keys are the transaction digest for unsigned transactions and a digest
+ * of (digest, signature) for signed ones, since the signature is not
+ * part of the ID. The set is split into shards with their own lock so
+ * validation workers rarely contend; each shard evicts its oldest entry
+ * when full.
+ */
+class ValidatedCache {
+public:
+    static constexpr size_t SHARDS = 16;   ///< Independently locked partitions
+
+    /**
+     * @brief Construct an empty cache
+     * @param capacity Maximum entries held (at least SHARDS)
+     */
+    explicit ValidatedCache(size_t capacity);
+
+    /**
+     * @brief Check whether a transaction was recorded as valid
+     * @param tx Transaction, including its signature
+     * @return true if an identical transaction passed before
+     */
+    bool contains(const Transaction& tx) const;
+
+    /**
+     * @brief Record a transaction as valid
+     * @param tx Transaction that passed validation
+     */
+    void insert(const Transaction& tx);
+
+    /**
+     * @brief Forget every entry
+     */
+    void clear();
+
+    /**
+     * @brief Number of entries held
+     */
+    size_t size() const;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<crypto::Hash256> keys;
+        std::deque<crypto::Hash256> order;   ///< Insertion order, for eviction
+    };
+
+    std::array<Shard, SHARDS> shards;
+    size_t shardCapacity;
+
+    static crypto::Hash256 keyOf(const Transaction& tx);
+    static size_t shardIndex(const crypto::Hash256& key) { return key.bytes[0] % SHARDS; }
+};
+
+/**
+ * @class TransactionValidator
+ * @brief Validates a block's transactions across worker threads
+ *
+ * Transactions are split into chunks of PARALLEL_GRAIN that workers
+ * claim in order. A chunk checks the transfer rules of each transaction,
+ * then batch-verifies its signatures with Ed25519::verifyBatch(); only
+ * a failed batch falls back to one-by-one verification to find the
+ * culprit. Once any transaction fails, chunks after it are skipped, but
+ * earlier chunks still finish so the reported index is the lowest
+ * failing one, exactly as a serial loop would report.
+ *
+ * With a cache, transactions that already passed (e.g. on admission) are
+ * not checked again when the block is verified later.
+ */
+class TransactionValidator {
+public:
+    static constexpr size_t PARALLEL_GRAIN = 256;                 ///< Transactions per chunk
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = size_t(1) << 18;
+
+    /**
+     * @brief Construct a validator
+     * @param threads Worker threads (0 = hardware concurrency)
+     * @param cacheCapacity Validated-digest cache size (0 = no cache)
+     */
+    explicit TransactionValidator(unsigned threads = 0, size_t cacheCapacity = 0);
+
+    /**
+     * @brief Validate transactions, stopping at the first failure
+     * @param transactions Transactions to check
+     * @param requireSigned Also fail unsigned transactions
+     * @return Result naming the lowest failing index, if any
+     */
+    ValidationResult validate(const std::vector<Transaction>& transactions, bool requireSigned);
+
+    /**
+     * @brief Validate on the calling thread only
+     *
+     * For callers that already run on several threads (e.g. the
+     * isChainValid() workers), so each does not start a pool of its own.
+     * Uses the cache like validate().
+     *
+     * @param transactions Transactions to check
+     * @param requireSigned Also fail unsigned transactions
+     * @return Result naming the lowest failing index, if any
+     */
+    ValidationResult validateSerial(const std::vector<Transaction>& transactions, bool requireSigned);
+
+    /**
+     * @brief Set the number of worker threads
+     * @param threads Worker threads (0 = hardware concurrency)
+     */
+    void setThreads(unsigned threads) { this->threads = threads; }
+
+    // Getters
+    unsigned getThreads() const { return threads; }
+    ValidatedCache* getCache() { return cache.get(); }
+
+private:
+    unsigned threads;                       ///< Requested workers (0 = hardware)
+    std::unique_ptr<ValidatedCache> cache;  ///< Null when caching is off
+
+    ValidationResult run(const std::vector<Transaction>& transactions, bool requireSigned, size_t workers);
+};
+
+} // namespace blockchain
+
+#endif // TRANSACTION_VALIDATOR_H
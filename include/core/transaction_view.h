@@ -0,0 +1,80 @@
+/**
+ * @file transaction_view.h
+ * @brief Zero-copy reader for encoded transactions
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef TRANSACTION_VIEW_H
+#define TRANSACTION_VIEW_H
+
+#include "core/transaction.h"
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace blockchain {
+
+/**
+ * @class TransactionView
+ * @brief Reads the fields of an encoded transaction in place
+ *
+ * A view only points into the caller's buffer, which must outlive it.
+ * Parsing, validating and hashing a view allocate nothing, so a batch
+ * of concatenated encodings can be ingested before any Transaction is
+ * materialised.
+ */
+class TransactionView {
+private:
+    const uint8_t* data = nullptr;  ///< Start of the encoding
+    size_t size = 0;                ///< Length of the encoding
+    size_t bodySize = 0;            ///< Length of the hashed body
+
+public:
+    TransactionView() = default;
+
+    /**
+     * @brief Parse one encoded transaction at the start of a buffer
+     * @param buffer Encoded bytes (may continue with more transactions)
+     * @param length Bytes available in buffer
+     * @param view Output: view of the first transaction
+     * @return false if the bytes are truncated, the version is unknown
+     *         or the signature flag is not 0 or 1
+     */
+    static bool parse(const uint8_t* buffer, size_t length, TransactionView& view);
+
+    /**
+     * @brief Chain hash of the encoded body
+     * @return Same value as Transaction::getHash() of the decoded transaction
+     */
+    crypto::Hash256 computeHash() const;
+
+    /**
+     * @brief Apply Transaction::isValidTransfer() to the encoded fields
+     * @return true if the transaction is valid
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Materialise the transaction
+     * @return Transaction with the same fields and hash
+     */
+    Transaction toTransaction() const;
+
+    // Getters
+    const uint8_t* getData() const { return data; }
+    size_t getEncodedSize() const { return size; }
+    size_t getBodySize() const { return bodySize; }
+    uint8_t getVersion() const { return data[0]; }
+    time_t getTimestamp() const;
+    uint64_t getSequence() const;
+    Amount getAmount() const;
+    std::string_view getSender() const;
+    std::string_view getReceiver() const;
+    bool isSigned() const { return data[bodySize] != 0; }
+    crypto::Ed25519::Signature getSignature() const;
+};
+
+} // namespace blockchain
+
+#endif // TRANSACTION_VIEW_H
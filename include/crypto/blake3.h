@@ -0,0 +1,186 @@
+/**
+ * @file blake3.h
+ * @brief BLAKE3 Cryptographic Hash Function Implementation
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Default-length (32-byte) unkeyed BLAKE3 hashing with the same
+ * streaming and batch interface as SHA256, so either can be plugged
+ * into the chain through crypto/hash_policy.h.
+ */
+
+#ifndef BLAKE3_H
+#define BLAKE3_H
+
+#include "crypto/sha256.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace crypto {
+
+/**
+ * @class Blake3
+ * @brief Implements the BLAKE3 cryptographic hash function
+ *
+ * BLAKE3 splits the input into 1024-byte chunks, compresses each chunk
+ * as a chain of 64-byte blocks with a 7-round function, and merges the
+ * chunk chaining values in a binary tree. Block and transaction hashes
+ * fit in a single chunk, so batches of them map directly onto SIMD
+ * lanes (SSE2, AVX2 or AVX-512F).
+ */
+class Blake3 {
+private:
+    static constexpr size_t MAX_DEPTH = 54;  ///< Tree depth for 2^64 bytes
+
+    uint32_t cv[8];                          ///< Chaining value of the current chunk
+    uint8_t buffer[64];                      ///< Pending block (never compressed early)
+    size_t bufferLength;                     ///< Bytes used in buffer
+    size_t blocksCompressed;                 ///< Blocks compressed in the current chunk
+    uint64_t chunkCounter;                   ///< Index of the current chunk
+    uint32_t cvStack[MAX_DEPTH][8];          ///< Chaining values of completed subtrees
+    size_t cvStackLength;                    ///< Entries used in cvStack
+
+    /**
+     * @brief Portable single-block compression (chaining value output)
+     */
+    static void compress(uint32_t cv[8], const uint8_t block[64], uint64_t counter,
+                         uint32_t blockLength, uint32_t flags);
+
+    /**
+     * @brief Merge a finished chunk into the chaining value stack
+     */
+    void addChunkChainingValue(uint32_t chunkCv[8], uint64_t totalChunks);
+
+public:
+    static constexpr size_t DIGEST_SIZE = 32;   ///< Digest length in bytes
+    static constexpr size_t BLOCK_SIZE = 64;    ///< Compression block length in bytes
+    static constexpr size_t CHUNK_SIZE = 1024;  ///< Chunk length in bytes
+
+    /// Binary BLAKE3 digest
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    /**
+     * @brief Default constructor
+     * Initializes an unkeyed hasher
+     */
+    Blake3();
+
+    /**
+     * @brief Restore the initial state so the object can be reused
+     */
+    void reset();
+
+    /**
+     * @brief Compute BLAKE3 hash of input string
+     * @param input The string to hash
+     * @return 64-character hexadecimal hash string
+     */
+    static std::string hash(const std::string& input);
+
+    /**
+     * @brief Compute the binary BLAKE3 digest of a buffer
+     * @param data Pointer to data
+     * @param length Length of data
+     * @return 32-byte digest
+     */
+    static Digest digest(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Compute the binary BLAKE3 digest of a string
+     * @param input The string to hash
+     * @return 32-byte digest
+     */
+    static Digest digest(const std::string& input);
+
+    /**
+     * @brief Update hash with new data (for streaming)
+     * @param data Pointer to data
+     * @param length Length of data
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Update hash with the bytes of a string
+     * @param data String data
+     */
+    void update(const std::string& data);
+
+    /**
+     * @brief Finalize hash computation
+     *
+     * Does not modify the state; more data may be added afterwards.
+     *
+     * @return 32-byte digest
+     */
+    Digest finalize() const;
+
+    /**
+     * @brief Hash many independent messages in one call
+     *
+     * Messages of up to one chunk are spread across the lanes of the
+     * active batch kernel; longer ones are hashed one at a time.
+     *
+     * @param messages Pointers to the message bytes
+     * @param lengths Length of each message in bytes
+     * @param count Number of messages
+     * @param digests Output buffer of count * 32 bytes
+     */
+    static void hashBatch(const uint8_t* const* messages, const size_t* lengths,
+                          size_t count, uint8_t* digests);
+
+    /**
+     * @brief Hash many messages that continue the data absorbed so far
+     *
+     * Each digest equals copying this object, feeding the suffix and
+     * calling finalize(). While the prefix and suffix stay within the
+     * first chunk every lane starts from this object's chaining value,
+     * so the prefix is never re-compressed.
+     *
+     * @param suffixes Pointers to the bytes following the prefix
+     * @param lengths Length of each suffix in bytes
+     * @param count Number of messages
+     * @param digests Output buffer of count * 32 bytes
+     */
+    void hashSuffixBatch(const uint8_t* const* suffixes, const size_t* lengths,
+                         size_t count, uint8_t* digests) const;
+
+    /**
+     * @brief Hash many independent strings in one call
+     * @param inputs Strings to hash
+     * @return 64-character hexadecimal hash for each input, in order
+     */
+    static std::vector<std::string> hashBatch(const std::vector<std::string>& inputs);
+
+    /**
+     * @brief Get the kernel currently used by hashBatch
+     * @return Active kernel (widest supported one unless overridden)
+     */
+    static BatchKernel getBatchKernel();
+
+    /**
+     * @brief Override the batch kernel (e.g. to compare against SCALAR)
+     * @param kernel Kernel to use
+     * @return false if the CPU does not support the kernel
+     */
+    static bool setBatchKernel(BatchKernel kernel);
+
+    /**
+     * @brief Check whether a batch kernel can run on this CPU
+     * @param kernel Kernel to check
+     * @return true if supported
+     */
+    static bool isBatchKernelSupported(BatchKernel kernel);
+
+    /**
+     * @brief Number of messages the active kernel hashes per pass
+     * @return Lane count (1 for SCALAR)
+     */
+    static size_t getBatchLanes();
+};
+
+} // namespace crypto
+
+#endif // BLAKE3_H
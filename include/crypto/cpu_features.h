@@ -0,0 +1,39 @@
+/**
+ * @file cpu_features.h
+ * @brief Runtime CPU feature detection for hash kernel dispatch
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+namespace crypto {
+
+/**
+ * @struct CpuFeatures
+ * @brief Instruction set extensions usable by this process
+ *
+ * A flag is only set when both the CPU advertises the extension and the
+ * operating system saves the corresponding register state, so callers can
+ * dispatch on it without further checks. All flags are false on non-x86
+ * targets.
+ */
+struct CpuFeatures {
+    bool sse2 = false;     ///< SSE2 (baseline on x86-64)
+    bool ssse3 = false;    ///< Supplemental SSE3
+    bool sse41 = false;    ///< SSE4.1
+    bool avx2 = false;     ///< AVX2 with YMM state enabled
+    bool avx512f = false;  ///< AVX-512 Foundation with ZMM state enabled
+    bool sha = false;      ///< SHA extensions (with SSSE3 and SSE4.1)
+};
+
+/**
+ * @brief Detect CPU features once and cache the result
+ * @return Reference to the process-wide feature set
+ */
+const CpuFeatures& cpuFeatures();
+
+} // namespace crypto
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,116 @@
+/**
+ * @file ed25519.h
+ * @brief Ed25519 signatures with batch verification
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * RFC 8032 Ed25519 (pure, no context). Keys and signatures are raw byte
+ * arrays; a key's hex encoding doubles as its chain address.
+ */
+
+#ifndef ED25519_H
+#define ED25519_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace crypto {
+
+/**
+ * @class Ed25519
+ * @brief Signature verification, singly or in batches
+ *
+ * Verification is cofactored: it checks [8][s]B == [8]R + [8][k]A, so a
+ * batch accepts exactly the signatures that verify() accepts one by one.
+ * Non-canonical point encodings and scalars s >= L are rejected.
+ */
+class Ed25519 {
+public:
+    static constexpr size_t PUBLIC_KEY_SIZE = 32;   ///< Encoded point A
+    static constexpr size_t SEED_SIZE = 32;         ///< Private key seed
+    static constexpr size_t SIGNATURE_SIZE = 64;    ///< R || S
+
+    using PublicKey = std::array<uint8_t, PUBLIC_KEY_SIZE>;
+    using Seed = std::array<uint8_t, SEED_SIZE>;
+    using Signature = std::array<uint8_t, SIGNATURE_SIZE>;
+
+    /**
+     * @struct BatchEntry
+     * @brief One signature to verify; all pointers are borrowed
+     */
+    struct BatchEntry {
+        const PublicKey* publicKey;
+        const Signature* signature;
+        const uint8_t* message;
+        size_t length;
+    };
+
+    /**
+     * @class KeyPair
+     * @brief A private seed and the public key derived from it
+     */
+    class KeyPair {
+    private:
+        Seed seed;                  ///< RFC 8032 private key
+        uint8_t scalar[32];         ///< Clamped secret scalar a
+        uint8_t prefix[32];         ///< Nonce derivation key
+        PublicKey publicKey;        ///< Encoded [a]B
+
+    public:
+        /**
+         * @brief Derive a key pair from a seed
+         * @param seed 32-byte private key
+         */
+        explicit KeyPair(const Seed& seed);
+
+        /**
+         * @brief Create a key pair from a fresh random seed
+         * @return New key pair
+         */
+        static KeyPair generate();
+
+        /**
+         * @brief Sign a message
+         * @param message Message bytes
+         * @param length Message length
+         * @return 64-byte signature
+         */
+        Signature sign(const uint8_t* message, size_t length) const;
+
+        const Seed& getSeed() const { return seed; }
+        const PublicKey& getPublicKey() const { return publicKey; }
+    };
+
+    /**
+     * @brief Verify one signature
+     * @param publicKey Signer's public key
+     * @param message Message bytes
+     * @param length Message length
+     * @param signature Signature to check
+     * @return true if the signature is valid
+     */
+    static bool verify(const PublicKey& publicKey, const uint8_t* message, size_t length,
+                       const Signature& signature);
+
+    /**
+     * @brief Verify many signatures at once
+     *
+     * Checks a random linear combination of the verification equations
+     * with one multi-scalar multiplication, which costs far less than
+     * count separate verifications. The random weights come from
+     * std::random_device, so a forger cannot arrange for invalid
+     * signatures to cancel out. A false result says only that at least
+     * one entry is invalid; use verify() to find which.
+     *
+     * @param entries Signatures to verify
+     * @param count Number of entries
+     * @return true if every signature is valid (true for an empty batch)
+     */
+    static bool verifyBatch(const BatchEntry* entries, size_t count);
+};
+
+} // namespace crypto
+
+#endif // ED25519_H
@@ -0,0 +1,108 @@
+/**
+ * @file hash256.h
+ * @brief 32-byte binary hash value type
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef HASH256_H
+#define HASH256_H
+
+#include "crypto/sha256.h"
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+namespace crypto {
+
+/**
+ * @struct Hash256
+ * @brief A 256-bit hash held as raw bytes
+ * 
+ * Used for every block, transaction and Merkle hash. It is trivially
+ * copyable, compares with a single memcmp and can key unordered
+ * containers; hex text is only produced at display and serialisation
+ * boundaries through toHex() / fromHex().
+ */
+struct Hash256 {
+    static constexpr size_t SIZE = 32;  ///< Length in bytes
+    
+    std::array<uint8_t, SIZE> bytes{};  ///< Hash bytes (all zero by default)
+    
+    Hash256() = default;
+    
+    /**
+     * @brief Wrap a SHA-256 digest
+     * @param digest Binary digest
+     */
+    Hash256(const SHA256::Digest& digest) : bytes(digest) {}
+    
+    /**
+     * @brief Parse a 64-character hex string
+     * @param hex Hex text (either case)
+     * @param out Parsed hash
+     * @return false if hex is not exactly 64 hex characters
+     */
+    static bool fromHex(const std::string& hex, Hash256& out);
+    
+    /**
+     * @brief Parse a 64-character hex string
+     * @param hex Hex text (either case)
+     * @return Parsed hash
+     * @throws std::invalid_argument if hex is malformed
+     */
+    static Hash256 fromHex(const std::string& hex);
+    
+    /**
+     * @brief Lowercase hex representation
+     * @return 64-character hex string
+     */
+    std::string toHex() const;
+    
+    /**
+     * @brief Check for the all-zero hash
+     * @return true if every byte is zero
+     */
+    bool isZero() const { return *this == Hash256(); }
+    
+    const uint8_t* data() const { return bytes.data(); }
+    uint8_t* data() { return bytes.data(); }
+    
+    bool operator==(const Hash256& other) const {
+        return std::memcmp(bytes.data(), other.bytes.data(), SIZE) == 0;
+    }
+    bool operator!=(const Hash256& other) const { return !(*this == other); }
+    bool operator<(const Hash256& other) const {
+        return std::memcmp(bytes.data(), other.bytes.data(), SIZE) < 0;
+    }
+};
+
+static_assert(sizeof(Hash256) == Hash256::SIZE, "Hash256 must be exactly 32 bytes");
+static_assert(std::is_trivially_copyable<Hash256>::value, "Hash256 must be trivially copyable");
+
+} // namespace crypto
+
+namespace std {
+
+/**
+ * @brief Hash functor for unordered containers
+ * 
+ * The value is already a uniformly distributed digest, so its first
+ * eight bytes are used directly.
+ */
+template <>
+struct hash<crypto::Hash256> {
+    size_t operator()(const crypto::Hash256& h) const noexcept {
+        uint64_t value;
+        std::memcpy(&value, h.bytes.data(), sizeof(value));
+        return static_cast<size_t>(value);
+    }
+};
+
+} // namespace std
+
+#endif // HASH256_H
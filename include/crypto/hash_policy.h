@@ -0,0 +1,56 @@
+/**
+ * @file hash_policy.h
+ * @brief Compile-time selection of the chain hash function
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef HASH_POLICY_H
+#define HASH_POLICY_H
+
+#include "crypto/sha256.h"
+#include "crypto/blake3.h"
+
+namespace crypto {
+
+/**
+ * @struct Sha256Policy
+ * @brief SHA-256 chain hashing (default)
+ */
+struct Sha256Policy {
+    using Hasher = SHA256;
+    static constexpr const char* NAME = "SHA-256";
+};
+
+/**
+ * @struct Blake3Policy
+ * @brief BLAKE3 chain hashing
+ */
+struct Blake3Policy {
+    using Hasher = Blake3;
+    static constexpr const char* NAME = "BLAKE3";
+};
+
+/**
+ * @brief Hash policy used for block, transaction and Merkle hashes
+ *
+ * A policy names a Hasher class offering the SHA256 interface: a 32-byte
+ * Digest, static digest() and hashBatch(), streaming update()/finalize()
+ * and hashSuffixBatch() from a midstate. Build with
+ * -DBLOCKCHAIN_HASH=BLAKE3 (which defines BLOCKCHAIN_HASH_BLAKE3) to run
+ * a BLAKE3 chain; the two produce incompatible chains.
+ */
+#ifdef BLOCKCHAIN_HASH_BLAKE3
+using ChainHash = Blake3Policy;
+#else
+using ChainHash = Sha256Policy;
+#endif
+
+/// Hasher of the active chain hash policy
+using ChainHasher = ChainHash::Hasher;
+
+static_assert(ChainHasher::DIGEST_SIZE == 32, "Chain hashes must be 32 bytes");
+
+} // namespace crypto
+
+#endif // HASH_POLICY_H
@@ -0,0 +1,68 @@
+/**
+ * @file hex.h
+ * @brief Table-driven hexadecimal encoding and decoding
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef HEX_H
+#define HEX_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace crypto {
+
+/**
+ * @brief Encode bytes as lowercase hex into a caller-provided buffer
+ * @param data Bytes to encode
+ * @param length Number of bytes
+ * @param out Output buffer of at least 2 * length characters (not terminated)
+ */
+void toHex(const uint8_t* data, size_t length, char* out);
+
+/**
+ * @brief Encode bytes as a lowercase hex string
+ * @param data Bytes to encode
+ * @param length Number of bytes
+ * @return Hex string of 2 * length characters
+ */
+std::string toHex(const uint8_t* data, size_t length);
+
+/**
+ * @brief Encode a fixed-size byte array as a lowercase hex string
+ * @param bytes Bytes to encode
+ * @return Hex string of 2 * N characters
+ */
+template <size_t N>
+inline std::string toHex(const std::array<uint8_t, N>& bytes) {
+    return toHex(bytes.data(), N);
+}
+
+/**
+ * @brief Decode a hex string (either case) into bytes
+ * @param hex Hex characters
+ * @param hexLength Number of characters (must be 2 * length)
+ * @param out Output buffer
+ * @param length Number of bytes to decode
+ * @return false if the length or any character is invalid
+ */
+bool fromHex(const char* hex, size_t hexLength, uint8_t* out, size_t length);
+
+/**
+ * @brief Count leading '0' characters of the hex encoding of bytes
+ * 
+ * Equivalent to counting zeros at the front of toHex(data, length)
+ * without building the string; used for difficulty checks on digests.
+ * 
+ * @param data Bytes to inspect
+ * @param length Number of bytes
+ * @return Number of leading zero nibbles
+ */
+int leadingZeroHexDigits(const uint8_t* data, size_t length);
+
+} // namespace crypto
+
+#endif // HEX_H
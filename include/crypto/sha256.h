@@ -11,13 +11,34 @@
 #ifndef SHA256_H
 #define SHA256_H
 
+#include <array>
 #include <string>
+#include <vector>
 #include <cstdint>
-#include <sstream>
-#include <iomanip>
+#include <cstddef>
 
 namespace crypto {
 
+/**
+ * @enum HashBackend
+ * @brief Single-stream compression function behind every SHA256 call
+ */
+enum class HashBackend {
+    SCALAR,  ///< Portable C++ implementation
+    SHA_NI   ///< Intel SHA extensions
+};
+
+/**
+ * @enum BatchKernel
+ * @brief Compression kernel used by SHA256::hashBatch
+ */
+enum class BatchKernel {
+    SCALAR,  ///< One message at a time through the active HashBackend
+    SSE2,    ///< 4 lanes, SSE2
+    AVX2,    ///< 8 lanes, AVX2
+    AVX512   ///< 16 lanes, AVX-512F
+};
+
 /**
  * @class SHA256
  * @brief Implements the SHA-256 cryptographic hash function
@@ -30,29 +51,13 @@ namespace crypto {
  */
 class SHA256 {
 private:
-    // SHA-256 constants (first 32 bits of fractional parts of cube roots of first 64 primes)
-    static constexpr uint32_t K[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-        0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-        0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-        0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-        0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-        0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
-    
     // SHA-256 initial hash values (first 32 bits of fractional parts of square roots of first 8 primes)
     uint32_t h[8];
     
+    uint8_t buffer[64];      ///< Pending partial block
+    size_t bufferLength;     ///< Bytes used in buffer
+    uint64_t totalLength;    ///< Total bytes fed to update()
+    
     // Right rotate
     static inline uint32_t rotr(uint32_t x, uint32_t n) {
         return (x >> n) | (x << (32 - n));
@@ -83,15 +88,37 @@ private:
         return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10);
     }
     
-    void transform(const uint8_t* data);
+    /**
+     * @brief Compress consecutive 64-byte blocks with the active backend
+     * @param state Eight working hash words
+     * @param data Message blocks
+     * @param blocks Number of blocks
+     */
+    static void compress(uint32_t state[8], const uint8_t* data, size_t blocks);
+    
+    /**
+     * @brief Portable compression function (SCALAR backend)
+     */
+    static void compressScalar(uint32_t state[8], const uint8_t* data, size_t blocks);
     
 public:
+    static constexpr size_t DIGEST_SIZE = 32;  ///< Digest length in bytes
+    static constexpr size_t BLOCK_SIZE = 64;   ///< Compression block length in bytes
+    
+    /// Binary SHA-256 digest
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+    
     /**
      * @brief Default constructor
      * Initializes the hash state with standard SHA-256 initial values
      */
     SHA256();
     
+    /**
+     * @brief Restore the initial state so the object can be reused
+     */
+    void reset();
+    
     /**
      * @brief Compute SHA-256 hash of input string
      * @param input The string to hash
@@ -99,18 +126,136 @@ public:
      */
     static std::string hash(const std::string& input);
     
+    /**
+     * @brief Compute the binary SHA-256 digest of a buffer
+     * @param data Pointer to data
+     * @param length Length of data
+     * @return 32-byte digest
+     */
+    static Digest digest(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Compute the binary SHA-256 digest of a string
+     * @param input The string to hash
+     * @return 32-byte digest
+     */
+    static Digest digest(const std::string& input);
+    
     /**
      * @brief Update hash with new data (for streaming)
+     * 
+     * Input may be split at any byte boundary; partial blocks are kept in
+     * an internal buffer until enough data arrives. No heap allocation.
+     * 
      * @param data Pointer to data
      * @param length Length of data
      */
     void update(const uint8_t* data, size_t length);
     
+    /**
+     * @brief Update hash with the bytes of a string
+     * @param data String data
+     */
+    void update(const std::string& data);
+    
     /**
      * @brief Finalize hash computation
-     * @return 64-character hexadecimal hash string
+     * 
+     * Applies the FIPS 180-4 padding. Call reset() before reusing the
+     * object for another message.
+     * 
+     * @return 32-byte digest
+     */
+    Digest finalize();
+    
+    /**
+     * @brief Hash many independent messages in one call
+     * 
+     * Messages are interleaved across the lanes of the active batch
+     * kernel; a lane that finishes its message immediately picks up the
+     * next one, so mixed lengths keep every lane busy.
+     * 
+     * @param messages Pointers to the message bytes
+     * @param lengths Length of each message in bytes
+     * @param count Number of messages
+     * @param digests Output buffer of count * 32 bytes
+     */
+    static void hashBatch(const uint8_t* const* messages, const size_t* lengths,
+                          size_t count, uint8_t* digests);
+    
+    /**
+     * @brief Hash many messages that continue the data absorbed so far
+     * 
+     * Each digest equals copying this object, feeding the suffix and
+     * calling finalize(), but the shared prefix is never re-compressed:
+     * every lane starts from this object's midstate. Used by nonce
+     * search, where only the final block changes between attempts.
+     * 
+     * @param suffixes Pointers to the bytes following the prefix
+     * @param lengths Length of each suffix in bytes
+     * @param count Number of messages
+     * @param digests Output buffer of count * 32 bytes
+     */
+    void hashSuffixBatch(const uint8_t* const* suffixes, const size_t* lengths,
+                         size_t count, uint8_t* digests) const;
+    
+    /**
+     * @brief Hash many independent strings in one call
+     * @param inputs Strings to hash
+     * @return 64-character hexadecimal hash for each input, in order
+     */
+    static std::vector<std::string> hashBatch(const std::vector<std::string>& inputs);
+    
+    /**
+     * @brief Get the kernel currently used by hashBatch
+     * @return Active kernel (fastest supported one unless overridden)
+     */
+    static BatchKernel getBatchKernel();
+    
+    /**
+     * @brief Override the batch kernel (e.g. to compare against SCALAR)
+     * @param kernel Kernel to use
+     * @return false if the CPU does not support the kernel
+     */
+    static bool setBatchKernel(BatchKernel kernel);
+    
+    /**
+     * @brief Check whether a batch kernel can run on this CPU
+     * @param kernel Kernel to check
+     * @return true if supported
+     */
+    static bool isBatchKernelSupported(BatchKernel kernel);
+    
+    /**
+     * @brief Number of messages the active kernel hashes per pass
+     * @return Lane count (1 for SCALAR)
+     */
+    static size_t getBatchLanes();
+    
+    /**
+     * @brief Get the single-stream backend
+     * 
+     * Chosen at startup from CPUID (SHA_NI when available). Setting the
+     * environment variable CRYPTO_SHA256_BACKEND=scalar forces the
+     * portable path.
+     * 
+     * @return Active backend
+     */
+    static HashBackend getBackend();
+    
+    /**
+     * @brief Override the single-stream backend (e.g. for testing)
+     * @param backend Backend to use
+     * @return false if the CPU does not support the backend
+     */
+    static bool setBackend(HashBackend backend);
+    
+    /**
+     * @brief Check whether a backend can run on this CPU
+     * @param backend Backend to check
+     * @return true if supported
      */
-    std::string finalize();
+    static bool isBackendSupported(HashBackend backend);
 };
 
 /**
@@ -0,0 +1,88 @@
+/**
+ * @file sha512.h
+ * @brief SHA-512 Cryptographic Hash Function Implementation
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * FIPS 180-4 SHA-512, used by Ed25519 for key expansion, nonces and
+ * challenges. Chain hashing goes through crypto/hash_policy.h instead.
+ */
+
+#ifndef SHA512_H
+#define SHA512_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace crypto {
+
+/**
+ * @class SHA512
+ * @brief Implements the SHA-512 cryptographic hash function
+ */
+class SHA512 {
+private:
+    uint64_t h[8];           ///< Chaining state
+    uint8_t buffer[128];     ///< Pending partial block
+    size_t bufferLength;     ///< Bytes used in buffer
+    uint64_t totalLength;    ///< Total bytes fed to update() (inputs below 2^64 bytes)
+
+    /**
+     * @brief Compress whole 128-byte blocks into the state
+     */
+    static void compress(uint64_t state[8], const uint8_t* data, size_t blocks);
+
+public:
+    static constexpr size_t DIGEST_SIZE = 64;   ///< Digest length in bytes
+    static constexpr size_t BLOCK_SIZE = 128;   ///< Compression block length in bytes
+
+    /// Binary SHA-512 digest
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    /**
+     * @brief Default constructor
+     */
+    SHA512();
+
+    /**
+     * @brief Restore the initial state so the object can be reused
+     */
+    void reset();
+
+    /**
+     * @brief Update hash with new data (for streaming)
+     * @param data Pointer to data
+     * @param length Length of data
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Finalize hash computation
+     *
+     * Does not modify the state; more data may be added afterwards.
+     *
+     * @return 64-byte digest
+     */
+    Digest finalize() const;
+
+    /**
+     * @brief Compute the binary SHA-512 digest of a buffer
+     * @param data Pointer to data
+     * @param length Length of data
+     * @return 64-byte digest
+     */
+    static Digest digest(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Compute SHA-512 hash of input string
+     * @param input The string to hash
+     * @return 128-character hexadecimal hash string
+     */
+    static std::string hash(const std::string& input);
+};
+
+} // namespace crypto
+
+#endif // SHA512_H
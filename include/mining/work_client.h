@@ -0,0 +1,71 @@
+/**
+ * @file work_client.h
+ * @brief Miner-side connection to a WorkServer
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef WORK_CLIENT_H
+#define WORK_CLIENT_H
+
+#include "mining/work_protocol.h"
+#include <string>
+
+namespace blockchain {
+namespace mining {
+
+/**
+ * @class WorkClient
+ * @brief Blocking request/response client for the get-work protocol
+ */
+class WorkClient {
+private:
+    int fd;  ///< Connected socket (-1 if closed)
+
+    /**
+     * @brief Send a request and wait for the expected reply
+     */
+    bool exchange(MessageType request, const uint8_t* payload, size_t length,
+                  MessageType reply, uint8_t* replyPayload, size_t replyLength);
+
+public:
+    WorkClient();
+    ~WorkClient();
+
+    WorkClient(const WorkClient&) = delete;
+    WorkClient& operator=(const WorkClient&) = delete;
+
+    /**
+     * @brief Connect to a server
+     * @param socketPath Filesystem path of the server socket
+     * @return false if the server is not reachable
+     */
+    bool connect(const std::string& socketPath);
+
+    /**
+     * @brief Close the connection
+     */
+    void close();
+
+    /**
+     * @brief Ask for a header template and nonce range
+     * @param work Output: assigned work
+     * @return false if the connection failed
+     */
+    bool getWork(WorkUnit& work);
+
+    /**
+     * @brief Submit a nonce for a job
+     * @param submission Job and nonce
+     * @param status Output: server verdict
+     * @return false if the connection failed
+     */
+    bool submit(const Submission& submission, SubmitStatus& status);
+
+    bool isConnected() const { return fd >= 0; }
+};
+
+} // namespace mining
+} // namespace blockchain
+
+#endif // WORK_CLIENT_H
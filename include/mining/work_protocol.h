@@ -0,0 +1,96 @@
+/**
+ * @file work_protocol.h
+ * @brief Wire format shared by the get-work server and miner clients
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef WORK_PROTOCOL_H
+#define WORK_PROTOCOL_H
+
+#include "core/block_header.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace blockchain {
+namespace mining {
+
+/// Socket used when none is given on the command line
+constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/blockchain-work.sock";
+
+/**
+ * @enum MessageType
+ * @brief First byte of every message
+ *
+ * Each type has a fixed payload size (payloadSize()), so a message is
+ * complete as soon as that many bytes follow the type byte.
+ */
+enum class MessageType : uint8_t {
+    GET_WORK = 1,      ///< Client → server, no payload
+    WORK = 2,          ///< Server → client, WorkUnit
+    SUBMIT = 3,        ///< Client → server, Submission
+    SUBMIT_RESULT = 4  ///< Server → client, one SubmitStatus byte
+};
+
+/**
+ * @enum SubmitStatus
+ * @brief Server verdict on a submitted nonce
+ */
+enum class SubmitStatus : uint8_t {
+    ACCEPTED = 0,  ///< Block appended to the chain
+    STALE = 1,     ///< Job unknown or built on an old tip
+    INVALID = 2    ///< Nonce outside the range or block rejected
+};
+
+/**
+ * @struct WorkUnit
+ * @brief Header template plus the nonces a miner should try
+ *
+ * Layout (little-endian): jobId (4), header (BlockHeader::SIZE),
+ * nonceStart (4), nonceCount (4).
+ */
+struct WorkUnit {
+    static constexpr size_t SIZE = 4 + BlockHeader::SIZE + 8;
+
+    uint32_t jobId = 0;       ///< Identifies the template on the server
+    BlockHeader header;       ///< Template with nonce 0 and target in bits
+    uint32_t nonceStart = 0;  ///< First nonce of the range
+    uint32_t nonceCount = 0;  ///< Number of nonces in the range
+
+    void encode(uint8_t* out) const;
+    static WorkUnit decode(const uint8_t* in);
+};
+
+/**
+ * @struct Submission
+ * @brief Nonce claimed to solve a job
+ *
+ * Layout (little-endian): jobId (4), nonce (4).
+ */
+struct Submission {
+    static constexpr size_t SIZE = 8;
+
+    uint32_t jobId = 0;
+    uint32_t nonce = 0;
+
+    void encode(uint8_t* out) const;
+    static Submission decode(const uint8_t* in);
+};
+
+/**
+ * @brief Payload bytes that follow a type byte
+ * @param type Message type
+ * @param size Output: payload size
+ * @return false for an unknown type
+ */
+bool payloadSize(uint8_t type, size_t& size);
+
+/**
+ * @brief Human-readable name of a submit status
+ */
+const char* toString(SubmitStatus status);
+
+} // namespace mining
+} // namespace blockchain
+
+#endif // WORK_PROTOCOL_H
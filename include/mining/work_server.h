@@ -0,0 +1,145 @@
+/**
+ * @file work_server.h
+ * @brief Get-work server that lets external processes mine for a chain
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef WORK_SERVER_H
+#define WORK_SERVER_H
+
+#include "core/blockchain.h"
+#include "mining/work_protocol.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace blockchain {
+namespace mining {
+
+/**
+ * @class WorkServer
+ * @brief Hands out header templates and nonce ranges on a Unix socket
+ *
+ * Miners send GET_WORK and receive a WorkUnit: a block header template
+ * and a nonce range no other miner was given. A SUBMIT naming the job
+ * and a nonce is checked against the stored template and appended with
+ * Blockchain::submitBlock(), which runs Block::isValid().
+ *
+ * Templates are rebuilt when the tip changes (older jobs become STALE)
+ * or when the nonce space of the current one runs out (a fresh
+ * timestamp gives a fresh header). Everything runs on the thread that
+ * calls poll()/run(), so the Blockchain needs no locking as long as it
+ * is not used elsewhere at the same time.
+ */
+class WorkServer {
+public:
+    /// Supplies the transactions of each new template
+    using TransactionSource = std::function<std::vector<Transaction>()>;
+
+    static constexpr uint32_t DEFAULT_NONCE_RANGE = 1u << 22;  ///< Nonces per WorkUnit
+    static constexpr size_t MAX_JOBS = 16;                     ///< Templates kept per tip
+
+    /**
+     * @brief Construct a server for a chain (not yet listening)
+     * @param chain Chain to extend
+     * @param socketPath Filesystem path of the Unix socket
+     * @param source Transactions for each template
+     * @param nonceRange Nonces handed out per request
+     */
+    WorkServer(Blockchain& chain, const std::string& socketPath, TransactionSource source,
+               uint32_t nonceRange = DEFAULT_NONCE_RANGE);
+
+    ~WorkServer();
+
+    WorkServer(const WorkServer&) = delete;
+    WorkServer& operator=(const WorkServer&) = delete;
+
+    /**
+     * @brief Bind and listen (replaces a stale socket file)
+     * @return false if the socket could not be created
+     */
+    bool start();
+
+    /**
+     * @brief Wait for socket activity and serve complete requests
+     * @param timeoutMs Maximum wait (-1 = until activity)
+     */
+    void poll(int timeoutMs);
+
+    /**
+     * @brief Serve until stop is set (checked at least every 100 ms)
+     * @param stop Stop flag
+     */
+    void run(const std::atomic<bool>& stop);
+
+    /**
+     * @brief Close every connection and remove the socket file
+     */
+    void shutdown();
+
+    // Getters
+    const std::string& getSocketPath() const { return socketPath; }
+    size_t getClientCount() const { return clients.size(); }
+    size_t getBlocksAccepted() const { return blocksAccepted; }
+    size_t getSubmissionsRejected() const { return submissionsRejected; }
+
+private:
+    /**
+     * @struct Job
+     * @brief Template block and the next nonce to hand out for it
+     */
+    struct Job {
+        Block block;
+        uint64_t nextNonce = 0;
+    };
+
+    /**
+     * @struct Client
+     * @brief Connected miner and its partially received bytes
+     */
+    struct Client {
+        int fd;
+        std::vector<uint8_t> inbox;
+    };
+
+    Blockchain& chain;
+    std::string socketPath;
+    TransactionSource source;
+    uint32_t nonceRange;
+    int listenFd;
+    std::vector<Client> clients;
+    std::map<uint32_t, Job> jobs;   ///< Templates on the current tip, by id
+    uint32_t nextJobId;
+    size_t jobsTip;                  ///< Chain length the jobs were built for
+    size_t blocksAccepted;
+    size_t submissionsRejected;
+
+    /**
+     * @brief Accept every pending connection
+     */
+    void acceptClients();
+
+    /**
+     * @brief Read from a client and answer its complete requests
+     * @return false if the client disconnected or misbehaved
+     */
+    bool serviceClient(Client& client);
+
+    /**
+     * @brief Next nonce range, building a new template if needed
+     */
+    WorkUnit assignWork();
+
+    /**
+     * @brief Validate a submission and append its block
+     */
+    SubmitStatus acceptSubmission(const Submission& submission);
+};
+
+} // namespace mining
+} // namespace blockchain
+
+#endif // WORK_SERVER_H
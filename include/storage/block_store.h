@@ -0,0 +1,157 @@
+/**
+ * @file block_store.h
+ * @brief Append-only segmented block files with a memory-mapped index
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef BLOCK_STORE_H
+#define BLOCK_STORE_H
+
+#include "core/block.h"
+#include "core/block_view.h"
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+namespace storage {
+
+/**
+ * @class BlockStore
+ * @brief Persists blocks by height and serves them from mapped pages
+ *
+ * A store is a directory holding:
+ * - blocks-NNNNN.dat: segment files of encoded blocks (Block::encode)
+ *   written back to back; a new segment starts once the current one
+ *   would exceed the segment size.
+ * - index.dat: a 64-byte header and one 48-byte entry per height
+ *   (block hash, segment, length, offset), memory-mapped read-write.
+ * - hashes.idx: an open-addressing table from block hash to height,
+ *   also memory-mapped, so findHeight() touches a few pages at most.
+ *
+ * Segments are mapped read-only and never moved, so the BlockView that
+ * get() returns reads the block straight from the page cache and stays
+ * valid until the store is closed. Nothing is copied to the heap unless
+ * the caller materialises the view.
+ *
+ * Each append writes the block, then its index entry, then bumps the
+ * count in the index header; open() ignores anything past that count
+ * and truncates the segment tail left by an interrupted append. Data is
+ * handed to the OS on every append; sync() forces it to disk. A segment
+ * is synced when it fills up and the next one is created (along with the
+ * directory entry), so sync() only has the tail left to flush.
+ *
+ * Single writer. Readers (get(), getHash(), findHeight()) may run
+ * concurrently with each other, but not with append() or close().
+ */
+class BlockStore {
+public:
+    static constexpr uint64_t DEFAULT_SEGMENT_SIZE = uint64_t(64) << 20;    ///< Bytes per segment file
+
+    /**
+     * @brief Construct a closed store
+     * @param segmentSize Target segment file size (blocks larger than
+     *        this get a segment of their own)
+     */
+    explicit BlockStore(uint64_t segmentSize = DEFAULT_SEGMENT_SIZE);
+
+    ~BlockStore();
+
+    /**
+     * @brief Open a store, creating the directory and files if needed
+     * @param directory Store directory
+     * @return false if the files could not be created or are corrupt
+     */
+    bool open(const std::string& directory);
+
+    /**
+     * @brief Unmap and close every file (views from get() become invalid)
+     */
+    void close();
+
+    /**
+     * @brief Append the block at height size()
+     * @param block Block whose index equals size()
+     * @return false on an index mismatch or an I/O error
+     */
+    bool append(const Block& block);
+
+    /**
+     * @brief View a stored block in place
+     * @param height Block height
+     * @param view Output: view into the mapped segment
+     * @return false if height >= size() or the record is damaged
+     */
+    bool get(size_t height, BlockView& view) const;
+
+    /**
+     * @brief Hash of a stored block, from the index alone
+     * @param height Block height
+     * @param hash Output: block hash
+     * @return false if height >= size()
+     */
+    bool getHash(size_t height, crypto::Hash256& hash) const;
+
+    /**
+     * @brief Find the height of a stored block
+     * @param hash Block hash
+     * @param height Output: its height
+     * @return false if no stored block has this hash
+     */
+    bool findHeight(const crypto::Hash256& hash, size_t& height) const;
+
+    /**
+     * @brief Flush segments and the index to disk
+     * @return false on an I/O error
+     */
+    bool sync();
+
+    // Getters
+    bool isOpen() const { return indexFd >= 0; }
+    size_t size() const;
+    const std::string& getDirectory() const { return directory; }
+    uint64_t getSegmentSize() const { return segmentSize; }
+    size_t getSegmentCount() const { return segments.size(); }
+
+    BlockStore(const BlockStore&) = delete;
+    BlockStore& operator=(const BlockStore&) = delete;
+
+private:
+    /// A read-only mapping of one segment file
+    struct Segment {
+        const uint8_t* data = nullptr;
+        size_t mappedLength = 0;
+    };
+
+    std::string directory;
+    uint64_t segmentSize;
+    int indexFd = -1;
+    uint8_t* index = nullptr;               ///< Mapped index.dat
+    size_t indexCapacity = 0;               ///< Entries the mapping can hold
+    int hashFd = -1;
+    uint8_t* hashes = nullptr;              ///< Mapped hashes.idx
+    size_t hashSlots = 0;                   ///< Slots in the hash table (power of two)
+    int tailFd = -1;                        ///< Last segment, open for appending
+    uint64_t tailSize = 0;                  ///< Bytes used in the last segment
+    mutable std::vector<Segment> segments;  ///< Mapped on first read
+    mutable std::mutex mappingMutex;         ///< Guards lazy mapping by concurrent readers
+
+    std::string segmentPath(size_t segment) const;
+    bool openIndex();
+    bool openHashes();
+    bool openSegments();
+    bool growIndex(size_t entries);
+    bool rebuildHashes(size_t slots);
+    void insertHash(const crypto::Hash256& hash, size_t height);
+    bool startSegment();
+    const Segment* mapSegment(size_t segment) const;
+    void setCount(size_t count);
+};
+
+} // namespace storage
+} // namespace blockchain
+
+#endif // BLOCK_STORE_H
@@ -0,0 +1,219 @@
+/**
+ * @file journal.h
+ * @brief Write-ahead journal with group-commit fsync
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "core/amount.h"
+#include "core/block.h"
+#include "core/transaction.h"
+#include "core/transaction_view.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+namespace storage {
+
+/**
+ * @enum RecordType
+ * @brief Kind of journal record
+ */
+enum class RecordType : uint8_t {
+    BLOCK = 1,          ///< Accepted block (Block::encode)
+    TRANSACTION = 2     ///< Pending transaction: fee (8 bytes) + Transaction::encode
+};
+
+/**
+ * @class Journal
+ * @brief Durable, append-only log of accepted blocks and pending transactions
+ *
+ * The file starts with an 8-byte magic, followed by records:
+ *
+ * | Offset | Size | Field                                    |
+ * |--------|------|------------------------------------------|
+ * | 0      | 4    | payload length n                         |
+ * | 4      | 4    | CRC-32C of length, type and payload      |
+ * | 8      | 1    | type (RecordType)                        |
+ * | 9      | n    | payload                                  |
+ *
+ * Appends from any number of threads are queued; one flusher thread
+ * writes everything queued with a single write() and fdatasync() (group
+ * commit). A batch is flushed once it reaches maxBatchBytes or its first
+ * record has waited maxDelay, so no append waits much longer than
+ * maxDelay plus one fsync, however many callers share the batch.
+ *
+ * A crash can leave a partial record at the end of the file. open()
+ * walks the records, stops at the first one that is truncated or fails
+ * its checksum and cuts the file there, so replay() only ever sees
+ * complete records in append order.
+ */
+class Journal {
+public:
+    static constexpr std::chrono::microseconds DEFAULT_MAX_DELAY{2000};    ///< Default latency bound
+    static constexpr size_t DEFAULT_MAX_BATCH_BYTES = size_t(4) << 20;      ///< Flush early past this
+    static constexpr size_t MAX_RECORD_SIZE = size_t(256) << 20;            ///< Larger payloads are corrupt
+    static constexpr size_t RECORD_HEADER_SIZE = 9;                         ///< Length, checksum, type
+
+    /// Callback for replay(); return false to stop early
+    using Handler = std::function<bool(RecordType type, const uint8_t* payload, size_t length)>;
+
+    /**
+     * @brief Construct a closed journal
+     * @param maxDelay Longest a queued record waits before its batch is flushed
+     * @param maxBatchBytes Queued bytes that trigger a flush without waiting
+     */
+    explicit Journal(std::chrono::microseconds maxDelay = DEFAULT_MAX_DELAY,
+                     size_t maxBatchBytes = DEFAULT_MAX_BATCH_BYTES);
+
+    ~Journal();
+
+    /**
+     * @brief Open or create a journal file and start the flusher
+     *
+     * A torn tail left by a crash is cut off.
+     *
+     * @param path Journal file
+     * @return false if the file cannot be opened or is not a journal
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Flush what is queued, stop the flusher and close the file
+     */
+    void close();
+
+    /**
+     * @brief Visit every durable record in append order
+     *
+     * Intended for recovery right after open(), before new appends.
+     *
+     * @param handler Called for each record
+     * @return false if the file could not be read or handler stopped early
+     */
+    bool replay(const Handler& handler) const;
+
+    /**
+     * @brief Queue a record without waiting for it to reach disk
+     * @return Sequence number for waitDurable(), or 0 if the journal is
+     *         closed, failed, or the payload is too large
+     */
+    uint64_t appendAsync(RecordType type, const uint8_t* payload, size_t length);
+
+    /**
+     * @brief Wait until a record and everything before it are on disk
+     * @param sequence Value returned by appendAsync()
+     * @return false if writing or syncing the journal failed
+     */
+    bool waitDurable(uint64_t sequence);
+
+    /**
+     * @brief Append a record and wait until it is durable
+     * @return false if the record could not be made durable
+     */
+    bool append(RecordType type, const uint8_t* payload, size_t length);
+
+    /**
+     * @brief Durably record an accepted block
+     */
+    bool appendBlock(const Block& block);
+
+    /**
+     * @brief Durably record a pending transaction with its pool fee
+     */
+    bool appendTransaction(const Transaction& tx, Amount fee);
+
+    /**
+     * @brief Encode the payload of a TRANSACTION record
+     *
+     * For callers that queue it with appendAsync() under their own lock.
+     */
+    static std::vector<uint8_t> encodeTransaction(const Transaction& tx, Amount fee);
+
+    /**
+     * @brief Parse the payload of a TRANSACTION record
+     * @param payload Record payload from replay()
+     * @param length Payload length
+     * @param view Output: the transaction, pointing into payload
+     * @param fee Output: its pool fee
+     * @return false if the payload is malformed
+     */
+    static bool decodeTransaction(const uint8_t* payload, size_t length, TransactionView& view, Amount& fee);
+
+    /**
+     * @brief Drop every record once their contents are persisted elsewhere
+     *
+     * Waits for queued records first, e.g. after BlockStore::sync().
+     *
+     * @return false on an I/O error
+     */
+    bool truncate();
+
+    /**
+     * @brief Drop every record except some pending transactions and a tail
+     *
+     * Used by a checkpoint: the blocks are persisted elsewhere, but the
+     * transactions still pending must survive. The new journal holds the
+     * given TRANSACTION records followed by every record made durable
+     * since mark. It is written beside the journal, synced and renamed
+     * over it, so a crash leaves either the old or the new file.
+     *
+     * @param transactions encodeTransaction() payloads to keep
+     * @param mark getSize() read before the transactions were gathered
+     * @return false on an I/O error or if mark is not a record boundary
+     *         this journal has reached
+     */
+    bool compact(const std::vector<std::vector<uint8_t>>& transactions, uint64_t mark);
+
+    // Getters
+    bool isOpen() const { return fd >= 0; }
+    const std::string& getPath() const { return path; }
+    uint64_t getRecords() const { return records.load(std::memory_order_relaxed); }
+    uint64_t getBatches() const { return batches.load(std::memory_order_relaxed); }
+    uint64_t getSize() const { return fileSize.load(std::memory_order_relaxed); }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+private:
+    std::string path;
+    std::chrono::microseconds maxDelay;
+    size_t maxBatchBytes;
+    int fd = -1;
+
+    std::mutex mutex;
+    std::condition_variable queued;         ///< Signals the flusher
+    std::condition_variable flushed;        ///< Signals waiters in waitDurable()
+    std::vector<uint8_t> pending;           ///< Encoded records not yet written
+    std::chrono::steady_clock::time_point pendingSince;  ///< Arrival of the oldest pending record
+    uint64_t appended = 0;                  ///< Sequence of the last queued record
+    uint64_t durable = 0;                   ///< Sequence of the last synced record
+    bool failed = false;                    ///< A write or sync failed; nothing is durable after it
+    bool stopping = false;
+    std::thread flusher;
+
+    std::atomic<uint64_t> records;
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> fileSize;
+
+    /**
+     * @brief Flusher thread: write and sync queued records in batches
+     */
+    void flushLoop();
+};
+
+} // namespace storage
+} // namespace blockchain
+
+#endif // JOURNAL_H
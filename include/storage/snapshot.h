@@ -0,0 +1,90 @@
+/**
+ * @file snapshot.h
+ * @brief Point-in-time image of the chain state for fast startup
+ * @author Blockchain Project
+ * @date 2025
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "core/block.h"
+#include "core/block_header.h"
+#include "consensus/proof_of_stake.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace blockchain {
+namespace storage {
+
+/**
+ * @struct SnapshotHeader
+ * @brief Header of a block whose body is not part of the snapshot
+ */
+struct SnapshotHeader {
+    BlockHeader header;                                 ///< Hashed block header
+    ConsensusType consensusType = ConsensusType::NONE;  ///< How the block was produced
+};
+
+/**
+ * @struct ChainSnapshot
+ * @brief Everything a Blockchain needs to resume at a given tip
+ *
+ * Holds the header of every block, the newest blocks in full, the
+ * validator set, the PoW settings and the replay filter, so a node can
+ * restart without re-adding (and re-hashing) its whole history. For the
+ * older blocks the replay filter still covers, the exact transaction IDs
+ * are kept too, so a filter match there can be confirmed without bodies.
+ *
+ * The file is an 8-byte magic, the body length (8 bytes), the chain
+ * hash of the body (32 bytes) and the body:
+ *
+ * | Field             | Encoding                                        |
+ * |-------------------|-------------------------------------------------|
+ * | headers           | count (8), then per block header (116) + type (1) |
+ * | blocks            | count (4), then per block length (4) + Block::encode |
+ * | validators        | count (4), then per validator name length (2) + name + stake (8) |
+ * | PoW settings      | bits (4), retarget interval (4), block time (8) |
+ * | requireSignatures | 1 byte                                          |
+ * | confirmed IDs     | first height (8), block count (8), then per block ID count (4) + IDs (32 each) |
+ * | replay filter     | length (8) + ReplayFilter::encode               |
+ *
+ * Integers are little-endian. save() writes a temporary file, syncs it
+ * and renames it over the target, so a crash leaves either the old
+ * snapshot or the new one.
+ */
+struct ChainSnapshot {
+    std::vector<SnapshotHeader> headers;            ///< Every block, genesis first
+    std::vector<Block> blocks;                      ///< Newest blocks in full, ending at the tip
+    std::vector<consensus::Validator> validators;   ///< Registered PoS validators
+    uint32_t bits = 0;                              ///< Current compact PoW target
+    int retargetInterval = 0;                       ///< Blocks between retargets
+    int64_t targetBlockTime = 0;                    ///< Desired seconds between blocks
+    bool requireSignatures = false;                 ///< Reject unsigned transactions
+    size_t confirmedBase = 0;                       ///< Height of confirmed.front()
+    std::vector<std::vector<crypto::Hash256>> confirmed;  ///< Transaction IDs per filter-covered block without a body
+    std::vector<uint8_t> replayFilter;              ///< ReplayFilter::encode() output
+
+    /**
+     * @brief Write the snapshot atomically
+     * @param path Target file
+     * @return false on an I/O error or if a block cannot be encoded
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Read and verify a snapshot written by save()
+     * @param path Snapshot file
+     * @return false if the file is missing, not a snapshot, corrupt or
+     *         internally inconsistent (blocks not matching the headers, or
+ *         confirmed IDs for blocks it holds in full)
+     */
+    bool load(const std::string& path);
+};
+
+} // namespace storage
+} // namespace blockchain
+
+#endif // SNAPSHOT_H
@@ -75,7 +75,7 @@ std::string ProofOfStake::selectValidator() {
     return validators[0].name;
 }
 
-bool ProofOfStake::validateBlock(const std::string& validatorName) {
+bool ProofOfStake::validateBlock(const std::string& validatorName) const {
     // Check if validator exists
     for (const auto& v : validators) {
         if (v.name == validatorName) {
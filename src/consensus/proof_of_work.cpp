@@ -4,57 +4,250 @@
  */
 
 #include "consensus/proof_of_work.h"
-#include "crypto/sha256.h"
+#include "crypto/hash256.h"
+#include "crypto/hex.h"
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace blockchain {
 namespace consensus {
 
 ProofOfWork::ProofOfWork(int difficulty) 
-    : difficulty(difficulty), miningTime(0) {
-    target = std::string(difficulty, '0');
+    : difficulty(difficulty), bits(0), retargetInterval(RETARGET_INTERVAL),
+      targetBlockTime(TARGET_BLOCK_TIME), miningTime(0) {
+    setBits(Target::fromDifficulty(difficulty).toCompact());
 }
 
 std::string ProofOfWork::mine(const std::string& data, int& nonce) {
-    std::string hash;
-    nonce = 0;
+    crypto::ChainHasher prefix;
+    prefix.update(data);
+    
+    MiningResult result = searchNonce(prefix, "", 0, target, 1, nullptr, NonceFormat::DECIMAL,
+                                      std::numeric_limits<int>::max() - 1);
+    miningTime = result.timeMs;
+    if (!result.found) {
+        // A zero digest would look like a result; report the exhausted range instead
+        return std::string();
+    }
+    nonce = static_cast<int>(result.nonce) + 1;
+    return crypto::toHex(result.digest);
+}
+
+namespace {
+
+constexpr int BATCH = 16;
+
+/**
+ * @brief State shared by the workers of one search
+ */
+struct SearchState {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> hashes{0};
+    std::mutex mutex;
+    MiningResult best;
+};
+
+/**
+ * @brief Search chunks worker, worker + workers, worker + 2 * workers, ...
+ * 
+ * Chunk k covers nonces startNonce + k * BATCH .. + BATCH - 1. Offsets
+ * are counted from startNonce so the loop cannot overflow at the top of
+ * the nonce space.
+ */
+void searchWorker(const crypto::ChainHasher& prefix, const std::string& suffix, uint64_t startNonce,
+                  const Target& target, unsigned worker, unsigned workers,
+                  const std::atomic<bool>* cancel, NonceFormat format, uint64_t lastNonce,
+                  SearchState& state) {
+    std::string candidates[BATCH];
+    const uint8_t* messages[BATCH];
+    size_t lengths[BATCH];
+    uint8_t digests[BATCH * crypto::ChainHasher::DIGEST_SIZE];
+    uint64_t hashes = 0;
+    
+    if (format == NonceFormat::UINT32_LE) {
+        lastNonce = std::min<uint64_t>(lastNonce, std::numeric_limits<uint32_t>::max());
+    }
+    if (startNonce > lastNonce) {
+        return;
+    }
+    const uint64_t span = lastNonce - startNonce;
+    const uint64_t stride = static_cast<uint64_t>(workers) * BATCH;
+    
+    for (uint64_t offset = static_cast<uint64_t>(worker) * BATCH; offset <= span; offset += stride) {
+        if (state.stop.load(std::memory_order_relaxed) ||
+            (cancel != nullptr && cancel->load(std::memory_order_relaxed))) {
+            break;
+        }
+        
+        const uint64_t base = startNonce + offset;
+        int count = static_cast<int>(std::min<uint64_t>(BATCH, span - offset + 1));
+        for (int i = 0; i < count; i++) {
+            char digits[24];
+            char* end = digits;
+            if (format == NonceFormat::DECIMAL) {
+                end = std::to_chars(digits, digits + sizeof(digits), base + i).ptr;
+            } else {
+                uint32_t value = static_cast<uint32_t>(base + i);
+                for (int b = 0; b < 4; b++) {
+                    *end++ = static_cast<char>(value >> (b * 8));
+                }
+            }
+            candidates[i].assign(digits, end);
+            candidates[i] += suffix;
+            messages[i] = reinterpret_cast<const uint8_t*>(candidates[i].data());
+            lengths[i] = candidates[i].size();
+        }
+        
+        prefix.hashSuffixBatch(messages, lengths, count, digests);
+        hashes += count;
+        
+        for (int i = 0; i < count; i++) {
+            const uint8_t* candidate = digests + i * crypto::ChainHasher::DIGEST_SIZE;
+            if (!target.isMetBy(candidate)) {
+                continue;
+            }
+            
+            std::lock_guard<std::mutex> lock(state.mutex);
+            uint64_t nonce = base + i;
+            if (!state.best.found || nonce < state.best.nonce) {
+                state.best.found = true;
+                state.best.nonce = nonce;
+                std::copy(candidate, candidate + crypto::ChainHasher::DIGEST_SIZE, state.best.digest.begin());
+            }
+            state.stop.store(true, std::memory_order_relaxed);
+            break;
+        }
+        
+        if (span - offset < stride) {
+            break;
+        }
+    }
+    
+    state.hashes.fetch_add(hashes, std::memory_order_relaxed);
+}
+
+} // namespace
+
+MiningResult ProofOfWork::searchNonce(const crypto::ChainHasher& prefix, const std::string& suffix,
+                                      uint64_t startNonce, const Target& target, unsigned threads,
+                                      const std::atomic<bool>* cancel, NonceFormat format,
+                                      uint64_t lastNonce) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
     
     auto start = std::chrono::high_resolution_clock::now();
     
-    // Keep incrementing nonce until we find a valid hash
-    do {
-        std::stringstream ss;
-        ss << data << nonce;
-        hash = crypto::sha256(ss.str());
-        nonce++;
-    } while (!validateHash(hash));
+    SearchState state;
+    if (threads == 1) {
+        searchWorker(prefix, suffix, startNonce, target, 0, 1, cancel, format, lastNonce, state);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back(searchWorker, std::cref(prefix), std::cref(suffix), startNonce,
+                                 std::cref(target), t, threads, cancel, format, lastNonce,
+                                 std::ref(state));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
-    miningTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
     
-    return hash;
+    MiningResult result = state.best;
+    result.hashes = state.hashes.load();
+    result.threads = threads;
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    return result;
 }
 
 bool ProofOfWork::validateHash(const std::string& hash) const {
-    return hash.substr(0, difficulty) == target;
+    crypto::Hash256 digest;
+    return crypto::Hash256::fromHex(hash, digest) && target.isMetBy(digest.data());
 }
 
 void ProofOfWork::setDifficulty(int newDifficulty) {
-    if (newDifficulty < 1 || newDifficulty > 8) {
-        std::cerr << "Warning: Difficulty should be between 1 and 8" << std::endl;
+    if (newDifficulty < 1 || newDifficulty > Target::MAX_DIFFICULTY) {
+        std::cerr << "Warning: Difficulty should be between 1 and "
+                  << Target::MAX_DIFFICULTY << std::endl;
+        return;
+    }
+    setBits(Target::fromDifficulty(newDifficulty).toCompact());
+}
+
+bool ProofOfWork::setBits(uint32_t newBits) {
+    Target decoded;
+    if (!Target::fromCompact(newBits, decoded) || decoded.isZero()) {
+        std::cerr << "Warning: Invalid compact target 0x" << std::hex << newBits
+                  << std::dec << std::endl;
+        return false;
+    }
+    bits = newBits;
+    target = decoded;
+    difficulty = target.leadingZeroHexDigits();
+    return true;
+}
+
+void ProofOfWork::setRetarget(int interval, int64_t blockTime) {
+    if (interval < 0 || blockTime <= 0) {
+        std::cerr << "Warning: Retarget interval must be >= 0 and block time > 0" << std::endl;
         return;
     }
-    difficulty = newDifficulty;
-    target = std::string(difficulty, '0');
+    retargetInterval = interval;
+    targetBlockTime = blockTime;
+}
+
+bool ProofOfWork::isRetargetHeight(size_t height) const {
+    return retargetInterval > 0 && height > 0 &&
+           height % static_cast<size_t>(retargetInterval) == 0;
+}
+
+uint32_t ProofOfWork::retarget(uint32_t previousBits, int64_t actualTimespan) const {
+    Target previous;
+    if (!Target::fromCompact(previousBits, previous) || previous.isZero()) {
+        return previousBits;
+    }
+    
+    // Timestamps are whole seconds, so keep both spans in a 32-bit range
+    const int64_t limit = std::numeric_limits<uint32_t>::max() / MAX_ADJUSTMENT;
+    const int64_t expected = std::clamp<int64_t>(retargetInterval * targetBlockTime, 1, limit);
+    const int64_t actual = std::clamp<int64_t>(actualTimespan, std::max<int64_t>(1, expected / MAX_ADJUSTMENT),
+                                               expected * MAX_ADJUSTMENT);
+    
+    Target next = previous.scaled(static_cast<uint32_t>(actual), static_cast<uint32_t>(expected));
+    const Target limitTarget = Target::fromDifficulty(1);
+    if (next > limitTarget) {
+        next = limitTarget;
+    }
+    if (next.isZero()) {
+        next = Target::fromDifficulty(Target::MAX_DIFFICULTY - 1);
+    }
+    return next.toCompact();
 }
 
 void ProofOfWork::displayStats() const {
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║      PROOF OF WORK STATISTICS          ║" << std::endl;
     std::cout << "╠════════════════════════════════════════╣" << std::endl;
-    std::cout << "║ Difficulty: " << difficulty << "                          ║" << std::endl;
-    std::cout << "║ Target: " << target << "...                     ║" << std::endl;
+    std::cout << "║ Difficulty: " << std::left << std::setw(27) << difficulty << "║" << std::endl;
+    std::cout << "║ Target: " << target.toHex().substr(0, 24) << "...    ║" << std::endl;
+    std::cout << "║ Compact Bits: 0x" << std::hex << std::setw(8) << std::setfill('0') << std::right
+              << bits << std::dec << std::setfill(' ') << std::left << "               ║" << std::endl;
+    std::cout << "║ Expected Hashes: " << std::setw(22) << std::fixed << std::setprecision(0)
+              << target.expectedHashes() << "║" << std::endl;
+    std::cout << "║ Retarget Interval: " << std::setw(20)
+              << (std::to_string(retargetInterval) + " blocks") << "║" << std::endl;
+    std::cout << "║ Target Block Time: " << std::setw(20)
+              << (std::to_string(targetBlockTime) + " s") << "║" << std::endl;
     std::cout << "║ Last Mining Time: " << miningTime << " ms               ║" << std::endl;
     std::cout << "╚════════════════════════════════════════╝" << std::endl;
 }
@@ -0,0 +1,186 @@
+/**
+ * @file target.cpp
+ * @brief Implementation of the 256-bit PoW target
+ */
+
+#include "consensus/target.h"
+#include "crypto/hex.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace blockchain {
+namespace consensus {
+
+namespace {
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void storeBE32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+} // namespace
+
+Target Target::fromDifficulty(int zeros) {
+    zeros = std::clamp(zeros, 0, MAX_DIFFICULTY);
+
+    Target target;
+    for (int i = 0; i < 8; i++) {
+        int wordZeros = std::clamp(zeros - i * 8, 0, 8);
+        target.words[i] = wordZeros == 8 ? 0 : 0xFFFFFFFFu >> (wordZeros * 4);
+    }
+    return target;
+}
+
+bool Target::fromCompact(uint32_t bits, Target& out) {
+    int size = static_cast<int>(bits >> 24);
+    uint32_t mantissa = bits & 0x007FFFFF;
+
+    out = Target();
+    if (mantissa == 0) {
+        return true;
+    }
+
+    // Sign bit set on a non-zero value, or more than 256 bits
+    if ((bits & 0x00800000) != 0 ||
+        size > 34 || (mantissa > 0xFF && size > 33) || (mantissa > 0xFFFF && size > 32)) {
+        return false;
+    }
+
+    uint8_t bytes[32] = {};
+    if (size <= 3) {
+        mantissa >>= 8 * (3 - size);
+        size = 3;
+    }
+    for (int j = 0; j < 3; j++) {
+        int pos = 32 - size + j;
+        if (pos >= 0) {
+            bytes[pos] = static_cast<uint8_t>(mantissa >> (8 * (2 - j)));
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        out.words[i] = loadBE32(bytes + i * 4);
+    }
+    return true;
+}
+
+Target Target::fromCompact(uint32_t bits) {
+    Target target;
+    if (!fromCompact(bits, target)) {
+        throw std::invalid_argument("Target: invalid compact encoding");
+    }
+    return target;
+}
+
+uint32_t Target::toCompact() const {
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; i++) {
+        storeBE32(bytes + i * 4, words[i]);
+    }
+
+    int first = 0;
+    while (first < 32 && bytes[first] == 0) {
+        first++;
+    }
+    int size = 32 - first;
+    if (size == 0) {
+        return 0;
+    }
+
+    uint32_t mantissa = 0;
+    for (int j = 0; j < 3; j++) {
+        int pos = first + j;
+        mantissa = (mantissa << 8) | (pos < 32 ? bytes[pos] : 0);
+    }
+
+    // Keep the sign bit clear
+    if ((mantissa & 0x00800000) != 0) {
+        mantissa >>= 8;
+        size++;
+    }
+    return (static_cast<uint32_t>(size) << 24) | mantissa;
+}
+
+bool Target::isMetBy(const uint8_t* digest) const {
+    for (int i = 0; i < 8; i++) {
+        uint32_t word = loadBE32(digest + i * 4);
+        if (word != words[i]) {
+            return word < words[i];
+        }
+    }
+    return true;
+}
+
+Target Target::scaled(uint32_t numerator, uint32_t denominator) const {
+    // 288-bit product, most significant word first
+    uint32_t product[9];
+    uint64_t carry = 0;
+    for (int i = 7; i >= 0; i--) {
+        uint64_t value = static_cast<uint64_t>(words[i]) * numerator + carry;
+        product[i + 1] = static_cast<uint32_t>(value);
+        carry = value >> 32;
+    }
+    product[0] = static_cast<uint32_t>(carry);
+
+    uint64_t remainder = 0;
+    for (int i = 0; i < 9; i++) {
+        remainder = (remainder << 32) | product[i];
+        product[i] = static_cast<uint32_t>(remainder / denominator);
+        remainder %= denominator;
+    }
+
+    Target result;
+    if (product[0] != 0) {
+        std::fill(std::begin(result.words), std::end(result.words), 0xFFFFFFFFu);
+        return result;
+    }
+    std::copy(product + 1, product + 9, result.words);
+    return result;
+}
+
+int Target::leadingZeroHexDigits() const {
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; i++) {
+        storeBE32(bytes + i * 4, words[i]);
+    }
+    return crypto::leadingZeroHexDigits(bytes, sizeof(bytes));
+}
+
+double Target::expectedHashes() const {
+    double value = 0.0;
+    for (int i = 0; i < 8; i++) {
+        value += std::ldexp(static_cast<double>(words[i]), 32 * (7 - i));
+    }
+    return std::ldexp(1.0, 256) / (value + 1.0);
+}
+
+std::string Target::toHex() const {
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; i++) {
+        storeBE32(bytes + i * 4, words[i]);
+    }
+    return crypto::toHex(bytes, sizeof(bytes));
+}
+
+bool Target::isZero() const {
+    return std::all_of(std::begin(words), std::end(words), [](uint32_t w) { return w == 0; });
+}
+
+bool Target::operator==(const Target& other) const {
+    return std::equal(std::begin(words), std::end(words), std::begin(other.words));
+}
+
+bool Target::operator<(const Target& other) const {
+    return std::lexicographical_compare(std::begin(words), std::end(words),
+                                        std::begin(other.words), std::end(other.words));
+}
+
+} // namespace consensus
+} // namespace blockchain
@@ -0,0 +1,80 @@
+/**
+ * @file address_table.cpp
+ * @brief Implementation of the address interning table
+ */
+
+#include "core/address_table.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace blockchain {
+
+AddressTable& AddressTable::instance() {
+    static AddressTable table;
+    return table;
+}
+
+AddressTable::AddressTable() : count(0) {
+    for (auto& chunk : chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    intern("");
+}
+
+AddressTable::~AddressTable() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+AddressId AddressTable::intern(std::string_view address) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(address);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(address);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    const size_t index = count.load(std::memory_order_relaxed);
+    if (index >= MAX_CHUNKS * CHUNK_SIZE) {
+        throw std::length_error("Address table is full");
+    }
+
+    std::string* chunk = chunks[index >> CHUNK_BITS].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+        chunk = new std::string[CHUNK_SIZE];
+        chunks[index >> CHUNK_BITS].store(chunk, std::memory_order_release);
+    }
+    std::string& slot = chunk[index & (CHUNK_SIZE - 1)];
+    slot.assign(address.data(), address.size());
+
+    // Publish only after the string is in place; resolve() reads without the lock
+    const AddressId id = static_cast<AddressId>(index);
+    ids.emplace(std::string_view(slot), id);
+    count.store(index + 1, std::memory_order_release);
+    return id;
+}
+
+bool AddressTable::find(std::string_view address, AddressId& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(address);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+const std::string& AddressTable::resolve(AddressId id) const {
+    const std::string* chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+    return chunk[id & (CHUNK_SIZE - 1)];
+}
+
+} // namespace blockchain
@@ -0,0 +1,31 @@
+/**
+ * @file amount.cpp
+ * @brief Implementation of fixed-point amount helpers
+ */
+
+#include "core/amount.h"
+#include <cmath>
+#include <cstdio>
+
+namespace blockchain {
+
+bool toAmount(double coins, Amount& out) {
+    if (!std::isfinite(coins) || std::fabs(coins) > static_cast<double>(MAX_MONEY / COIN)) {
+        return false;
+    }
+    out = static_cast<Amount>(std::llround(coins * COIN));
+    return true;
+}
+
+std::string formatAmount(Amount amount) {
+    // Integer arithmetic keeps every unit exact
+    const bool negative = amount < 0;
+    const uint64_t units = negative ? 0 - static_cast<uint64_t>(amount) : static_cast<uint64_t>(amount);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%s%llu.%08llu", negative ? "-" : "",
+                  static_cast<unsigned long long>(units / COIN),
+                  static_cast<unsigned long long>(units % COIN));
+    return buffer;
+}
+
+} // namespace blockchain
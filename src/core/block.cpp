@@ -4,61 +4,135 @@
  */
 
 #include "core/block.h"
-#include "crypto/sha256.h"
-#include <sstream>
+#include "consensus/proof_of_work.h"
+#include "crypto/hash_policy.h"
+#include "crypto/hex.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
 
 namespace blockchain {
 
+namespace {
+
+void storeLE(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+} // namespace
+
 Block::Block(int index, 
-             const std::string& previousHash, 
+             const crypto::Hash256& previousHash, 
              const std::vector<Transaction>& transactions)
-    : index(index), previousHash(previousHash), transactions(transactions),
-      nonce(0), consensusType(ConsensusType::NONE), validator("") {
-    
-    timestamp = std::time(nullptr);
+    : Block(index, previousHash, transactions, MerkleTree(transactions)) {
+}
+
+Block::Block(int index, 
+             const crypto::Hash256& previousHash, 
+             const std::vector<Transaction>& transactions,
+             const MerkleTree& merkleTree)
+    : transactions(transactions), consensusType(ConsensusType::NONE), validator(AddressTable::EMPTY) {
     
-    // Calculate Merkle root
-    MerkleTree merkleTree(transactions);
-    merkleRoot = merkleTree.getRoot();
+    header.index = static_cast<uint32_t>(index);
+    header.timestamp = static_cast<int64_t>(std::time(nullptr));
+    header.previousHash = previousHash;
+    header.merkleRoot = merkleTree.getRoot();
     
     // Calculate initial hash
     hash = calculateHash();
 }
 
-std::string Block::calculateHash() const {
-    std::stringstream ss;
-    ss << index << timestamp << previousHash << merkleRoot << nonce << validator;
-    return crypto::sha256(ss.str());
+Block::Block(const BlockHeader& header, std::vector<Transaction> transactions,
+             ConsensusType consensusType, std::string_view validatorName)
+    : header(header), transactions(std::move(transactions)), consensusType(consensusType),
+      validator(AddressTable::instance().intern(validatorName)) {
+    hash = calculateHash();
+}
+
+crypto::Hash256 Block::calculateHash() const {
+    return header.hash();
 }
 
 long long Block::mineBlock(int difficulty) {
-    consensusType = ConsensusType::PROOF_OF_WORK;
-    std::string target(difficulty, '0');
+    return mineBlockParallel(difficulty, 1).timeMs;
+}
+
+consensus::MiningResult Block::mineBlockParallel(int difficulty, unsigned threads,
+                                                 const std::atomic<bool>* cancel) {
+    header.bits = consensus::Target::fromDifficulty(difficulty).toCompact();
+    return mine(threads, cancel);
+}
+
+consensus::MiningResult Block::mine(unsigned threads, const std::atomic<bool>* cancel) {
+    consensus::Target target;
+    if (!consensus::Target::fromCompact(header.bits, target) || target.isZero()) {
+        std::cerr << "  ✗ Block #" << header.index << ": invalid PoW target" << std::endl;
+        return consensus::MiningResult();
+    }
     
-    auto start = std::chrono::high_resolution_clock::now();
+    // Hash everything before the nonce once, then search from the current nonce;
+    // once all 2^32 nonces fail, roll the timestamp for a fresh nonce space
+    consensus::MiningResult result;
+    uint64_t hashes = 0;
+    double seconds = 0.0;
+    while (true) {
+        uint8_t encoded[BlockHeader::SIZE];
+        header.encode(encoded);
+        crypto::ChainHasher prefix;
+        prefix.update(encoded, BlockHeader::NONCE_OFFSET);
+        result = consensus::ProofOfWork::searchNonce(
+            prefix, "", header.nonce, target, threads, cancel, consensus::NonceFormat::UINT32_LE);
+        hashes += result.hashes;
+        seconds += result.seconds;
+        if (result.found || (cancel != nullptr && cancel->load())) {
+            break;
+        }
+        rollTimestamp();
+    }
+    result.hashes = hashes;
+    result.seconds = seconds;
+    result.timeMs = static_cast<long long>(seconds * 1000);
     
-    // Find valid nonce
-    while (hash.substr(0, difficulty) != target) {
-        nonce++;
-        hash = calculateHash();
+    if (!result.found) {
+        std::cout << "  ✗ Block #" << header.index << " mining stopped | Hashes: " << result.hashes
+                  << " | Time: " << result.timeMs << " ms" << std::endl;
+        return result;
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    consensusType = ConsensusType::PROOF_OF_WORK;
+    header.nonce = static_cast<uint32_t>(result.nonce);
+    hash = result.digest;
     
-    std::cout << "  ✓ Block #" << index << " mined (PoW) | Nonce: " << nonce 
-              << " | Time: " << duration.count() << " ms" << std::endl;
+    std::cout << "  ✓ Block #" << header.index << " mined (PoW) | Nonce: " << header.nonce 
+              << " | Time: " << result.timeMs << " ms"
+              << " | Threads: " << result.threads
+              << " | Rate: " << std::fixed << std::setprecision(2)
+              << result.hashRate() / 1e6 << " MH/s" << std::endl;
     
-    return duration.count();
+    return result;
+}
+
+void Block::rollTimestamp() {
+    header.timestamp++;
+    header.nonce = 0;
+}
+
+void Block::setProofOfWork(uint32_t nonce) {
+    consensusType = ConsensusType::PROOF_OF_WORK;
+    header.nonce = nonce;
+    hash = calculateHash();
 }
 
 long long Block::validateBlock(const std::string& validatorName) {
     consensusType = ConsensusType::PROOF_OF_STAKE;
-    validator = validatorName;
-    nonce = 0;
+    validator = AddressTable::instance().intern(validatorName);
+    header.validator = BlockHeader::validatorDigest(validatorName);
+    header.nonce = 0;
     
     auto start = std::chrono::high_resolution_clock::now();
     
@@ -67,7 +141,7 @@ long long Block::validateBlock(const std::string& validatorName) {
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     
-    std::cout << "  ✓ Block #" << index << " validated (PoS) | Validator: " << validator 
+    std::cout << "  ✓ Block #" << header.index << " validated (PoS) | Validator: " << validatorName 
               << " | Time: " << duration.count() << " µs" << std::endl;
     
     return duration.count();
@@ -75,7 +149,7 @@ long long Block::validateBlock(const std::string& validatorName) {
 
 void Block::display() const {
     std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║  BLOCK #" << std::left << std::setw(42) << index << "║" << std::endl;
+    std::cout << "║  BLOCK #" << std::left << std::setw(42) << header.index << "║" << std::endl;
     std::cout << "╠═══════════════════════════════════════════════════╣" << std::endl;
     
     // Consensus type
@@ -89,22 +163,23 @@ void Block::display() const {
     
     // PoS specific
     if (consensusType == ConsensusType::PROOF_OF_STAKE) {
-        std::cout << "║ Validator: " << std::left << std::setw(40) << validator << "║" << std::endl;
+        std::cout << "║ Validator: " << std::left << std::setw(40) << getValidator() << "║" << std::endl;
     }
     
     // PoW specific
     if (consensusType == ConsensusType::PROOF_OF_WORK) {
-        std::cout << "║ Nonce: " << std::left << std::setw(44) << nonce << "║" << std::endl;
+        std::cout << "║ Nonce: " << std::left << std::setw(44) << header.nonce << "║" << std::endl;
     }
     
     // Common fields
-    std::cout << "║ Previous Hash: " << previousHash.substr(0, 34) << "║" << std::endl;
-    std::cout << "║ Merkle Root: " << merkleRoot.substr(0, 36) << "║" << std::endl;
-    std::cout << "║ Block Hash: " << hash.substr(0, 37) << "║" << std::endl;
+    std::cout << "║ Previous Hash: " << header.previousHash.toHex().substr(0, 34) << "║" << std::endl;
+    std::cout << "║ Merkle Root: " << header.merkleRoot.toHex().substr(0, 36) << "║" << std::endl;
+    std::cout << "║ Block Hash: " << hash.toHex().substr(0, 37) << "║" << std::endl;
     std::cout << "║ Transactions: " << std::left << std::setw(36) << transactions.size() << "║" << std::endl;
     
     // Timestamp
     char timeStr[26];
+    time_t timestamp = getTimestamp();
     struct tm* timeInfo = std::localtime(&timestamp);
     std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", timeInfo);
     std::cout << "║ Timestamp: " << std::left << std::setw(39) << timeStr << "║" << std::endl;
@@ -120,28 +195,87 @@ void Block::display() const {
     }
 }
 
-bool Block::isValid(int difficulty) const {
+bool Block::getTransactionProof(const crypto::Hash256& transactionHash, MerkleProof& proof) const {
+    MerkleTree merkleTree(transactions);
+    size_t index = 0;
+    if (!merkleTree.findLeaf(transactionHash, index)) {
+        return false;
+    }
+    proof = merkleTree.getProof(index);
+    return true;
+}
+
+bool Block::verifyTransactionProof(const crypto::Hash256& transactionHash, const MerkleProof& proof,
+                                   const crypto::Hash256& merkleRoot) {
+    return MerkleTree::verifyProof(transactionHash, proof, merkleRoot);
+}
+
+size_t Block::encodedSize() const {
+    size_t size = MIN_ENCODED_SIZE + getValidator().size();
+    for (const auto& tx : transactions) {
+        size += tx.encodedSize();
+    }
+    return size;
+}
+
+void Block::encode(uint8_t* out) const {
+    const std::string& name = getValidator();
+    if (name.size() > MAX_VALIDATOR_LENGTH) {
+        throw std::invalid_argument("Validator name too long to encode");
+    }
+    
+    header.encode(out);
+    size_t offset = BlockHeader::SIZE;
+    out[offset++] = static_cast<uint8_t>(consensusType);
+    storeLE(out + offset, name.size(), 2);
+    offset += 2;
+    std::memcpy(out + offset, name.data(), name.size());
+    offset += name.size();
+    storeLE(out + offset, transactions.size(), 4);
+    offset += 4;
+    for (const auto& tx : transactions) {
+        tx.encode(out + offset);
+        offset += tx.encodedSize();
+    }
+}
+
+bool Block::isValid(int difficulty, TransactionValidator* validator, bool parallel) const {
     // Check if hash is correct
     if (hash != calculateHash()) {
         return false;
     }
     
-    // For PoW, check difficulty
-    if (consensusType == ConsensusType::PROOF_OF_WORK && difficulty > 0) {
-        std::string target(difficulty, '0');
-        if (hash.substr(0, difficulty) != target) {
-            return false;
-        }
+    // Header must commit to the named validator
+    if (header.validator != BlockHeader::validatorDigest(getValidator())) {
+        return false;
     }
     
-    // Validate all transactions
-    for (const auto& tx : transactions) {
-        if (!tx.isValid()) {
+    // ...and to exactly these transactions
+    if (header.merkleRoot != MerkleTree(transactions).getRoot()) {
+        return false;
+    }
+    
+    // For PoW, check the header target and any extra difficulty
+    if (consensusType == ConsensusType::PROOF_OF_WORK) {
+        consensus::Target target;
+        if (!consensus::Target::fromCompact(header.bits, target) || !target.isMetBy(hash.data())) {
+            return false;
+        }
+        if (difficulty > 0 &&
+            crypto::leadingZeroHexDigits(hash.data(), crypto::Hash256::SIZE) < difficulty) {
             return false;
         }
     }
     
-    return true;
+    // Validate all transactions (one uncached validator serves every caller without one)
+    static TransactionValidator uncached;
+    if (validator == nullptr) {
+        validator = &uncached;
+    }
+    if (!parallel) {
+        return validator->validateSerial(transactions, false).valid;
+    }
+    return validator->validate(transactions, false).valid;
 }
 
 } // namespace blockchain
\ No newline at end of file
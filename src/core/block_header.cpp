@@ -0,0 +1,65 @@
+/**
+ * @file block_header.cpp
+ * @brief Implementation of BlockHeader encoding
+ */
+
+#include "core/block_header.h"
+#include "crypto/hash_policy.h"
+#include <cstring>
+
+namespace blockchain {
+
+namespace {
+
+void storeLE(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+void BlockHeader::encode(uint8_t* out) const {
+    std::memcpy(out, previousHash.data(), 32);
+    std::memcpy(out + 32, merkleRoot.data(), 32);
+    std::memcpy(out + 64, validator.data(), 32);
+    storeLE(out + 96, static_cast<uint64_t>(timestamp), 8);
+    storeLE(out + 104, index, 4);
+    storeLE(out + 108, bits, 4);
+    storeLE(out + NONCE_OFFSET, nonce, 4);
+}
+
+BlockHeader BlockHeader::decode(const uint8_t* in) {
+    BlockHeader header;
+    std::memcpy(header.previousHash.data(), in, 32);
+    std::memcpy(header.merkleRoot.data(), in + 32, 32);
+    std::memcpy(header.validator.data(), in + 64, 32);
+    header.timestamp = static_cast<int64_t>(loadLE(in + 96, 8));
+    header.index = static_cast<uint32_t>(loadLE(in + 104, 4));
+    header.bits = static_cast<uint32_t>(loadLE(in + 108, 4));
+    header.nonce = static_cast<uint32_t>(loadLE(in + NONCE_OFFSET, 4));
+    return header;
+}
+
+crypto::Hash256 BlockHeader::hash() const {
+    uint8_t encoded[SIZE];
+    encode(encoded);
+    return crypto::ChainHasher::digest(encoded, SIZE);
+}
+
+crypto::Hash256 BlockHeader::validatorDigest(const std::string& name) {
+    if (name.empty()) {
+        return crypto::Hash256();
+    }
+    return crypto::ChainHasher::digest(name);
+}
+
+} // namespace blockchain
@@ -0,0 +1,85 @@
+/**
+ * @file block_view.cpp
+ * @brief Implementation of BlockView
+ */
+
+#include "core/block_view.h"
+#include <utility>
+
+namespace blockchain {
+
+namespace {
+
+constexpr size_t CONSENSUS_OFFSET = BlockHeader::SIZE;
+constexpr size_t VALIDATOR_LENGTH_OFFSET = BlockHeader::SIZE + 1;
+constexpr size_t VALIDATOR_OFFSET = BlockHeader::SIZE + 3;
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+bool BlockView::parse(const uint8_t* buffer, size_t length, BlockView& view) {
+    if (length < Block::MIN_ENCODED_SIZE ||
+        buffer[CONSENSUS_OFFSET] > static_cast<uint8_t>(ConsensusType::PROOF_OF_STAKE)) {
+        return false;
+    }
+    const size_t validatorLength = static_cast<size_t>(loadLE(buffer + VALIDATOR_LENGTH_OFFSET, 2));
+    if (length < Block::MIN_ENCODED_SIZE + validatorLength) {
+        return false;
+    }
+    const size_t countOffset = VALIDATOR_OFFSET + validatorLength;
+    const uint32_t count = static_cast<uint32_t>(loadLE(buffer + countOffset, 4));
+
+    // Walk the transactions to find where the block ends
+    size_t offset = countOffset + 4;
+    TransactionView tx;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!TransactionView::parse(buffer + offset, length - offset, tx)) {
+            return false;
+        }
+        offset += tx.getEncodedSize();
+    }
+
+    view.data = buffer;
+    view.size = offset;
+    view.validatorLength = validatorLength;
+    view.transactionCount = count;
+    return true;
+}
+
+crypto::Hash256 BlockView::computeHash() const {
+    return getHeader().hash();
+}
+
+std::string_view BlockView::getValidator() const {
+    return std::string_view(reinterpret_cast<const char*>(data + VALIDATOR_OFFSET), validatorLength);
+}
+
+void BlockView::getTransactions(std::vector<TransactionView>& views) const {
+    views.resize(transactionCount);
+    size_t offset = transactionsOffset();
+    for (auto& view : views) {
+        // Bounds were checked by parse()
+        TransactionView::parse(data + offset, size - offset, view);
+        offset += view.getEncodedSize();
+    }
+}
+
+Block BlockView::toBlock() const {
+    std::vector<Transaction> transactions;
+    transactions.reserve(transactionCount);
+    std::vector<TransactionView> views;
+    getTransactions(views);
+    for (const auto& view : views) {
+        transactions.push_back(view.toTransaction());
+    }
+    return Block(getHeader(), std::move(transactions), getConsensusType(), getValidator());
+}
+
+} // namespace blockchain
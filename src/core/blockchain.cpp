@@ -4,23 +4,34 @@
  */
 
 #include "core/blockchain.h"
+#include "core/mempool.h"
+#include "storage/block_store.h"
+#include "storage/journal.h"
+#include "storage/snapshot.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <unordered_set>
 
 namespace blockchain {
 
 Blockchain::Blockchain(int difficulty) 
-    : powDifficulty(difficulty), pow(difficulty) {
+    : pow(difficulty), transactionValidator(0, TransactionValidator::DEFAULT_CACHE_CAPACITY) {
     // Create and add genesis block
     Block genesis = createGenesisBlock();
+    genesis.setBits(pow.getBits());
     genesis.validateBlock("System");
-    chain.push_back(genesis);
+    appendBlock(genesis);
 }
 
+Blockchain::~Blockchain() = default;
+
 Block Blockchain::createGenesisBlock() {
     std::vector<Transaction> genesisTxs;
     genesisTxs.push_back(Transaction("System", "Network", 0.0));
-    return Block(0, "0000000000000000000000000000000000000000000000000000000000000000", genesisTxs);
+    return Block(0, crypto::Hash256(), genesisTxs);
 }
 
 bool Blockchain::addValidator(const std::string& name, int stake) {
@@ -30,24 +41,75 @@ bool Blockchain::addValidator(const std::string& name, int stake) {
 bool Blockchain::addBlockPoW(const std::vector<Transaction>& transactions) {
     std::cout << "\n➤ Adding block with Proof of Work..." << std::endl;
     
-    // Validate all transactions
-    for (const auto& tx : transactions) {
-        if (!tx.isValid()) {
-            std::cerr << "  ✗ Error: Invalid transaction detected" << std::endl;
-            return false;
-        }
+    // Reject transactions already confirmed or listed twice
+    size_t replayed = findReplay(transactions);
+    if (replayed < transactions.size()) {
+        std::cerr << "  ✗ Error: Transaction #" << replayed << " is a duplicate" << std::endl;
+        return false;
+    }
+    
+    // Validate all transactions (in parallel; passed ones are cached for isValid)
+    ValidationResult validation = transactionValidator.validate(transactions, requireSignatures);
+    if (!validation.valid) {
+        std::cerr << "  ✗ Error: Invalid transaction #" << validation.failedIndex
+                  << " (" << validation.reason << ")" << std::endl;
+        return false;
     }
     
     // Create new block
-    Block newBlock(chain.size(), getLastBlock().getHash(), transactions);
+    Block newBlock(getChainLength(), getLastBlock().getHash(), transactions);
+    newBlock.setBits(nextWorkBits());
     
     // Mine the block
-    newBlock.mineBlock(powDifficulty);
+    if (!newBlock.mine(miningThreads).found) {
+        std::cerr << "  ✗ Error: No valid nonce found" << std::endl;
+        return false;
+    }
     
     // Add to chain
-    chain.push_back(newBlock);
+    return appendBlock(newBlock);
+}
+
+Block Blockchain::createBlockTemplate(const std::vector<Transaction>& transactions) {
+    Block newBlock(getChainLength(), getLastBlock().getHash(), transactions);
+    newBlock.setBits(nextWorkBits());
+    return newBlock;
+}
+
+bool Blockchain::submitBlock(const Block& block) {
+    if (static_cast<size_t>(block.getIndex()) != getChainLength() ||
+        block.getPreviousHash() != getLastBlock().getHash()) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " does not extend the tip" << std::endl;
+        return false;
+    }
     
-    return true;
+    if (block.getConsensusType() != ConsensusType::PROOF_OF_WORK ||
+        block.getBits() != nextWorkBits()) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " has the wrong PoW target" << std::endl;
+        return false;
+    }
+    
+    size_t replayed = findReplay(block.getTransactions());
+    if (replayed < block.getTransactions().size()) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " transaction #" << replayed
+                  << " is a duplicate" << std::endl;
+        return false;
+    }
+    
+    ValidationResult validation = transactionValidator.validate(block.getTransactions(), requireSignatures);
+    if (!validation.valid) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " transaction #" << validation.failedIndex
+                  << " is invalid (" << validation.reason << ")" << std::endl;
+        return false;
+    }
+    
+    // Transactions were just cached, so this only re-checks the header
+    if (!block.isValid(0, &transactionValidator)) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " is invalid" << std::endl;
+        return false;
+    }
+    
+    return appendBlock(block);
 }
 
 bool Blockchain::addBlockPoS(const std::vector<Transaction>& transactions) {
@@ -59,12 +121,19 @@ bool Blockchain::addBlockPoS(const std::vector<Transaction>& transactions) {
         return false;
     }
     
-    // Validate all transactions
-    for (const auto& tx : transactions) {
-        if (!tx.isValid()) {
-            std::cerr << "  ✗ Error: Invalid transaction detected" << std::endl;
-            return false;
-        }
+    // Reject transactions already confirmed or listed twice
+    size_t replayed = findReplay(transactions);
+    if (replayed < transactions.size()) {
+        std::cerr << "  ✗ Error: Transaction #" << replayed << " is a duplicate" << std::endl;
+        return false;
+    }
+    
+    // Validate all transactions (in parallel; passed ones are cached for isValid)
+    ValidationResult validation = transactionValidator.validate(transactions, requireSignatures);
+    if (!validation.valid) {
+        std::cerr << "  ✗ Error: Invalid transaction #" << validation.failedIndex
+                  << " (" << validation.reason << ")" << std::endl;
+        return false;
     }
     
     // Select validator
@@ -72,83 +141,738 @@ bool Blockchain::addBlockPoS(const std::vector<Transaction>& transactions) {
     std::cout << "  → Validator selected: " << validator << std::endl;
     
     // Create new block
-    Block newBlock(chain.size(), getLastBlock().getHash(), transactions);
+    Block newBlock(getChainLength(), getLastBlock().getHash(), transactions);
+    newBlock.setBits(nextWorkBits());
     
     // Validate the block
     newBlock.validateBlock(validator);
     
     // Add to chain
-    chain.push_back(newBlock);
-    
-    return true;
+    return appendBlock(newBlock);
 }
 
 bool Blockchain::isChainValid() const {
-    // Check each block (skip genesis)
-    for (size_t i = 1; i < chain.size(); i++) {
-        const Block& currentBlock = chain[i];
-        const Block& previousBlock = chain[i - 1];
-        
-        // Verify block hash links
-        if (currentBlock.getPreviousHash() != previousBlock.getHash()) {
-            std::cerr << "✗ Error at block " << i << ": Previous hash mismatch" << std::endl;
+    // Checkpoints must name blocks of this chain
+    for (const auto& checkpoint : checkpoints) {
+        crypto::Hash256 linked;
+        crypto::Hash256 hash;
+        if (checkpoint.height < getChainLength() &&
+            (!linkAt(checkpoint.height, linked, hash) || hash != checkpoint.hash)) {
+            std::cerr << "✗ Error at block " << checkpoint.height << ": Checkpoint mismatch" << std::endl;
             return false;
         }
-        
-        // Verify block validity
-        if (!currentBlock.isValid(powDifficulty)) {
-            std::cerr << "✗ Error at block " << i << ": Block is invalid" << std::endl;
-            return false;
+    }
+    
+    // Blocks restored from a snapshot without bodies are checked by header
+    std::vector<crypto::Hash256> validatorDigests;
+    if (!archivedHeaders.empty()) {
+        for (const auto& validator : pos.getValidators()) {
+            validatorDigests.push_back(BlockHeader::validatorDigest(validator.name));
         }
-        
-        // For PoW blocks, verify difficulty
-        if (currentBlock.getConsensusType() == ConsensusType::PROOF_OF_WORK) {
-            std::string target(powDifficulty, '0');
-            if (currentBlock.getHash().substr(0, powDifficulty) != target) {
-                std::cerr << "✗ Error at block " << i << ": PoW difficulty not met" << std::endl;
-                return false;
+    }
+    
+    // Each run of heights (skipping genesis) is checked on its own, links inside it included
+    struct Run {
+        crypto::Hash256 firstLink;                  ///< Parent named by the first block
+        crypto::Hash256 lastHash;                   ///< Hash of the last block
+        size_t failedHeight = 0;                    ///< Lowest failing height (0 = none)
+        BlockFault fault = BlockFault::NONE;
+    };
+    const size_t length = getChainLength();
+    const size_t runs = (length - 1 + VALIDATION_GRAIN - 1) / VALIDATION_GRAIN;
+    const size_t assumedValid = assumeValidHeight();
+    std::vector<Run> results(runs);
+    std::atomic<size_t> nextRun(0);
+    std::atomic<size_t> failedRun(runs);
+    
+    auto worker = [&]() {
+        for (size_t run = nextRun++; run < runs; run = nextRun++) {
+            // Runs are claimed in order, so every later one is past the failure too
+            if (run > failedRun.load(std::memory_order_relaxed)) {
+                break;
+            }
+            const size_t begin = 1 + run * VALIDATION_GRAIN;
+            const size_t end = std::min(length, begin + VALIDATION_GRAIN);
+            Run& result = results[run];
+            crypto::Hash256 previousHash;
+            for (size_t height = begin; height < end; height++) {
+                crypto::Hash256 linked;
+                crypto::Hash256 hash;
+                BlockFault fault = checkBlock(height, assumedValid, validatorDigests, linked, hash);
+                if (height == begin) {
+                    result.firstLink = linked;
+                } else if (fault != BlockFault::UNREADABLE && linked != previousHash) {
+                    fault = BlockFault::PREVIOUS_HASH;
+                }
+                if (fault != BlockFault::NONE) {
+                    result.failedHeight = height;
+                    result.fault = fault;
+                    size_t lowest = failedRun.load();
+                    while (run < lowest && !failedRun.compare_exchange_weak(lowest, run)) {
+                    }
+                    break;
+                }
+                previousHash = hash;
             }
+            result.lastHash = previousHash;
+        }
+    };
+    
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = transactionValidator.getThreads();
+    size_t workers = std::min<size_t>(threads == 0 ? hardware : threads, runs);
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workers; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    // Stitch the runs together in order; the first problem found is the lowest
+    crypto::Hash256 previousHash = headerAt(0).hash();
+    for (size_t run = 0; run < runs; run++) {
+        const Run& result = results[run];
+        const size_t begin = 1 + run * VALIDATION_GRAIN;
+        size_t failedHeight = result.failedHeight;
+        BlockFault fault = result.fault;
+        if (!(failedHeight == begin && fault == BlockFault::UNREADABLE) && result.firstLink != previousHash) {
+            failedHeight = begin;
+            fault = BlockFault::PREVIOUS_HASH;
         }
         
-        // For PoS blocks, verify validator
-        if (currentBlock.getConsensusType() == ConsensusType::PROOF_OF_STAKE) {
-            if (!pos.validateBlock(currentBlock.getValidator())) {
-                std::cerr << "✗ Error at block " << i << ": Invalid validator" << std::endl;
-                return false;
+        if (fault != BlockFault::NONE) {
+            std::cerr << "✗ Error at block " << failedHeight << ": ";
+            switch (fault) {
+            case BlockFault::UNREADABLE:
+                std::cerr << "Block cannot be read";
+                break;
+            case BlockFault::PREVIOUS_HASH:
+                std::cerr << "Previous hash mismatch";
+                break;
+            case BlockFault::INVALID:
+                std::cerr << "Block is invalid";
+                break;
+            case BlockFault::RETARGET:
+                std::cerr << "PoW target does not follow the schedule";
+                break;
+            case BlockFault::VALIDATOR:
+            default:
+                std::cerr << "Invalid validator";
+                break;
             }
+            std::cerr << std::endl;
+            return false;
         }
+        previousHash = result.lastHash;
     }
     
     return true;
 }
 
+Blockchain::BlockFault Blockchain::checkBlock(size_t height, size_t assumedValid,
+                                              const std::vector<crypto::Hash256>& validators,
+                                              crypto::Hash256& previousHash, crypto::Hash256& hash) const {
+    // Below the checkpoint, only the hash links are verified
+    if (height < assumedValid) {
+        return linkAt(height, previousHash, hash) ? BlockFault::NONE : BlockFault::UNREADABLE;
+    }
+    
+    std::unique_ptr<Block> loaded;
+    const Block* block = loadBlock(height, loaded);
+    if (block == nullptr && height < archivedHeaders.size()) {
+        const storage::SnapshotHeader& entry = archivedHeaders[height];
+        previousHash = entry.header.previousHash;
+        hash = entry.header.hash();
+        if (!isArchivedHeaderValid(entry, validators)) {
+            return BlockFault::INVALID;
+        }
+        if (entry.header.bits != expectedBits(height)) {
+            return BlockFault::RETARGET;
+        }
+        return BlockFault::NONE;
+    }
+    if (block == nullptr) {
+        return BlockFault::UNREADABLE;
+    }
+    previousHash = block->getPreviousHash();
+    hash = block->getHash();
+    
+    // Verify block validity (PoW blocks must meet their own target); this is already a worker
+    if (!block->isValid(0, &transactionValidator, false)) {
+        return BlockFault::INVALID;
+    }
+    
+    // Verify the target follows the schedule
+    if (block->getBits() != expectedBits(height)) {
+        return BlockFault::RETARGET;
+    }
+    
+    // For PoS blocks, verify validator
+    if (block->getConsensusType() == ConsensusType::PROOF_OF_STAKE && !pos.validateBlock(block->getValidator())) {
+        return BlockFault::VALIDATOR;
+    }
+    return BlockFault::NONE;
+}
+
+void Blockchain::addCheckpoint(size_t height, const crypto::Hash256& hash) {
+    auto at = std::lower_bound(checkpoints.begin(), checkpoints.end(), height,
+                               [](const Checkpoint& checkpoint, size_t h) { return checkpoint.height < h; });
+    if (at != checkpoints.end() && at->height == height) {
+        at->hash = hash;
+    } else {
+        checkpoints.insert(at, Checkpoint{height, hash});
+    }
+}
+
+size_t Blockchain::assumeValidHeight() const {
+    if (fullValidation) {
+        return 0;
+    }
+    for (auto it = checkpoints.rbegin(); it != checkpoints.rend(); ++it) {
+        if (it->height < getChainLength()) {
+            return it->height;
+        }
+    }
+    return 0;
+}
+
+bool Blockchain::linkAt(size_t height, crypto::Hash256& previousHash, crypto::Hash256& hash) const {
+    const Block* block = residentBlock(height);
+    if (block != nullptr) {
+        previousHash = block->getPreviousHash();
+        hash = block->getHash();
+        return true;
+    }
+    if (height < archivedHeaders.size()) {
+        previousHash = archivedHeaders[height].header.previousHash;
+        hash = archivedHeaders[height].header.hash();
+        return true;
+    }
+#ifdef BLOCKCHAIN_STORAGE
+    // The store index records each block's hash, so nothing is rehashed
+    BlockView view;
+    if (store != nullptr && store->get(height, view) && store->getHash(height, hash)) {
+        previousHash = view.getHeader().previousHash;
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool Blockchain::isArchivedHeaderValid(const storage::SnapshotHeader& entry,
+                                       const std::vector<crypto::Hash256>& validators) {
+    if (entry.consensusType == ConsensusType::PROOF_OF_WORK) {
+        consensus::Target target;
+        return consensus::Target::fromCompact(entry.header.bits, target) &&
+               target.isMetBy(entry.header.hash().data());
+    }
+    if (entry.consensusType == ConsensusType::PROOF_OF_STAKE) {
+        return std::find(validators.begin(), validators.end(), entry.header.validator) != validators.end();
+    }
+    return true;
+}
+
 const Block& Blockchain::getLastBlock() const {
     return chain.back();
 }
 
 const Block* Blockchain::getBlock(int index) const {
-    if (index >= 0 && index < static_cast<int>(chain.size())) {
-        return &chain[index];
+    return index >= 0 ? residentBlock(static_cast<size_t>(index)) : nullptr;
+}
+
+bool Blockchain::getBlock(int index, BlockView& view) const {
+#ifdef BLOCKCHAIN_STORAGE
+    return store != nullptr && index >= 0 && store->get(static_cast<size_t>(index), view);
+#else
+    (void)index;
+    (void)view;
+    return false;
+#endif
+}
+
+const Block* Blockchain::residentBlock(size_t height) const {
+    if (height >= chainBase && height < getChainLength()) {
+        return &chain[height - chainBase];
     }
     return nullptr;
 }
 
-void Blockchain::setDifficulty(int difficulty) {
-    if (difficulty < 1 || difficulty > 8) {
-        std::cerr << "Warning: Difficulty should be between 1 and 8" << std::endl;
-        return;
+const Block* Blockchain::loadBlock(size_t height, std::unique_ptr<Block>& loaded) const {
+    const Block* block = residentBlock(height);
+    if (block != nullptr) {
+        return block;
+    }
+    BlockView view;
+    if (!getBlock(static_cast<int>(height), view)) {
+        return nullptr;
+    }
+    loaded.reset(new Block(view.toBlock()));
+    return loaded.get();
+}
+
+BlockHeader Blockchain::headerAt(size_t height) const {
+    const Block* block = residentBlock(height);
+    if (block != nullptr) {
+        return block->getHeader();
+    }
+    if (height < archivedHeaders.size()) {
+        return archivedHeaders[height].header;
+    }
+    BlockView view;
+    return getBlock(static_cast<int>(height), view) ? view.getHeader() : BlockHeader();
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+bool Blockchain::attachStore(const std::string& directory, size_t residentBlocks, uint64_t segmentSize) {
+    if (store != nullptr) {
+        std::cerr << "  ✗ Error: A block store is already attached" << std::endl;
+        return false;
     }
-    powDifficulty = difficulty;
+    std::unique_ptr<storage::BlockStore> opened(
+        new storage::BlockStore(segmentSize > 0 ? segmentSize : storage::BlockStore::DEFAULT_SEGMENT_SIZE));
+    if (!opened->open(directory)) {
+        return false;
+    }
+    
+    const size_t length = opened->size();
+    const size_t tip = getChainLength() - 1;
+    crypto::Hash256 storedTip;
+    bool adopted = false;
+    std::deque<Block> previousChain;
+    const ReplayFilter previousFilter = replayFilter;
+    const uint32_t previousBits = pow.getBits();
+    const size_t previousResident = this->residentBlocks;
+    if (length == 0) {
+        // New store: write out the chain so far
+        if (chainBase > 0) {
+            std::cerr << "  ✗ Error: Blocks below #" << chainBase << " are not in memory to be stored" << std::endl;
+            return false;
+        }
+        for (const auto& block : chain) {
+            if (!opened->append(block)) {
+                return false;
+            }
+        }
+    } else if (length > tip && opened->getHash(tip, storedTip) && storedTip == getLastBlock().getHash()) {
+        // Store already holds this chain: apply only the blocks beyond the tip
+        BlockView view;
+        for (size_t height = tip + 1; height < length; height++) {
+            if (!opened->get(height, view)) {
+                std::cerr << "  ✗ Error: Stored block #" << height << " cannot be read" << std::endl;
+                return false;
+            }
+            // Checked like journal recovery; the store is not attached yet, so nothing is rewritten
+            if (!recoverBlock(view.toBlock())) {
+                return false;
+            }
+            while (chain.size() > std::max<size_t>(1, residentBlocks)) {
+                chain.pop_front();
+                chainBase++;
+            }
+        }
+    } else if (getChainLength() > 1) {
+        std::cerr << "  ✗ Error: " << directory << " holds a different chain than the "
+                  << getChainLength() << " blocks in memory" << std::endl;
+        return false;
+    } else {
+        // Existing store: adopt its chain, loading only the newest blocks
+        adopted = true;
+        previousChain = chain;
+        std::deque<Block> tail;
+        BlockView view;
+        for (size_t height = length - std::min(length, std::max<size_t>(1, residentBlocks)); height < length; height++) {
+            if (!opened->get(height, view)) {
+                std::cerr << "  ✗ Error: Stored block #" << height << " cannot be read" << std::endl;
+                return false;
+            }
+            tail.push_back(view.toBlock());
+        }
+        chain.swap(tail);
+        chainBase = length - chain.size();
+        pow.setBits(getLastBlock().getBits());
+        
+        // The replay filter only needs its window plus what the filter can hold
+        const size_t window = replayFilter.getWindowBlocks();
+        const size_t filterIds = 2 * replayFilter.getFilterCapacity();
+        size_t start = length;
+        size_t blocks = 0;
+        size_t ids = 0;
+        while (start > 0 && (blocks < window || ids < filterIds)) {
+            start--;
+            if (++blocks > window && opened->get(start, view)) {
+                ids += view.getTransactionCount();
+            }
+        }
+        replayFilter.clear();
+        std::vector<TransactionView> views;
+        std::vector<crypto::Hash256> hashes;
+        for (size_t height = start; height < length; height++) {
+            hashes.clear();
+            if (opened->get(height, view)) {
+                view.getTransactions(views);
+                for (const auto& tx : views) {
+                    hashes.push_back(tx.computeHash());
+                }
+            }
+            replayFilter.recordBlock(hashes);
+        }
+    }
+    
+    store = std::move(opened);
+    archivedHeaders.clear();
+    archivedTransactions.clear();
+    archivedTransactionsBase = 0;
+    this->residentBlocks = std::max<size_t>(1, residentBlocks);
+    while (chain.size() > this->residentBlocks) {
+        chain.pop_front();
+        chainBase++;
+    }
+    
+    // An adopted chain gets the same checks as any other (checkpoints keep this cheap)
+    if (adopted && !isChainValid()) {
+        std::cerr << "  ✗ Error: " << directory << " holds an invalid chain" << std::endl;
+        store.reset();
+        chain.swap(previousChain);
+        chainBase = 0;
+        replayFilter = previousFilter;
+        pow.setBits(previousBits);
+        this->residentBlocks = previousResident;
+        return false;
+    }
+    return true;
+}
+#endif
+
+bool Blockchain::setDifficulty(int difficulty) {
+    bool stored = false;
+#ifdef BLOCKCHAIN_STORAGE
+    stored = store != nullptr;
+#endif
+    if (getChainLength() > 1 || stored) {
+        std::cerr << "  ✗ Error: The difficulty can only be set before the first block is added" << std::endl;
+        return false;
+    }
+    const uint32_t previous = pow.getBits();
     pow.setDifficulty(difficulty);
+    if (pow.getBits() != previous) {
+        // Every later target derives from the genesis block's
+        chain.front().setBits(pow.getBits());
+        chain.front().validateBlock("System");
+    }
+    return true;
+}
+
+void Blockchain::setRetarget(int interval, int64_t blockTime) {
+    pow.setRetarget(interval, blockTime);
+}
+
+uint32_t Blockchain::expectedBits(size_t height) const {
+    if (pow.isRetargetHeight(height)) {
+        return retargetBits(height);
+    }
+    return headerAt(height - 1).bits;
+}
+
+uint32_t Blockchain::retargetBits(size_t height) const {
+    const BlockHeader first = headerAt(height - pow.getRetargetInterval());
+    const BlockHeader last = headerAt(height - 1);
+    return pow.retarget(last.bits, last.timestamp - first.timestamp);
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+bool Blockchain::saveSnapshot(const std::string& path) const {
+    storage::ChainSnapshot snapshot;
+    snapshot.headers.resize(getChainLength());
+    for (size_t height = 0; height < getChainLength(); height++) {
+        storage::SnapshotHeader& entry = snapshot.headers[height];
+        const Block* block = residentBlock(height);
+        BlockView view;
+        if (block != nullptr) {
+            entry.header = block->getHeader();
+            entry.consensusType = block->getConsensusType();
+        } else if (height < archivedHeaders.size()) {
+            entry = archivedHeaders[height];
+        } else if (getBlock(static_cast<int>(height), view)) {
+            entry.header = view.getHeader();
+            entry.consensusType = view.getConsensusType();
+        } else {
+            std::cerr << "  ✗ Error: Block #" << height << " cannot be read" << std::endl;
+            return false;
+        }
+    }
+    
+    const size_t blocks = std::min(chain.size(), SNAPSHOT_BLOCKS);
+    snapshot.blocks.assign(chain.end() - static_cast<std::ptrdiff_t>(blocks), chain.end());
+    
+    // IDs of the filter-covered blocks saved without a body, as findReplay() scans them
+    const size_t firstBlock = getChainLength() - blocks;
+    const size_t olderBlocks = getChainLength() - replayFilter.getRecentBlocks();
+    const size_t filteredBlocks = std::min(olderBlocks, replayFilter.getFilteredBlocks());
+    snapshot.confirmedBase = std::min(olderBlocks - filteredBlocks, firstBlock);
+    std::vector<TransactionView> views;
+    for (size_t height = snapshot.confirmedBase; height < std::min(olderBlocks, firstBlock); height++) {
+        std::vector<crypto::Hash256> ids;
+        const Block* block = residentBlock(height);
+        BlockView view;
+        if (block != nullptr) {
+            for (const auto& tx : block->getTransactions()) {
+                ids.push_back(tx.getHash());
+            }
+        } else if (height < archivedHeaders.size()) {
+            if (height < archivedTransactionsBase ||
+                height - archivedTransactionsBase >= archivedTransactions.size()) {
+                std::cerr << "  ✗ Error: Transactions of block #" << height << " are not known" << std::endl;
+                return false;
+            }
+            ids = archivedTransactions[height - archivedTransactionsBase];
+        } else if (getBlock(static_cast<int>(height), view)) {
+            view.getTransactions(views);
+            for (const auto& tx : views) {
+                ids.push_back(tx.computeHash());
+            }
+        } else {
+            std::cerr << "  ✗ Error: Block #" << height << " cannot be read" << std::endl;
+            return false;
+        }
+        snapshot.confirmed.push_back(std::move(ids));
+    }
+    
+    snapshot.validators = pos.getValidators();
+    snapshot.bits = pow.getBits();
+    snapshot.retargetInterval = pow.getRetargetInterval();
+    snapshot.targetBlockTime = pow.getTargetBlockTime();
+    snapshot.requireSignatures = requireSignatures;
+    replayFilter.encode(snapshot.replayFilter);
+    return snapshot.save(path);
+}
+
+bool Blockchain::loadSnapshot(const std::string& path) {
+    if (store != nullptr) {
+        std::cerr << "  ✗ Error: Load the snapshot before attaching a block store" << std::endl;
+        return false;
+    }
+    storage::ChainSnapshot snapshot;
+    if (!snapshot.load(path)) {
+        return false;
+    }
+    ReplayFilter restored(replayFilter.getWindowBlocks(), replayFilter.getFilterCapacity());
+    size_t offset = 0;
+    if (!restored.decode(snapshot.replayFilter.data(), snapshot.replayFilter.size(), offset)) {
+        std::cerr << "  ✗ Error: Snapshot " << path << " has a damaged replay filter" << std::endl;
+        return false;
+    }
+    
+    replayFilter = std::move(restored);
+    chainBase = snapshot.headers.size() - snapshot.blocks.size();
+    chain.assign(std::make_move_iterator(snapshot.blocks.begin()), std::make_move_iterator(snapshot.blocks.end()));
+    snapshot.headers.resize(chainBase);
+    archivedHeaders.swap(snapshot.headers);
+    archivedTransactionsBase = snapshot.confirmedBase;
+    archivedTransactions.swap(snapshot.confirmed);
+    
+    std::vector<consensus::Validator> previous = pos.getValidators();
+    for (const auto& validator : previous) {
+        pos.removeValidator(validator.name);
+    }
+    for (const auto& validator : snapshot.validators) {
+        pos.addValidator(validator.name, validator.stake);
+    }
+    pow.setRetarget(snapshot.retargetInterval, snapshot.targetBlockTime);
+    pow.setBits(snapshot.bits);
+    requireSignatures = snapshot.requireSignatures;
+    return true;
+}
+#endif
+
+bool Blockchain::recoverBlock(const Block& block) {
+    const size_t height = static_cast<size_t>(block.getIndex());
+    if (height < getChainLength()) {
+        // Already applied before the crash (e.g. persisted by the store)
+        return headerAt(height).hash() == block.getHash();
+    }
+    if (height != getChainLength() || block.getPreviousHash() != getLastBlock().getHash()) {
+        std::cerr << "  ✗ Error: Recovered block #" << height << " does not extend the tip" << std::endl;
+        return false;
+    }
+    if (!block.isValid(0, &transactionValidator) ||
+        block.getBits() != expectedBits(height) ||
+        (block.getConsensusType() == ConsensusType::PROOF_OF_STAKE && !pos.validateBlock(block.getValidator()))) {
+        std::cerr << "  ✗ Error: Recovered block #" << height << " is invalid" << std::endl;
+        return false;
+    }
+    if (!appendBlock(block, false)) {
+        return false;
+    }
+    pow.setBits(block.getBits());
+    return true;
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+bool Blockchain::recover(const storage::Journal& journal, Mempool* pool, RecoveryStats* stats) {
+    RecoveryStats applied;
+    const bool replayed = journal.replay([&](storage::RecordType type, const uint8_t* payload, size_t length) {
+        if (type == storage::RecordType::TRANSACTION) {
+            TransactionView view;
+            Amount fee = 0;
+            if (!storage::Journal::decodeTransaction(payload, length, view, fee)) {
+                std::cerr << "  ✗ Error: Malformed transaction record in " << journal.getPath() << std::endl;
+                return false;
+            }
+            applied.transactions++;
+            if (pool != nullptr) {
+                // A duplicate is a transaction a checkpoint kept and that was logged again
+                pool->submit(view.toTransaction(), fee);
+            }
+            return true;
+        }
+        BlockView view;
+        if (type != storage::RecordType::BLOCK || !BlockView::parse(payload, length, view)) {
+            std::cerr << "  ✗ Error: Malformed block record in " << journal.getPath() << std::endl;
+            return false;
+        }
+        const Block block = view.toBlock();
+        if (!recoverBlock(block)) {
+            return false;
+        }
+        applied.blocks++;
+        if (pool != nullptr) {
+            pool->remove(block.getTransactions());
+        }
+        return true;
+    });
+    if (stats != nullptr) {
+        *stats = applied;
+    }
+    return replayed;
+}
+
+bool Blockchain::checkpoint(Mempool* pool) {
+    if (!store || journal == nullptr) {
+        std::cerr << "  ✗ Error: A checkpoint needs a store and a journal" << std::endl;
+        return false;
+    }
+    if (!store->sync()) {
+        return false;
+    }
+    if (pool == nullptr) {
+        return journal->truncate();
+    }
+    
+    // Anything logged after the mark is copied as is, so no admission is missed
+    const uint64_t mark = journal->getSize();
+    std::vector<std::vector<uint8_t>> pending;
+    for (const auto& entry : pool->getPending()) {
+        pending.push_back(storage::Journal::encodeTransaction(entry.first, entry.second));
+    }
+    return journal->compact(pending, mark);
+}
+#endif
+
+size_t Blockchain::findReplay(const std::vector<Transaction>& transactions) const {
+    // Blocks below the exactly tracked window, for confirming filter matches
+    const size_t olderBlocks = getChainLength() - replayFilter.getRecentBlocks();
+    const size_t filteredBlocks = std::min(olderBlocks, replayFilter.getFilteredBlocks());
+    std::unordered_set<crypto::Hash256> seen;
+    seen.reserve(transactions.size());
+    
+    for (size_t i = 0; i < transactions.size(); i++) {
+        const crypto::Hash256& id = transactions[i].getHash();
+        if (!seen.insert(id).second) {
+            return i;
+        }
+        
+        switch (replayFilter.check(id)) {
+        case ReplayCheck::ABSENT:
+            break;
+        case ReplayCheck::CONFIRMED:
+            return i;
+        case ReplayCheck::POSSIBLE:
+            // Only the blocks the filter covers can hold it; newest first
+            for (size_t height = olderBlocks; height-- > olderBlocks - filteredBlocks;) {
+                if (height < archivedHeaders.size()) {
+                    // No body (restored from a snapshot), but its IDs were saved
+                    const size_t entry = height - archivedTransactionsBase;
+                    if (height >= archivedTransactionsBase && entry < archivedTransactions.size() &&
+                        std::find(archivedTransactions[entry].begin(), archivedTransactions[entry].end(), id) !=
+                            archivedTransactions[entry].end()) {
+                        return i;
+                    }
+                    continue;
+                }
+                std::unique_ptr<Block> loaded;
+                const Block* block = loadBlock(height, loaded);
+                if (block == nullptr) {
+                    std::cerr << "  ✗ Error: Block #" << height << " cannot be read to check a replay" << std::endl;
+                    return i;
+                }
+                for (const auto& confirmed : block->getTransactions()) {
+                    if (confirmed.getHash() == id) {
+                        return i;
+                    }
+                }
+            }
+            break;
+        }
+    }
+    return transactions.size();
+}
+
+bool Blockchain::appendBlock(const Block& block, bool logged) {
+#ifdef BLOCKCHAIN_STORAGE
+    if (logged && journal != nullptr && !journal->appendBlock(block)) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " could not be journaled" << std::endl;
+        return false;
+    }
+    if (store != nullptr && !store->append(block)) {
+        return false;
+    }
+#else
+    (void)logged;
+#endif
+    
+    std::vector<crypto::Hash256> ids;
+    ids.reserve(block.getTransactions().size());
+    for (const auto& tx : block.getTransactions()) {
+        ids.push_back(tx.getHash());
+    }
+    replayFilter.recordBlock(ids);
+    chain.push_back(block);
+#ifdef BLOCKCHAIN_STORAGE
+    if (store != nullptr && chain.size() > residentBlocks) {
+        chain.pop_front();
+        chainBase++;
+    }
+#endif
+    return true;
+}
+
+uint32_t Blockchain::nextWorkBits() {
+    const size_t height = getChainLength();
+    if (pow.isRetargetHeight(height)) {
+        uint32_t previous = pow.getBits();
+        pow.setBits(retargetBits(height));
+        if (pow.getBits() != previous) {
+            std::cout << "  ↻ Retarget at block " << height << ": 0x" << std::hex << previous
+                      << " → 0x" << pow.getBits() << std::dec
+                      << " (difficulty " << pow.getDifficulty() << ")" << std::endl;
+        }
+    }
+    return pow.getBits();
 }
 
 void Blockchain::displayChain() const {
     std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║              BLOCKCHAIN - " << chain.size() << " blocks" << std::setw(18) << " " << "║" << std::endl;
+    std::cout << "║              BLOCKCHAIN - " << getChainLength() << " blocks" << std::setw(18) << " " << "║" << std::endl;
     std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
     
-    for (const auto& block : chain) {
-        block.display();
+    for (size_t height = 0; height < getChainLength(); height++) {
+        std::unique_ptr<Block> loaded;
+        const Block* block = loadBlock(height, loaded);
+        if (block != nullptr) {
+            block->display();
+        }
     }
 }
 
@@ -157,23 +881,37 @@ void Blockchain::displayStats() const {
     int posBlocks = 0;
     int totalTransactions = 0;
     
-    for (const auto& block : chain) {
-        if (block.getConsensusType() == ConsensusType::PROOF_OF_WORK) {
+    // Blocks only on disk are counted from their views, without loading them
+    for (size_t height = 0; height < getChainLength(); height++) {
+        ConsensusType type = ConsensusType::NONE;
+        const Block* block = residentBlock(height);
+        BlockView view;
+        if (block != nullptr) {
+            type = block->getConsensusType();
+            totalTransactions += block->getTransactions().size();
+        } else if (getBlock(static_cast<int>(height), view)) {
+            type = view.getConsensusType();
+            totalTransactions += view.getTransactionCount();
+        } else if (height < archivedHeaders.size()) {
+            type = archivedHeaders[height].consensusType;
+        }
+        if (type == ConsensusType::PROOF_OF_WORK) {
             powBlocks++;
-        } else if (block.getConsensusType() == ConsensusType::PROOF_OF_STAKE) {
+        } else if (type == ConsensusType::PROOF_OF_STAKE) {
             posBlocks++;
         }
-        totalTransactions += block.getTransactions().size();
     }
     
     std::cout << "\n╔═══════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║           BLOCKCHAIN STATISTICS                   ║" << std::endl;
     std::cout << "╠═══════════════════════════════════════════════════╣" << std::endl;
-    std::cout << "║ Total Blocks: " << std::left << std::setw(35) << chain.size() << "║" << std::endl;
+    std::cout << "║ Total Blocks: " << std::left << std::setw(35) << getChainLength() << "║" << std::endl;
     std::cout << "║ PoW Blocks: " << std::left << std::setw(37) << powBlocks << "║" << std::endl;
     std::cout << "║ PoS Blocks: " << std::left << std::setw(37) << posBlocks << "║" << std::endl;
     std::cout << "║ Total Transactions: " << std::left << std::setw(29) << totalTransactions << "║" << std::endl;
-    std::cout << "║ PoW Difficulty: " << std::left << std::setw(33) << powDifficulty << "║" << std::endl;
+    std::cout << "║ PoW Difficulty: " << std::left << std::setw(33) << pow.getDifficulty() << "║" << std::endl;
+    std::cout << "║ Expected Hashes/Block: " << std::left << std::setw(26) << std::fixed << std::setprecision(0)
+              << pow.getTarget().expectedHashes() << "║" << std::endl;
     std::cout << "║ Validators: " << std::left << std::setw(37) << pos.getValidatorCount() << "║" << std::endl;
     std::cout << "║ Chain Valid: " << std::left << std::setw(36) << (isChainValid() ? "YES ✓" : "NO ✗") << "║" << std::endl;
     std::cout << "╚═══════════════════════════════════════════════════╝" << std::endl;
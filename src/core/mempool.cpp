@@ -0,0 +1,269 @@
+/**
+ * @file mempool.cpp
+ * @brief Implementation of the transaction pool
+ */
+
+#include "core/mempool.h"
+#include "storage/journal.h"
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+namespace blockchain {
+
+Mempool::Mempool(size_t maxTransactions, size_t maxBytes)
+    : maxTransactions(maxTransactions), maxBytes(maxBytes), arrivals(0), count(0), bytes(0) {
+}
+
+SubmitStatus Mempool::submit(const Transaction& tx, Amount fee) {
+    if (fee < 0 || !tx.isValid()) {
+        return SubmitStatus::INVALID;
+    }
+
+    // Encoded outside the lock; queued only once the transaction is admitted
+    std::vector<uint8_t> record;
+#ifdef BLOCKCHAIN_STORAGE
+    if (journal != nullptr) {
+        record = storage::Journal::encodeTransaction(tx, fee);
+    }
+#endif
+
+    const size_t size = tx.encodedSize();
+    Shard& shard = shards[shardIndex(tx.getHash())];
+    uint64_t sequence = 0;
+    SubmitStatus status = SubmitStatus::POOL_FULL;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.byId.count(tx.getHash()) != 0) {
+            return SubmitStatus::DUPLICATE;
+        }
+        if (reserve(size)) {
+            if (!logLocked(record, sequence)) {
+                release(size);
+                return SubmitStatus::NOT_DURABLE;
+            }
+            insertLocked(shard, tx, fee, size);
+            status = SubmitStatus::ACCEPTED;
+        }
+    }
+    if (status != SubmitStatus::ACCEPTED) {
+        status = submitEvicting(tx, fee, size, record, sequence);
+    }
+
+#ifdef BLOCKCHAIN_STORAGE
+    // Wait for the fsync without holding any shard lock
+    if (status == SubmitStatus::ACCEPTED && sequence != 0 && !journal->waitDurable(sequence)) {
+        remove({tx});
+        return SubmitStatus::NOT_DURABLE;
+    }
+#endif
+    return status;
+}
+
+SubmitStatus Mempool::submitEvicting(const Transaction& tx, Amount fee, size_t size,
+                                     const std::vector<uint8_t>& record, uint64_t& sequence) {
+    // Always locked in shard order, like takeBest(); no reservation is in flight meanwhile
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(SHARDS);
+    for (auto& shard : shards) {
+        locks.emplace_back(shard.mutex);
+    }
+    Shard& target = shards[shardIndex(tx.getHash())];
+    if (target.byId.count(tx.getHash()) != 0) {
+        return SubmitStatus::DUPLICATE;
+    }
+
+    // Walk the cheapest entries of all shards, counting what must go before evicting any
+    using Tail = std::pair<std::map<Priority, Transaction>::reverse_iterator, size_t>;
+    auto dearer = [](const Tail& a, const Tail& b) { return a.first->first < b.first->first; };
+    std::priority_queue<Tail, std::vector<Tail>, decltype(dearer)> tails(dearer);
+    for (size_t i = 0; i < SHARDS; i++) {
+        if (!shards[i].byFee.empty()) {
+            tails.push({shards[i].byFee.rbegin(), i});
+        }
+    }
+    std::vector<std::pair<size_t, Priority>> victims;
+    size_t freedBytes = 0;
+    while (count.load(std::memory_order_relaxed) - victims.size() + 1 > maxTransactions ||
+           bytes.load(std::memory_order_relaxed) - freedBytes + size > maxBytes) {
+        if (tails.empty() || tails.top().first->first.fee >= fee) {
+            return SubmitStatus::POOL_FULL;
+        }
+        Tail cheapest = tails.top();
+        tails.pop();
+        victims.push_back({cheapest.second, cheapest.first->first});
+        freedBytes += cheapest.first->second.encodedSize();
+        if (++cheapest.first != shards[cheapest.second].byFee.rend()) {
+            tails.push(cheapest);
+        }
+    }
+
+    // Admitted: log it before anything is evicted for it
+    if (!logLocked(record, sequence)) {
+        return SubmitStatus::NOT_DURABLE;
+    }
+    for (const auto& victim : victims) {
+        Shard& shard = shards[victim.first];
+        eraseLocked(shard, shard.byFee.find(victim.second));
+    }
+    // Cannot fail: every lock is held, so the totals only hold what the victims left
+    reserve(size);
+    insertLocked(target, tx, fee, size);
+    return SubmitStatus::ACCEPTED;
+}
+
+bool Mempool::logLocked(const std::vector<uint8_t>& record, uint64_t& sequence) {
+#ifdef BLOCKCHAIN_STORAGE
+    if (journal != nullptr) {
+        sequence = journal->appendAsync(storage::RecordType::TRANSACTION, record.data(), record.size());
+        return sequence != 0;
+    }
+#else
+    (void)record;
+    (void)sequence;
+#endif
+    return true;
+}
+
+bool Mempool::reserve(size_t size) {
+    if (count.fetch_add(1, std::memory_order_relaxed) + 1 > maxTransactions) {
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (bytes.fetch_add(size, std::memory_order_relaxed) + size > maxBytes) {
+        bytes.fetch_sub(size, std::memory_order_relaxed);
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void Mempool::release(size_t size) {
+    bytes.fetch_sub(size, std::memory_order_relaxed);
+    count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Mempool::insertLocked(Shard& shard, const Transaction& tx, Amount fee, size_t size) {
+    const Priority priority = {fee, arrivals.fetch_add(1, std::memory_order_relaxed)};
+    shard.byFee.emplace(priority, tx);
+    shard.byId.emplace(tx.getHash(), priority);
+    shard.bytes += size;
+}
+
+std::vector<Transaction> Mempool::takeBest(size_t limit, Amount* totalFee) {
+    std::vector<Transaction> taken;
+    Amount fees = 0;
+    {
+        // Always locked in shard order, as in submitEvicting()
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(SHARDS);
+        for (auto& shard : shards) {
+            locks.emplace_back(shard.mutex);
+        }
+
+        // Merge the shards through their best entries
+        using Head = std::pair<Priority, size_t>;
+        auto worse = [](const Head& a, const Head& b) { return b.first < a.first; };
+        std::priority_queue<Head, std::vector<Head>, decltype(worse)> heads(worse);
+        for (size_t i = 0; i < SHARDS; i++) {
+            if (!shards[i].byFee.empty()) {
+                heads.push({shards[i].byFee.begin()->first, i});
+            }
+        }
+
+        taken.reserve(std::min(limit, size()));
+        while (taken.size() < limit && !heads.empty()) {
+            Shard& shard = shards[heads.top().second];
+            heads.pop();
+
+            auto best = shard.byFee.begin();
+            fees += best->first.fee;
+            taken.push_back(best->second);
+            eraseLocked(shard, best);
+
+            if (!shard.byFee.empty()) {
+                heads.push({shard.byFee.begin()->first, static_cast<size_t>(&shard - shards.data())});
+            }
+        }
+    }
+
+    if (totalFee != nullptr) {
+        *totalFee = fees;
+    }
+    if (!taken.empty()) {
+        notifySpace();
+    }
+    return taken;
+}
+
+size_t Mempool::remove(const std::vector<Transaction>& transactions) {
+    size_t removed = 0;
+    for (const auto& tx : transactions) {
+        Shard& shard = shards[shardIndex(tx.getHash())];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.byId.find(tx.getHash());
+        if (it != shard.byId.end()) {
+            eraseLocked(shard, shard.byFee.find(it->second));
+            removed++;
+        }
+    }
+    if (removed > 0) {
+        notifySpace();
+    }
+    return removed;
+}
+
+bool Mempool::contains(const crypto::Hash256& id) const {
+    const Shard& shard = shards[shardIndex(id)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.byId.count(id) != 0;
+}
+
+std::vector<std::pair<Transaction, Amount>> Mempool::getPending() const {
+    std::vector<std::pair<Transaction, Amount>> pending;
+    pending.reserve(size());
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.byFee) {
+            pending.emplace_back(entry.second, entry.first.fee);
+        }
+    }
+    return pending;
+}
+
+bool Mempool::waitForSpace(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(spaceMutex);
+    const uint64_t seen = removals;
+    return spaceFreed.wait_for(lock, timeout, [&]() { return removals != seen; });
+}
+
+void Mempool::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count.fetch_sub(shard.byId.size(), std::memory_order_relaxed);
+        bytes.fetch_sub(shard.bytes, std::memory_order_relaxed);
+        shard.byFee.clear();
+        shard.byId.clear();
+        shard.bytes = 0;
+    }
+    notifySpace();
+}
+
+void Mempool::eraseLocked(Shard& shard, std::map<Priority, Transaction>::iterator it) {
+    const size_t size = it->second.encodedSize();
+    shard.byId.erase(it->second.getHash());
+    shard.byFee.erase(it);
+    shard.bytes -= size;
+    count.fetch_sub(1, std::memory_order_relaxed);
+    bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void Mempool::notifySpace() {
+    {
+        std::lock_guard<std::mutex> lock(spaceMutex);
+        removals++;
+    }
+    spaceFreed.notify_all();
+}
+
+} // namespace blockchain
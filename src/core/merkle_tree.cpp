@@ -4,80 +4,283 @@
  */
 
 #include "core/merkle_tree.h"
-#include "crypto/sha256.h"
+#include "crypto/hash_policy.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <stdexcept>
+#include <thread>
 
 namespace blockchain {
 
-MerkleTree::MerkleTree(const std::vector<Transaction>& transactions) {
+namespace {
+
+// Below this many items per worker a level is cheaper to hash on one thread
+constexpr size_t PARALLEL_GRAIN = 4096;
+
+/**
+ * @brief Run fn(begin, end) over [0, count), split across threads when wide
+ */
+template <typename Fn>
+void parallelFor(size_t count, Fn fn) {
+    size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                      count / PARALLEL_GRAIN);
+    if (workers <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+    
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    const size_t chunk = (count + workers - 1) / workers;
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        threads.emplace_back(fn, begin, std::min(count, begin + chunk));
+    }
+    fn(size_t(0), std::min(count, chunk));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace
+
+MerkleTree::MerkleTree(const std::vector<Transaction>& transactions)
+    : leafCount(transactions.size()) {
     if (transactions.empty()) {
-        root = "0000000000000000000000000000000000000000000000000000000000000000";
         return;
     }
     
     // Hash each transaction to create leaves
-    for (const auto& tx : transactions) {
-        leaves.push_back(tx.getHash());
-    }
+    layoutLevels(leafCount);
+    parallelFor(leafCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            nodes[i] = transactions[i].getHash();
+        }
+    });
     
-    root = buildTreeIterative(leaves);
+    buildLevels();
 }
 
-MerkleTree::MerkleTree(const std::vector<std::string>& transactionHashes) {
+MerkleTree::MerkleTree(const std::vector<crypto::Hash256>& transactionHashes)
+    : leafCount(transactionHashes.size()) {
     if (transactionHashes.empty()) {
-        root = "0000000000000000000000000000000000000000000000000000000000000000";
         return;
     }
     
-    leaves = transactionHashes;
-    root = buildTreeIterative(leaves);
+    layoutLevels(leafCount);
+    std::copy(transactionHashes.begin(), transactionHashes.end(), nodes.begin());
+    buildLevels();
 }
 
-std::string MerkleTree::buildTreeIterative(std::vector<std::string> nodes) {
-    if (nodes.empty()) {
-        return "0000000000000000000000000000000000000000000000000000000000000000";
+void MerkleTree::layoutLevels(size_t newCapacity) {
+    std::vector<size_t> offsets;
+    size_t offset = 0;
+    size_t width = newCapacity;
+    for (;;) {
+        offsets.push_back(offset);
+        if (width <= 1) {
+            offset += 1;
+            break;
+        }
+        // Room for the duplicate of an odd level's last node
+        offset += width + (width % 2);
+        width = (width + 1) / 2;
     }
     
-    if (nodes.size() == 1) {
-        return nodes[0];
+    // Move the levels already built into their new slots
+    std::vector<crypto::Hash256> resized(offset);
+    width = leafCount;
+    for (size_t level = 0; width > 0 && level < levelOffsets.size(); level++) {
+        const size_t used = width > 1 ? width + (width % 2) : 1;
+        std::copy(nodes.begin() + levelOffsets[level], nodes.begin() + levelOffsets[level] + used,
+                  resized.begin() + offsets[level]);
+        if (width == 1) {
+            break;
+        }
+        width = (width + 1) / 2;
     }
     
-    std::vector<std::string> currentLevel = nodes;
+    nodes.swap(resized);
+    levelOffsets.swap(offsets);
+    capacity = newCapacity;
+}
+
+void MerkleTree::buildLevels() {
+    std::vector<const uint8_t*> messages((leafCount + 1) / 2);
+    std::vector<size_t> lengths(messages.size(), 2 * crypto::Hash256::SIZE);
     
-    // Build tree level by level until we reach the root
-    while (currentLevel.size() > 1) {
+    size_t width = leafCount;
+    size_t level = 0;
+    for (; width > 1; level++) {
+        crypto::Hash256* current = nodes.data() + levelOffsets[level];
+        crypto::Hash256* parents = nodes.data() + levelOffsets[level + 1];
+        
         // If odd number of nodes, duplicate the last one
-        if (currentLevel.size() % 2 != 0) {
-            currentLevel.push_back(currentLevel.back());
+        if (width % 2 != 0) {
+            current[width] = current[width - 1];
         }
         
-        std::vector<std::string> nextLevel;
+        // Hash256 is 32 packed bytes, so each adjacent pair is already the
+        // 64-byte message for its parent; hash it into the next level
+        const size_t count = (width + 1) / 2;
+        parallelFor(count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                messages[i] = current[2 * i].data();
+            }
+            crypto::ChainHasher::hashBatch(messages.data() + begin, lengths.data() + begin,
+                                           end - begin, parents[begin].data());
+        });
+        width = count;
+    }
+    
+    root = nodes[levelOffsets[level]];
+}
+
+void MerkleTree::updatePath(size_t leafIndex) {
+    size_t position = leafIndex;
+    size_t width = leafCount;
+    size_t level = 0;
+    for (; width > 1; level++) {
+        crypto::Hash256* current = nodes.data() + levelOffsets[level];
         
-        // Combine pairs of nodes
-        for (size_t i = 0; i < currentLevel.size(); i += 2) {
-            std::string combined = currentLevel[i] + currentLevel[i + 1];
-            nextLevel.push_back(crypto::sha256(combined));
+        // Keep the duplicate of an odd level's last node in step
+        if (width % 2 != 0 && position == width - 1) {
+            current[width] = current[width - 1];
         }
         
-        currentLevel = nextLevel;
+        position /= 2;
+        nodes[levelOffsets[level + 1] + position] =
+            crypto::ChainHasher::digest(current[2 * position].data(), 2 * crypto::Hash256::SIZE);
+        width = (width + 1) / 2;
     }
     
-    return currentLevel[0];
+    root = nodes[levelOffsets[level]];
+}
+
+void MerkleTree::append(const crypto::Hash256& transactionHash) {
+    if (leafCount == capacity) {
+        layoutLevels(std::max<size_t>(1, 2 * capacity));
+    }
+    
+    nodes[leafCount] = transactionHash;
+    if (leafLookup.built) {
+        leafLookup.positions.emplace(transactionHash, leafCount);
+    }
+    leafCount++;
+    
+    // The new leaf is rightmost, so its path covers every node that changed
+    updatePath(leafCount - 1);
+}
+
+void MerkleTree::replace(size_t leafIndex, const crypto::Hash256& transactionHash) {
+    if (leafIndex >= leafCount) {
+        throw std::out_of_range("Merkle leaf index out of range");
+    }
+    
+    if (leafLookup.built) {
+        auto it = leafLookup.positions.find(nodes[leafIndex]);
+        if (it != leafLookup.positions.end() && it->second == leafIndex) {
+            leafLookup.positions.erase(it);
+        }
+        leafLookup.positions.emplace(transactionHash, leafIndex);
+    }
+    nodes[leafIndex] = transactionHash;
+    
+    updatePath(leafIndex);
+}
+
+std::vector<crypto::Hash256> MerkleTree::getLeaves() const {
+    return std::vector<crypto::Hash256>(nodes.begin(), nodes.begin() + leafCount);
 }
 
 void MerkleTree::display() const {
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║         MERKLE TREE                    ║" << std::endl;
     std::cout << "╠════════════════════════════════════════╣" << std::endl;
-    std::cout << "║ Leaves: " << std::setw(31) << std::left << leaves.size() << "║" << std::endl;
-    std::cout << "║ Root: " << root.substr(0, 32) << "║" << std::endl;
+    std::cout << "║ Leaves: " << std::setw(31) << std::left << leafCount << "║" << std::endl;
+    std::cout << "║ Root: " << root.toHex().substr(0, 32) << "║" << std::endl;
     std::cout << "╚════════════════════════════════════════╝" << std::endl;
 }
 
-bool MerkleTree::verifyTransaction(const std::string& transactionHash) const {
-    return std::find(leaves.begin(), leaves.end(), transactionHash) != leaves.end();
+MerkleTree::LeafIndex& MerkleTree::LeafIndex::operator=(const LeafIndex&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    built = false;
+    positions.clear();
+    return *this;
+}
+
+bool MerkleTree::lookupLeaf(const crypto::Hash256& transactionHash, size_t& index) const {
+    std::lock_guard<std::mutex> lock(leafLookup.mutex);
+    if (!leafLookup.built) {
+        leafLookup.positions.reserve(leafCount);
+        for (size_t i = 0; i < leafCount; i++) {
+            leafLookup.positions.emplace(nodes[i], i);
+        }
+        leafLookup.built = true;
+    }
+    auto it = leafLookup.positions.find(transactionHash);
+    if (it == leafLookup.positions.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+bool MerkleTree::verifyTransaction(const crypto::Hash256& transactionHash) const {
+    size_t index = 0;
+    return lookupLeaf(transactionHash, index);
+}
+
+bool MerkleTree::findLeaf(const crypto::Hash256& transactionHash, size_t& index) const {
+    return lookupLeaf(transactionHash, index);
+}
+
+MerkleProof MerkleTree::getProof(size_t leafIndex) const {
+    if (leafIndex >= leafCount) {
+        throw std::out_of_range("Merkle leaf index out of range");
+    }
+    
+    // Odd levels are padded, so every node below the root has a sibling
+    MerkleProof proof;
+    proof.leafIndex = static_cast<uint32_t>(leafIndex);
+    proof.leafCount = static_cast<uint32_t>(leafCount);
+    size_t position = leafIndex;
+    for (size_t level = 0, width = leafCount; width > 1; level++) {
+        proof.siblings.push_back(nodes[levelOffsets[level] + (position ^ 1)]);
+        position >>= 1;
+        width = (width + 1) / 2;
+    }
+    return proof;
+}
+
+bool MerkleTree::verifyProof(const crypto::Hash256& leaf, const MerkleProof& proof,
+                             const crypto::Hash256& root) {
+    if (proof.leafIndex >= proof.leafCount) {
+        return false;
+    }
+    
+    crypto::Hash256 pair[2];
+    crypto::Hash256 current = leaf;
+    size_t position = proof.leafIndex;
+    size_t width = proof.leafCount;
+    size_t level = 0;
+    for (; width > 1; level++) {
+        if (level == proof.siblings.size()) {
+            return false;
+        }
+        const crypto::Hash256& sibling = proof.siblings[level];
+        const bool right = (position & 1) != 0;
+        const bool padded = !right && position == width - 1;
+        if (padded != (sibling == current)) {
+            return false;
+        }
+        pair[right ? 1 : 0] = current;
+        pair[right ? 0 : 1] = sibling;
+        current = crypto::ChainHasher::digest(pair[0].data(), 2 * crypto::Hash256::SIZE);
+        position >>= 1;
+        width = (width + 1) / 2;
+    }
+    return level == proof.siblings.size() && current == root;
 }
 
 } // namespace blockchain
\ No newline at end of file
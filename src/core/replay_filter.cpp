@@ -0,0 +1,280 @@
+/**
+ * @file replay_filter.cpp
+ * @brief Implementation of CuckooFilter and ReplayFilter
+ */
+
+#include "core/replay_filter.h"
+#include <algorithm>
+#include <utility>
+
+namespace blockchain {
+
+namespace {
+
+void storeLE(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+/**
+ * @brief Read a little-endian field if it is in bounds, advancing offset
+ */
+bool readLE(const uint8_t* data, size_t length, size_t& offset, size_t bytes, uint64_t& value) {
+    if (length - offset < bytes) {
+        return false;
+    }
+    value = loadLE(data + offset, bytes);
+    offset += bytes;
+    return true;
+}
+
+size_t bucketCountFor(size_t capacity) {
+    // Keep the load at or below ~95%, where inserts still succeed reliably
+    size_t needed = (capacity * 20 / 19 + CuckooFilter::BUCKET_SIZE - 1) / CuckooFilter::BUCKET_SIZE;
+    size_t buckets = 1;
+    while (buckets < needed) {
+        buckets <<= 1;
+    }
+    return buckets;
+}
+
+} // namespace
+
+CuckooFilter::CuckooFilter(size_t capacity)
+    : capacity(capacity), bucketMask(bucketCountFor(capacity) - 1) {
+}
+
+uint16_t CuckooFilter::fingerprintOf(const crypto::Hash256& digest) {
+    // Bytes 0-7 pick the bucket; the fingerprint comes from independent bytes
+    uint16_t fingerprint = static_cast<uint16_t>(digest.bytes[8] | (digest.bytes[9] << 8));
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+size_t CuckooFilter::alternateBucket(size_t bucket, uint16_t fingerprint) const {
+    // Involution: applying it twice gives the original bucket back
+    return (bucket ^ (static_cast<uint64_t>(fingerprint) * 0x5bd1e995u)) & bucketMask;
+}
+
+bool CuckooFilter::bucketHas(size_t bucket, uint16_t fingerprint) const {
+    const uint16_t* slot = &slots[bucket * BUCKET_SIZE];
+    for (size_t i = 0; i < BUCKET_SIZE; i++) {
+        if (slot[i] == fingerprint) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::bucketAdd(size_t bucket, uint16_t fingerprint) {
+    uint16_t* slot = &slots[bucket * BUCKET_SIZE];
+    for (size_t i = 0; i < BUCKET_SIZE; i++) {
+        if (slot[i] == 0) {
+            slot[i] = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::insert(const crypto::Hash256& digest) {
+    if (hasVictim) {
+        return false;
+    }
+    if (slots.empty()) {
+        slots.assign((bucketMask + 1) * BUCKET_SIZE, 0);
+    }
+
+    uint16_t fingerprint = fingerprintOf(digest);
+    size_t bucket = loadLE(digest.data(), 8) & bucketMask;
+    if (bucketAdd(bucket, fingerprint) || bucketAdd(alternateBucket(bucket, fingerprint), fingerprint)) {
+        count++;
+        return true;
+    }
+
+    // Both buckets full: displace fingerprints to their alternate buckets
+    bucket = alternateBucket(bucket, fingerprint);
+    for (size_t kick = 0; kick < MAX_KICKS; kick++) {
+        std::swap(fingerprint, slots[bucket * BUCKET_SIZE + kick % BUCKET_SIZE]);
+        bucket = alternateBucket(bucket, fingerprint);
+        if (bucketAdd(bucket, fingerprint)) {
+            count++;
+            return true;
+        }
+    }
+
+    // Park the last displaced fingerprint so nothing already added is lost
+    victim = fingerprint;
+    victimBucket = bucket;
+    hasVictim = true;
+    count++;
+    return false;
+}
+
+bool CuckooFilter::contains(const crypto::Hash256& digest) const {
+    if (slots.empty()) {
+        return false;
+    }
+    const uint16_t fingerprint = fingerprintOf(digest);
+    const size_t bucket = loadLE(digest.data(), 8) & bucketMask;
+    const size_t alternate = alternateBucket(bucket, fingerprint);
+    if (hasVictim && victim == fingerprint && (victimBucket == bucket || victimBucket == alternate)) {
+        return true;
+    }
+    return bucketHas(bucket, fingerprint) || bucketHas(alternate, fingerprint);
+}
+
+void CuckooFilter::clear() {
+    std::fill(slots.begin(), slots.end(), 0);
+    count = 0;
+    hasVictim = false;
+}
+
+void CuckooFilter::encode(std::vector<uint8_t>& out) const {
+    storeLE(out, capacity, 8);
+    storeLE(out, count, 8);
+    storeLE(out, hasVictim ? 1 : 0, 1);
+    storeLE(out, victim, 2);
+    storeLE(out, victimBucket, 8);
+    storeLE(out, slots.size(), 8);
+    for (uint16_t slot : slots) {
+        storeLE(out, slot, 2);
+    }
+}
+
+bool CuckooFilter::decode(const uint8_t* data, size_t length, size_t& offset) {
+    uint64_t fields[6];
+    const size_t widths[6] = {8, 8, 1, 2, 8, 8};
+    for (size_t i = 0; i < 6; i++) {
+        if (!readLE(data, length, offset, widths[i], fields[i])) {
+            return false;
+        }
+    }
+    const size_t buckets = bucketCountFor(static_cast<size_t>(fields[0]));
+    const uint64_t slotCount = fields[5];
+    if ((slotCount != 0 && slotCount != buckets * BUCKET_SIZE) || fields[4] >= buckets ||
+        (length - offset) / 2 < slotCount) {
+        return false;
+    }
+
+    capacity = static_cast<size_t>(fields[0]);
+    bucketMask = buckets - 1;
+    count = static_cast<size_t>(fields[1]);
+    hasVictim = fields[2] != 0;
+    victim = static_cast<uint16_t>(fields[3]);
+    victimBucket = static_cast<size_t>(fields[4]);
+    slots.resize(static_cast<size_t>(slotCount));
+    for (auto& slot : slots) {
+        slot = static_cast<uint16_t>(loadLE(data + offset, 2));
+        offset += 2;
+    }
+    return true;
+}
+
+ReplayFilter::ReplayFilter(size_t windowBlocks, size_t filterCapacity)
+    : windowBlocks(std::max<size_t>(1, windowBlocks)), current(filterCapacity), previous(filterCapacity) {
+}
+
+ReplayCheck ReplayFilter::check(const crypto::Hash256& id) const {
+    if (recent.count(id) != 0) {
+        return ReplayCheck::CONFIRMED;
+    }
+    if (current.contains(id) || previous.contains(id)) {
+        return ReplayCheck::POSSIBLE;
+    }
+    return ReplayCheck::ABSENT;
+}
+
+void ReplayFilter::recordBlock(const std::vector<crypto::Hash256>& ids) {
+    recent.insert(ids.begin(), ids.end());
+    recentBlocks.push_back(ids);
+    if (recentBlocks.size() > windowBlocks) {
+        retire(recentBlocks.front());
+        recentBlocks.pop_front();
+    }
+}
+
+void ReplayFilter::retire(const std::vector<crypto::Hash256>& ids) {
+    currentBlocks++;
+    for (const auto& id : ids) {
+        recent.erase(id);
+        if (current.isFull()) {
+            // Drop the oldest generation; the full one keeps answering.
+            // A block split across both generations is counted in each.
+            std::swap(current, previous);
+            current.clear();
+            previousBlocks = currentBlocks;
+            currentBlocks = 1;
+        }
+        current.insert(id);
+    }
+}
+
+void ReplayFilter::clear() {
+    recentBlocks.clear();
+    recent.clear();
+    current.clear();
+    previous.clear();
+    currentBlocks = 0;
+    previousBlocks = 0;
+}
+
+void ReplayFilter::encode(std::vector<uint8_t>& out) const {
+    storeLE(out, windowBlocks, 8);
+    storeLE(out, recentBlocks.size(), 8);
+    for (const auto& ids : recentBlocks) {
+        storeLE(out, ids.size(), 4);
+        for (const auto& id : ids) {
+            out.insert(out.end(), id.bytes.begin(), id.bytes.end());
+        }
+    }
+    current.encode(out);
+    previous.encode(out);
+    storeLE(out, currentBlocks, 8);
+    storeLE(out, previousBlocks, 8);
+}
+
+bool ReplayFilter::decode(const uint8_t* data, size_t length, size_t& offset) {
+    clear();
+    uint64_t window = 0;
+    uint64_t blocks = 0;
+    if (!readLE(data, length, offset, 8, window) || !readLE(data, length, offset, 8, blocks) ||
+        window == 0 || blocks > window) {
+        return false;
+    }
+    windowBlocks = static_cast<size_t>(window);
+    for (uint64_t b = 0; b < blocks; b++) {
+        uint64_t count = 0;
+        if (!readLE(data, length, offset, 4, count) || (length - offset) / crypto::Hash256::SIZE < count) {
+            clear();
+            return false;
+        }
+        std::vector<crypto::Hash256> ids(static_cast<size_t>(count));
+        for (auto& id : ids) {
+            std::copy(data + offset, data + offset + crypto::Hash256::SIZE, id.bytes.begin());
+            offset += crypto::Hash256::SIZE;
+        }
+        recent.insert(ids.begin(), ids.end());
+        recentBlocks.push_back(std::move(ids));
+    }
+    uint64_t currentCount = 0;
+    uint64_t previousCount = 0;
+    if (!current.decode(data, length, offset) || !previous.decode(data, length, offset) ||
+        !readLE(data, length, offset, 8, currentCount) || !readLE(data, length, offset, 8, previousCount)) {
+        clear();
+        return false;
+    }
+    currentBlocks = static_cast<size_t>(currentCount);
+    previousBlocks = static_cast<size_t>(previousCount);
+    return true;
+}
+
+} // namespace blockchain
@@ -4,53 +4,119 @@
  */
 
 #include "core/transaction.h"
-#include "crypto/sha256.h"
-#include <sstream>
-#include <iomanip>
+#include "crypto/hash_policy.h"
+#include "crypto/hex.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 
 namespace blockchain {
 
+namespace {
+
+/**
+ * @brief Next per-process sequence number
+ *
+ * Seeded from the clock so separate processes are unlikely to overlap.
+ */
+uint64_t nextSequence() {
+    static std::atomic<uint64_t> counter(static_cast<uint64_t>(
+        std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+Amount coinsToUnits(double coins) {
+    Amount units = 0;
+    if (!toAmount(coins, units)) {
+        throw std::invalid_argument("Transaction amount out of range");
+    }
+    return units;
+}
+
+void storeLE64(uint8_t* out, uint64_t value) {
+    for (size_t i = 0; i < 8; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+} // namespace
+
 Transaction::Transaction(const std::string& sender, 
                         const std::string& receiver, 
                         double amount)
-    : sender(sender), receiver(receiver), amount(amount) {
-    timestamp = std::time(nullptr);
-    id = generateId();
+    : Transaction(sender, receiver, coinsToUnits(amount), std::time(nullptr), nextSequence()) {
 }
 
-std::string Transaction::generateId() {
-    std::stringstream ss;
-    ss << sender << receiver << amount << timestamp;
-    std::string hash = crypto::sha256(ss.str());
-    return hash.substr(0, 16); // Use first 16 characters as ID
+Transaction::Transaction(std::string_view sender, std::string_view receiver, Amount amount,
+                         time_t timestamp, uint64_t sequence)
+    : amount(amount), timestamp(timestamp), sequence(sequence) {
+    if (sender.size() > MAX_ADDRESS_LENGTH || receiver.size() > MAX_ADDRESS_LENGTH) {
+        throw std::invalid_argument("Transaction address too long");
+    }
+    AddressTable& addresses = AddressTable::instance();
+    this->sender = addresses.intern(sender);
+    this->receiver = addresses.intern(receiver);
+    computeDigest();
 }
 
-std::string Transaction::toString() const {
-    std::stringstream ss;
-    ss << id << ":" << sender << "->" << receiver << ":" 
-       << std::fixed << std::setprecision(8) << amount;
-    return ss.str();
+Transaction Transaction::fromUnits(const std::string& sender, const std::string& receiver, Amount amount) {
+    return Transaction(sender, receiver, amount, std::time(nullptr), nextSequence());
+}
+
+void Transaction::encode(uint8_t* out) const {
+    out[0] = ENCODING_VERSION;
+    storeLE64(out + 1, static_cast<uint64_t>(timestamp));
+    storeLE64(out + 9, sequence);
+    storeLE64(out + 17, static_cast<uint64_t>(amount));
+    
+    const std::string& from = getSender();
+    const std::string& to = getReceiver();
+    uint8_t* p = out + 25;
+    *p++ = static_cast<uint8_t>(from.size());
+    std::memcpy(p, from.data(), from.size());
+    p += from.size();
+    *p++ = static_cast<uint8_t>(to.size());
+    std::memcpy(p, to.data(), to.size());
+    p += to.size();
+    
+    // Witness section, outside the hashed body
+    *p++ = hasSignature ? 1 : 0;
+    if (hasSignature) {
+        std::memcpy(p, signature.data(), signature.size());
+    }
 }
 
-std::string Transaction::getHash() const {
-    return crypto::sha256(toString());
+void Transaction::computeDigest() {
+    uint8_t encoded[MAX_ENCODED_SIZE];
+    encode(encoded);
+    hash = crypto::ChainHasher::digest(encoded, bodySize());
+}
+
+std::string Transaction::toString() const {
+    return getId() + ":" + getSender() + "->" + getReceiver() + ":" + formatAmount(amount);
 }
 
 void Transaction::display() const {
-    std::cout << "  [" << id << "] " 
-              << sender << " → " << receiver 
-              << " : " << std::fixed << std::setprecision(8) 
-              << amount << " BTC" << std::endl;
+    std::cout << "  [" << getId().substr(0, 16) << "] " 
+              << getSender() << " → " << getReceiver() 
+              << " : " << formatAmount(amount) << " BTC" << std::endl;
 }
 
 bool Transaction::isValid() const {
+    // Same rules as isValidTransfer(), on interned IDs
+    return sender != AddressTable::EMPTY && receiver != AddressTable::EMPTY &&
+           sender != receiver && amount > 0 && amount <= MAX_MONEY;
+}
+
+bool Transaction::isValidTransfer(std::string_view sender, std::string_view receiver, Amount amount) {
     // Basic validation rules
     if (sender.empty() || receiver.empty()) {
         return false;
     }
     
-    if (amount <= 0) {
+    if (amount <= 0 || amount > MAX_MONEY) {
         return false;
     }
     
@@ -61,4 +127,55 @@ bool Transaction::isValid() const {
     return true;
 }
 
-} // namespace blockchain
\ No newline at end of file
+std::string Transaction::addressOf(const crypto::Ed25519::PublicKey& publicKey) {
+    return crypto::toHex(publicKey);
+}
+
+void Transaction::sign(const crypto::Ed25519::KeyPair& key) {
+    if (getSender() != addressOf(key.getPublicKey())) {
+        throw std::invalid_argument("Signing key does not match the sender address");
+    }
+    signature = key.sign(hash.data(), crypto::Hash256::SIZE);
+    hasSignature = true;
+}
+
+bool Transaction::getSenderKey(crypto::Ed25519::PublicKey& publicKey) const {
+    const std::string& address = getSender();
+    return crypto::fromHex(address.data(), address.size(), publicKey.data(), publicKey.size());
+}
+
+bool Transaction::verifySignature() const {
+    crypto::Ed25519::PublicKey publicKey;
+    return hasSignature && getSenderKey(publicKey) &&
+           crypto::Ed25519::verify(publicKey, hash.data(), crypto::Hash256::SIZE, signature);
+}
+
+bool Transaction::verifySignatures(const std::vector<Transaction>& transactions, bool requireSigned) {
+    std::vector<crypto::Ed25519::PublicKey> keys;
+    std::vector<const Transaction*> signedTxs;
+    keys.reserve(transactions.size());
+    signedTxs.reserve(transactions.size());
+    
+    for (const auto& tx : transactions) {
+        if (!tx.hasSignature) {
+            if (requireSigned) {
+                return false;
+            }
+            continue;
+        }
+        keys.emplace_back();
+        if (!tx.getSenderKey(keys.back())) {
+            return false;
+        }
+        signedTxs.push_back(&tx);
+    }
+    
+    // Entries point into keys, which no longer grows
+    std::vector<crypto::Ed25519::BatchEntry> batch(signedTxs.size());
+    for (size_t i = 0; i < signedTxs.size(); i++) {
+        batch[i] = {&keys[i], &signedTxs[i]->signature, signedTxs[i]->hash.data(), crypto::Hash256::SIZE};
+    }
+    return crypto::Ed25519::verifyBatch(batch.data(), batch.size());
+}
+
+} // namespace blockchain
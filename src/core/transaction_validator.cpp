@@ -0,0 +1,223 @@
+/**
+ * @file transaction_validator.cpp
+ * @brief Implementation of TransactionValidator and ValidatedCache
+ */
+
+#include "core/transaction_validator.h"
+#include "crypto/hash_policy.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace blockchain {
+
+namespace {
+
+constexpr size_t NO_FAILURE = std::numeric_limits<size_t>::max();
+
+/// First failure found in one chunk
+struct ChunkFailure {
+    size_t index = NO_FAILURE;
+    const char* reason = "";
+};
+
+void lowerFailure(std::atomic<size_t>& failure, size_t index) {
+    size_t current = failure.load(std::memory_order_relaxed);
+    while (index < current &&
+           !failure.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+ValidatedCache::ValidatedCache(size_t capacity)
+    : shardCapacity(std::max<size_t>(1, capacity / SHARDS)) {
+}
+
+crypto::Hash256 ValidatedCache::keyOf(const Transaction& tx) {
+    if (!tx.isSigned()) {
+        return tx.getHash();
+    }
+    uint8_t witness[crypto::Hash256::SIZE + crypto::Ed25519::SIGNATURE_SIZE];
+    std::memcpy(witness, tx.getHash().data(), crypto::Hash256::SIZE);
+    std::memcpy(witness + crypto::Hash256::SIZE, tx.getSignature().data(), crypto::Ed25519::SIGNATURE_SIZE);
+    return crypto::ChainHasher::digest(witness, sizeof(witness));
+}
+
+bool ValidatedCache::contains(const Transaction& tx) const {
+    const crypto::Hash256 key = keyOf(tx);
+    const Shard& shard = shards[shardIndex(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.keys.count(key) != 0;
+}
+
+void ValidatedCache::insert(const Transaction& tx) {
+    const crypto::Hash256 key = keyOf(tx);
+    Shard& shard = shards[shardIndex(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.keys.insert(key).second) {
+        return;
+    }
+    shard.order.push_back(key);
+    if (shard.order.size() > shardCapacity) {
+        shard.keys.erase(shard.order.front());
+        shard.order.pop_front();
+    }
+}
+
+void ValidatedCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.keys.clear();
+        shard.order.clear();
+    }
+}
+
+size_t ValidatedCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.keys.size();
+    }
+    return total;
+}
+
+TransactionValidator::TransactionValidator(unsigned threads, size_t cacheCapacity)
+    : threads(threads) {
+    if (cacheCapacity > 0) {
+        cache.reset(new ValidatedCache(cacheCapacity));
+    }
+}
+
+ValidationResult TransactionValidator::validate(const std::vector<Transaction>& transactions,
+                                                bool requireSigned) {
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    return run(transactions, requireSigned, threads == 0 ? hardware : threads);
+}
+
+ValidationResult TransactionValidator::validateSerial(const std::vector<Transaction>& transactions,
+                                                      bool requireSigned) {
+    return run(transactions, requireSigned, 1);
+}
+
+ValidationResult TransactionValidator::run(const std::vector<Transaction>& transactions,
+                                           bool requireSigned, size_t workers) {
+    ValidationResult result;
+    const size_t count = transactions.size();
+    const size_t chunks = (count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+    if (chunks == 0) {
+        return result;
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<size_t> failure(NO_FAILURE);
+    std::atomic<size_t> cacheHits(0);
+    std::vector<ChunkFailure> failures(chunks);
+    ValidatedCache* validated = cache.get();
+
+    auto worker = [&]() {
+        std::vector<crypto::Ed25519::PublicKey> keys;
+        std::vector<size_t> signedIndices;
+        std::vector<size_t> checked;
+        std::vector<crypto::Ed25519::BatchEntry> batch;
+
+        for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            // Chunks are claimed in order, so every later one is past the failure too
+            const size_t begin = chunk * PARALLEL_GRAIN;
+            if (begin > failure.load(std::memory_order_relaxed)) {
+                break;
+            }
+            const size_t end = std::min(count, begin + PARALLEL_GRAIN);
+            ChunkFailure& chunkFailure = failures[chunk];
+            keys.clear();
+            signedIndices.clear();
+            checked.clear();
+            size_t hits = 0;
+            bool skipped = false;
+
+            // Transfer rules first; collect signatures for one batch
+            for (size_t i = begin; i < end; i++) {
+                if (i > failure.load(std::memory_order_relaxed)) {
+                    skipped = true;
+                    break;
+                }
+                const Transaction& tx = transactions[i];
+                if (requireSigned && !tx.isSigned()) {
+                    chunkFailure = {i, "transaction is not signed"};
+                    break;
+                }
+                if (validated != nullptr && validated->contains(tx)) {
+                    hits++;
+                    continue;
+                }
+                if (!tx.isValid()) {
+                    chunkFailure = {i, "invalid transfer"};
+                    break;
+                }
+                if (tx.isSigned()) {
+                    keys.emplace_back();
+                    if (!tx.getSenderKey(keys.back())) {
+                        chunkFailure = {i, "sender is not a public key"};
+                        break;
+                    }
+                    signedIndices.push_back(i);
+                }
+                checked.push_back(i);
+            }
+            cacheHits += hits;
+            if (skipped) {
+                break;
+            }
+
+            // Every collected signature precedes any rule failure in this chunk
+            batch.resize(signedIndices.size());
+            for (size_t k = 0; k < signedIndices.size(); k++) {
+                const Transaction& tx = transactions[signedIndices[k]];
+                batch[k] = {&keys[k], &tx.getSignature(), tx.getHash().data(), crypto::Hash256::SIZE};
+            }
+            if (!crypto::Ed25519::verifyBatch(batch.data(), batch.size())) {
+                for (size_t k = 0; k < batch.size(); k++) {
+                    if (!crypto::Ed25519::verify(*batch[k].publicKey, batch[k].message, batch[k].length,
+                                                 *batch[k].signature)) {
+                        chunkFailure = {signedIndices[k], "invalid signature"};
+                        break;
+                    }
+                }
+            }
+
+            if (chunkFailure.index != NO_FAILURE) {
+                lowerFailure(failure, chunkFailure.index);
+                break;
+            }
+            if (validated != nullptr) {
+                for (size_t i : checked) {
+                    validated->insert(transactions[i]);
+                }
+            }
+        }
+    };
+
+    workers = std::min(workers, chunks);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t i = 1; i < workers; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    result.cacheHits = cacheHits.load();
+    const size_t failedIndex = failure.load();
+    if (failedIndex != NO_FAILURE) {
+        result.valid = false;
+        result.failedIndex = failedIndex;
+        result.reason = failures[failedIndex / PARALLEL_GRAIN].reason;
+    }
+    return result;
+}
+
+} // namespace blockchain
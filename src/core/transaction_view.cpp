@@ -0,0 +1,99 @@
+/**
+ * @file transaction_view.cpp
+ * @brief Implementation of TransactionView
+ */
+
+#include "core/transaction_view.h"
+#include "crypto/hash_policy.h"
+#include <algorithm>
+
+namespace blockchain {
+
+namespace {
+
+constexpr size_t SENDER_LENGTH_OFFSET = 25;
+
+uint64_t loadLE64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+bool TransactionView::parse(const uint8_t* buffer, size_t length, TransactionView& view) {
+    if (length < Transaction::MIN_ENCODED_SIZE || buffer[0] != Transaction::ENCODING_VERSION) {
+        return false;
+    }
+
+    // Both lengths fit in one byte, so the sums cannot overflow
+    const size_t senderLength = buffer[SENDER_LENGTH_OFFSET];
+    if (length < Transaction::MIN_ENCODED_SIZE + senderLength) {
+        return false;
+    }
+    const size_t receiverLength = buffer[SENDER_LENGTH_OFFSET + 1 + senderLength];
+    const size_t body = Transaction::MIN_BODY_SIZE + senderLength + receiverLength;
+    if (length < body + 1 || buffer[body] > 1) {
+        return false;
+    }
+    const size_t total = body + 1 + (buffer[body] != 0 ? crypto::Ed25519::SIGNATURE_SIZE : 0);
+    if (length < total) {
+        return false;
+    }
+
+    view.data = buffer;
+    view.size = total;
+    view.bodySize = body;
+    return true;
+}
+
+time_t TransactionView::getTimestamp() const {
+    return static_cast<time_t>(static_cast<int64_t>(loadLE64(data + 1)));
+}
+
+uint64_t TransactionView::getSequence() const {
+    return loadLE64(data + 9);
+}
+
+Amount TransactionView::getAmount() const {
+    return static_cast<Amount>(loadLE64(data + 17));
+}
+
+std::string_view TransactionView::getSender() const {
+    return std::string_view(reinterpret_cast<const char*>(data + SENDER_LENGTH_OFFSET + 1),
+                            data[SENDER_LENGTH_OFFSET]);
+}
+
+std::string_view TransactionView::getReceiver() const {
+    const size_t offset = SENDER_LENGTH_OFFSET + 1 + data[SENDER_LENGTH_OFFSET];
+    return std::string_view(reinterpret_cast<const char*>(data + offset + 1), data[offset]);
+}
+
+crypto::Ed25519::Signature TransactionView::getSignature() const {
+    crypto::Ed25519::Signature signature{};
+    if (isSigned()) {
+        std::copy(data + bodySize + 1, data + bodySize + 1 + signature.size(), signature.begin());
+    }
+    return signature;
+}
+
+crypto::Hash256 TransactionView::computeHash() const {
+    return crypto::ChainHasher::digest(data, bodySize);
+}
+
+bool TransactionView::isValid() const {
+    return Transaction::isValidTransfer(getSender(), getReceiver(), getAmount());
+}
+
+Transaction TransactionView::toTransaction() const {
+    Transaction tx(getSender(), getReceiver(), getAmount(), getTimestamp(), getSequence());
+    if (isSigned()) {
+        tx.signature = getSignature();
+        tx.hasSignature = true;
+    }
+    return tx;
+}
+
+} // namespace blockchain
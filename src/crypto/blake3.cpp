@@ -0,0 +1,420 @@
+/**
+ * @file blake3.cpp
+ * @brief Implementation of BLAKE3 cryptographic hash function
+ */
+
+#include "crypto/blake3.h"
+#include "crypto/cpu_features.h"
+#include "crypto/hex.h"
+#include "blake3_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace crypto {
+
+using detail::BLAKE3_IV;
+using detail::BLAKE3_CHUNK_START;
+using detail::BLAKE3_CHUNK_END;
+using detail::BLAKE3_PARENT;
+using detail::BLAKE3_ROOT;
+
+namespace {
+
+/**
+ * @brief One-lane "vector" so the portable path shares compressLanes()
+ */
+struct Scalar {
+    using Reg = uint32_t;
+    static constexpr size_t LANES = 1;
+
+    static Reg load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, Reg x) { *p = x; }
+    static Reg set1(uint32_t x) { return x; }
+    static Reg add(Reg x, Reg y) { return x + y; }
+    static Reg bxor(Reg x, Reg y) { return x ^ y; }
+
+    template <int N>
+    static Reg rotr(Reg x) { return (x >> N) | (x << (32 - N)); }
+
+    static Reg gatherLE32(const uint8_t* const* blocks, int offset) {
+        return detail::loadLE32(blocks[0] + offset);
+    }
+};
+
+void compressScalarLane(uint32_t* cv, const uint8_t* const* blocks,
+                        const uint32_t* blockLengths, const uint32_t* flags) {
+    static const uint32_t zero = 0;
+    detail::compressLanes<Scalar>(cv, blocks, &zero, &zero, blockLengths, flags);
+}
+
+void storeDigest(const uint32_t* words, size_t stride, uint8_t* out) {
+    for (int i = 0; i < 8; i++) {
+        uint32_t word = words[i * stride];
+        out[i * 4] = static_cast<uint8_t>(word);
+        out[i * 4 + 1] = static_cast<uint8_t>(word >> 8);
+        out[i * 4 + 2] = static_cast<uint8_t>(word >> 16);
+        out[i * 4 + 3] = static_cast<uint8_t>(word >> 24);
+    }
+}
+
+/**
+ * @brief Chaining value of a parent node
+ */
+void parentCv(const uint32_t left[8], const uint32_t right[8], uint32_t flags, uint32_t out[8]) {
+    uint8_t block[64];
+    storeDigest(left, 1, block);
+    storeDigest(right, 1, block + 32);
+    std::copy(BLAKE3_IV, BLAKE3_IV + 8, out);
+    const uint8_t* blocks[1] = {block};
+    const uint32_t length = 64;
+    const uint32_t parentFlags = BLAKE3_PARENT | flags;
+    compressScalarLane(out, blocks, &length, &parentFlags);
+}
+
+} // namespace
+
+void Blake3::compress(uint32_t cv[8], const uint8_t block[64], uint64_t counter,
+                      uint32_t blockLength, uint32_t flags) {
+    const uint32_t counterLow = static_cast<uint32_t>(counter);
+    const uint32_t counterHigh = static_cast<uint32_t>(counter >> 32);
+    const uint8_t* blocks[1] = {block};
+    detail::compressLanes<Scalar>(cv, blocks, &counterLow, &counterHigh, &blockLength, &flags);
+}
+
+Blake3::Blake3() {
+    reset();
+}
+
+void Blake3::reset() {
+    std::copy(BLAKE3_IV, BLAKE3_IV + 8, cv);
+    bufferLength = 0;
+    blocksCompressed = 0;
+    chunkCounter = 0;
+    cvStackLength = 0;
+}
+
+void Blake3::addChunkChainingValue(uint32_t chunkCv[8], uint64_t totalChunks) {
+    // Each trailing zero bit of the chunk count completes one subtree
+    while ((totalChunks & 1) == 0) {
+        cvStackLength--;
+        parentCv(cvStack[cvStackLength], chunkCv, 0, chunkCv);
+        totalChunks >>= 1;
+    }
+    std::copy(chunkCv, chunkCv + 8, cvStack[cvStackLength]);
+    cvStackLength++;
+}
+
+void Blake3::update(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        // The last block of a chunk is only compressed once more input shows it is not the root
+        if (blocksCompressed * BLOCK_SIZE + bufferLength == CHUNK_SIZE) {
+            uint32_t chunkCv[8];
+            std::copy(cv, cv + 8, chunkCv);
+            compress(chunkCv, buffer, chunkCounter, BLOCK_SIZE, BLAKE3_CHUNK_END);
+            chunkCounter++;
+            addChunkChainingValue(chunkCv, chunkCounter);
+
+            std::copy(BLAKE3_IV, BLAKE3_IV + 8, cv);
+            blocksCompressed = 0;
+            bufferLength = 0;
+        }
+
+        if (bufferLength == BLOCK_SIZE) {
+            compress(cv, buffer, chunkCounter, BLOCK_SIZE,
+                     blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0);
+            blocksCompressed++;
+            bufferLength = 0;
+        }
+
+        size_t take = std::min(BLOCK_SIZE - bufferLength, length);
+        std::memcpy(buffer + bufferLength, data, take);
+        bufferLength += take;
+        data += take;
+        length -= take;
+    }
+}
+
+void Blake3::update(const std::string& data) {
+    update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+Blake3::Digest Blake3::finalize() const {
+    uint8_t block[64] = {};
+    std::memcpy(block, buffer, bufferLength);
+
+    uint32_t out[8];
+    std::copy(cv, cv + 8, out);
+    uint32_t flags = BLAKE3_CHUNK_END | (blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0);
+
+    if (cvStackLength == 0) {
+        // Single chunk: its last block is the root
+        compress(out, block, 0, static_cast<uint32_t>(bufferLength), flags | BLAKE3_ROOT);
+    } else {
+        compress(out, block, chunkCounter, static_cast<uint32_t>(bufferLength), flags);
+        for (size_t i = cvStackLength; i-- > 0;) {
+            parentCv(cvStack[i], out, i == 0 ? BLAKE3_ROOT : 0, out);
+        }
+    }
+
+    Digest result;
+    storeDigest(out, 1, result.data());
+    return result;
+}
+
+Blake3::Digest Blake3::digest(const uint8_t* data, size_t length) {
+    Blake3 hasher;
+    hasher.update(data, length);
+    return hasher.finalize();
+}
+
+Blake3::Digest Blake3::digest(const std::string& input) {
+    return digest(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+std::string Blake3::hash(const std::string& input) {
+    return toHex(digest(input));
+}
+
+// ============================================================================
+// Batch hashing
+// ============================================================================
+
+namespace {
+
+constexpr size_t MAX_LANES = 16;
+
+/**
+ * @brief First-chunk state shared by every message of a batch
+ */
+struct Prefix {
+    const uint32_t* cv;
+    const uint8_t* buffer;
+    size_t bufferLength;
+    size_t blocksCompressed;
+};
+
+/**
+ * @brief One message in flight inside a multi-buffer lane
+ *
+ * The lane's input is the prefix buffer followed by the message; blocks
+ * that straddle the two, or are short, are assembled in scratch.
+ */
+struct Lane {
+    bool active = false;
+    size_t message = 0;           ///< Index of the message in the batch
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t totalBlocks = 0;       ///< Blocks to compress for this message
+    size_t next = 0;              ///< Next block to compress
+    uint8_t scratch[64];
+
+    void load(const Prefix& prefix, const uint8_t* msg, size_t len) {
+        data = msg;
+        length = len;
+        next = 0;
+        size_t total = prefix.bufferLength + len;
+        totalBlocks = std::max<size_t>(1, (total + 63) / 64);
+    }
+
+    const uint8_t* block(const Prefix& prefix, size_t i, uint32_t& blockLength, uint32_t& flags) {
+        const size_t total = prefix.bufferLength + length;
+        const size_t start = i * 64;
+        blockLength = static_cast<uint32_t>(std::min<size_t>(64, total - start));
+        flags = (prefix.blocksCompressed + i == 0 ? BLAKE3_CHUNK_START : 0) |
+                (i + 1 == totalBlocks ? BLAKE3_CHUNK_END | BLAKE3_ROOT : 0);
+
+        if (start >= prefix.bufferLength && blockLength == 64) {
+            return data + (start - prefix.bufferLength);
+        }
+
+        std::memset(scratch, 0, sizeof(scratch));
+        size_t filled = 0;
+        if (start < prefix.bufferLength) {
+            filled = std::min<size_t>(blockLength, prefix.bufferLength - start);
+            std::memcpy(scratch, prefix.buffer + start, filled);
+        }
+        if (filled < blockLength) {
+            size_t offset = start + filled - prefix.bufferLength;
+            std::memcpy(scratch + filled, data + offset, blockLength - filled);
+        }
+        return scratch;
+    }
+};
+
+void runMultiBuffer(detail::Blake3MultiFn kernel, size_t lanes, const Blake3& hasher,
+                    const Prefix& prefix, const uint8_t* const* messages, const size_t* lengths,
+                    size_t count, uint8_t* digests) {
+    static const uint8_t idleBlock[64] = {};
+    const size_t prefixLength = prefix.blocksCompressed * 64 + prefix.bufferLength;
+
+    uint32_t cv[8 * MAX_LANES];
+    uint32_t blockLengths[MAX_LANES] = {};
+    uint32_t flags[MAX_LANES] = {};
+    const uint8_t* blocks[MAX_LANES];
+    Lane lane[MAX_LANES];
+    size_t nextMessage = 0;
+    size_t active = 0;
+
+    auto assign = [&](size_t l) {
+        // Messages that spill into a second chunk take the tree path
+        while (nextMessage < count && prefixLength + lengths[nextMessage] > Blake3::CHUNK_SIZE) {
+            Blake3 copy = hasher;
+            copy.update(messages[nextMessage], lengths[nextMessage]);
+            Blake3::Digest digest = copy.finalize();
+            std::memcpy(digests + nextMessage * Blake3::DIGEST_SIZE, digest.data(), Blake3::DIGEST_SIZE);
+            nextMessage++;
+        }
+        if (nextMessage >= count) {
+            lane[l].active = false;
+            return;
+        }
+        Lane& ln = lane[l];
+        ln.active = true;
+        ln.message = nextMessage;
+        ln.load(prefix, messages[nextMessage], lengths[nextMessage]);
+        for (int i = 0; i < 8; i++) {
+            cv[i * lanes + l] = prefix.cv[i];
+        }
+        nextMessage++;
+        active++;
+    };
+
+    for (size_t l = 0; l < lanes; l++) {
+        assign(l);
+    }
+
+    while (active > 0) {
+        for (size_t l = 0; l < lanes; l++) {
+            if (lane[l].active) {
+                blocks[l] = lane[l].block(prefix, lane[l].next, blockLengths[l], flags[l]);
+            } else {
+                blocks[l] = idleBlock;
+            }
+        }
+
+        kernel(cv, blocks, blockLengths, flags);
+
+        for (size_t l = 0; l < lanes; l++) {
+            Lane& ln = lane[l];
+            if (!ln.active || ++ln.next < ln.totalBlocks) {
+                continue;
+            }
+            storeDigest(cv + l, lanes, digests + ln.message * Blake3::DIGEST_SIZE);
+            active--;
+            assign(l);
+        }
+    }
+}
+
+BatchKernel bestBatchKernel() {
+    if (Blake3::isBatchKernelSupported(BatchKernel::AVX512)) return BatchKernel::AVX512;
+    if (Blake3::isBatchKernelSupported(BatchKernel::AVX2)) return BatchKernel::AVX2;
+    if (Blake3::isBatchKernelSupported(BatchKernel::SSE2)) return BatchKernel::SSE2;
+    return BatchKernel::SCALAR;
+}
+
+std::atomic<BatchKernel>& selectedBatchKernel() {
+    static std::atomic<BatchKernel> kernel(bestBatchKernel());
+    return kernel;
+}
+
+} // namespace
+
+bool Blake3::isBatchKernelSupported(BatchKernel kernel) {
+    switch (kernel) {
+        case BatchKernel::SCALAR: return true;
+#ifdef CRYPTO_X86_KERNELS
+        case BatchKernel::SSE2: return cpuFeatures().sse2;
+        case BatchKernel::AVX2: return cpuFeatures().avx2;
+        case BatchKernel::AVX512: return cpuFeatures().avx512f;
+#endif
+        default: return false;
+    }
+}
+
+BatchKernel Blake3::getBatchKernel() {
+    return selectedBatchKernel().load(std::memory_order_relaxed);
+}
+
+bool Blake3::setBatchKernel(BatchKernel kernel) {
+    if (!isBatchKernelSupported(kernel)) {
+        return false;
+    }
+    selectedBatchKernel().store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+size_t Blake3::getBatchLanes() {
+    switch (getBatchKernel()) {
+        case BatchKernel::SSE2: return 4;
+        case BatchKernel::AVX2: return 8;
+        case BatchKernel::AVX512: return 16;
+        default: return 1;
+    }
+}
+
+void Blake3::hashBatch(const uint8_t* const* messages, const size_t* lengths,
+                       size_t count, uint8_t* digests) {
+    Blake3().hashSuffixBatch(messages, lengths, count, digests);
+}
+
+void Blake3::hashSuffixBatch(const uint8_t* const* suffixes, const size_t* lengths,
+                             size_t count, uint8_t* digests) const {
+    BatchKernel kernel = getBatchKernel();
+
+    // A single message gains nothing from idle lanes
+    if (count < 2) {
+        kernel = BatchKernel::SCALAR;
+    }
+
+    // Lanes only model the first chunk; later ones go through the tree
+    if (chunkCounter > 0) {
+        for (size_t m = 0; m < count; m++) {
+            Blake3 copy = *this;
+            copy.update(suffixes[m], lengths[m]);
+            Digest digest = copy.finalize();
+            std::memcpy(digests + m * DIGEST_SIZE, digest.data(), DIGEST_SIZE);
+        }
+        return;
+    }
+
+    const Prefix prefix = {cv, buffer, bufferLength, blocksCompressed};
+
+    switch (kernel) {
+#ifdef CRYPTO_X86_KERNELS
+        case BatchKernel::SSE2:
+            runMultiBuffer(detail::blake3CompressSse2x4, 4, *this, prefix, suffixes, lengths, count, digests);
+            return;
+        case BatchKernel::AVX2:
+            runMultiBuffer(detail::blake3CompressAvx2x8, 8, *this, prefix, suffixes, lengths, count, digests);
+            return;
+        case BatchKernel::AVX512:
+            runMultiBuffer(detail::blake3CompressAvx512x16, 16, *this, prefix, suffixes, lengths, count, digests);
+            return;
+#endif
+        default:
+            runMultiBuffer(compressScalarLane, 1, *this, prefix, suffixes, lengths, count, digests);
+            return;
+    }
+}
+
+std::vector<std::string> Blake3::hashBatch(const std::vector<std::string>& inputs) {
+    std::vector<const uint8_t*> messages(inputs.size());
+    std::vector<size_t> lengths(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        messages[i] = reinterpret_cast<const uint8_t*>(inputs[i].data());
+        lengths[i] = inputs[i].size();
+    }
+
+    std::vector<uint8_t> digests(inputs.size() * DIGEST_SIZE);
+    hashBatch(messages.data(), lengths.data(), inputs.size(), digests.data());
+
+    std::vector<std::string> result(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        result[i] = toHex(digests.data() + i * DIGEST_SIZE, DIGEST_SIZE);
+    }
+    return result;
+}
+
+} // namespace crypto
@@ -0,0 +1,67 @@
+/**
+ * @file blake3_avx2.cpp
+ * @brief 8-lane AVX2 multi-buffer BLAKE3 kernel
+ *
+ * Built with AVX2 code generation enabled; only called after the
+ * runtime CPU check in cpu_features.cpp succeeds.
+ */
+
+#include "blake3_kernels.h"
+
+#ifdef CRYPTO_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace crypto {
+namespace detail {
+
+namespace {
+
+struct Avx2 {
+    using Reg = __m256i;
+    static constexpr size_t LANES = 8;
+
+    static Reg load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t* p, Reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+    static Reg set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static Reg add(Reg x, Reg y) { return _mm256_add_epi32(x, y); }
+    static Reg bxor(Reg x, Reg y) { return _mm256_xor_si256(x, y); }
+
+    // Byte-aligned rotations are a single byte shuffle
+    template <int N>
+    static Reg rotr(Reg x) {
+        if constexpr (N == 16) {
+            return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+        } else if constexpr (N == 8) {
+            return _mm256_shuffle_epi8(x, _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                                           1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+        } else {
+            return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+        }
+    }
+
+    static Reg gatherLE32(const uint8_t* const* blocks, int offset) {
+        return _mm256_setr_epi32(static_cast<int>(loadLE32(blocks[0] + offset)),
+                                 static_cast<int>(loadLE32(blocks[1] + offset)),
+                                 static_cast<int>(loadLE32(blocks[2] + offset)),
+                                 static_cast<int>(loadLE32(blocks[3] + offset)),
+                                 static_cast<int>(loadLE32(blocks[4] + offset)),
+                                 static_cast<int>(loadLE32(blocks[5] + offset)),
+                                 static_cast<int>(loadLE32(blocks[6] + offset)),
+                                 static_cast<int>(loadLE32(blocks[7] + offset)));
+    }
+};
+
+} // namespace
+
+void blake3CompressAvx2x8(uint32_t* cv, const uint8_t* const* blocks,
+                          const uint32_t* blockLengths, const uint32_t* flags) {
+    static const uint32_t zeros[Avx2::LANES] = {};
+    compressLanes<Avx2>(cv, blocks, zeros, zeros, blockLengths, flags);
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // CRYPTO_X86_KERNELS
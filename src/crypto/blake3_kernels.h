@@ -0,0 +1,136 @@
+/**
+ * @file blake3_kernels.h
+ * @brief Internal BLAKE3 compression kernels (not installed)
+ *
+ * The multi-buffer kernels compress one 64-byte block for each of N
+ * independent single-chunk messages at once. As with SHA-256, every
+ * ISA-specific translation unit instantiates compressLanes() with its
+ * own vector wrapper, so the round logic is written exactly once.
+ */
+
+#ifndef BLAKE3_KERNELS_H
+#define BLAKE3_KERNELS_H
+
+#include "sha256_kernels.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace crypto {
+namespace detail {
+
+// BLAKE3 reuses the SHA-256 initial hash values as its IV
+constexpr const uint32_t* BLAKE3_IV = SHA256_IV;
+
+// Domain separation flags
+constexpr uint32_t BLAKE3_CHUNK_START = 1u << 0;
+constexpr uint32_t BLAKE3_CHUNK_END = 1u << 1;
+constexpr uint32_t BLAKE3_PARENT = 1u << 2;
+constexpr uint32_t BLAKE3_ROOT = 1u << 3;
+
+// Message word order for each of the 7 rounds (the permutation applied repeatedly)
+constexpr uint8_t BLAKE3_MSG_SCHEDULE[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}
+};
+
+/**
+ * @brief Multi-buffer compression of the first chunk of each lane
+ * @param cv Lane chaining values, word-major: cv[word * lanes + lane]
+ * @param blocks One 64-byte block pointer per lane
+ * @param blockLengths Bytes used in each lane's block
+ * @param flags Domain flags for each lane's block
+ *
+ * The chunk counter is 0 in every lane, which covers messages of up to
+ * one chunk (1024 bytes).
+ */
+using Blake3MultiFn = void (*)(uint32_t* cv, const uint8_t* const* blocks,
+                               const uint32_t* blockLengths, const uint32_t* flags);
+
+#ifdef CRYPTO_X86_KERNELS
+void blake3CompressSse2x4(uint32_t* cv, const uint8_t* const* blocks,
+                          const uint32_t* blockLengths, const uint32_t* flags);
+void blake3CompressAvx2x8(uint32_t* cv, const uint8_t* const* blocks,
+                          const uint32_t* blockLengths, const uint32_t* flags);
+void blake3CompressAvx512x16(uint32_t* cv, const uint8_t* const* blocks,
+                             const uint32_t* blockLengths, const uint32_t* flags);
+#endif
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief BLAKE3 quarter-round on four state words
+ */
+template <typename V, typename Reg>
+inline void blake3G(Reg& a, Reg& b, Reg& c, Reg& d, Reg x, Reg y) {
+    a = V::add(V::add(a, b), x);
+    d = V::template rotr<16>(V::bxor(d, a));
+    c = V::add(c, d);
+    b = V::template rotr<12>(V::bxor(b, c));
+    a = V::add(V::add(a, b), y);
+    d = V::template rotr<8>(V::bxor(d, a));
+    c = V::add(c, d);
+    b = V::template rotr<7>(V::bxor(b, c));
+}
+
+/**
+ * @brief Generic lane-parallel BLAKE3 compression
+ *
+ * V wraps one SIMD register type (or a plain word for the portable
+ * path) and must provide LANES, Reg, load, store, set1, add, bxor,
+ * rotr<N> and gatherLE32. Only the chaining value half of the output is
+ * kept, which is also the root hash when the block carries BLAKE3_ROOT.
+ * Per-lane inputs are arrays of LANES words.
+ */
+template <typename V>
+inline void compressLanes(uint32_t* cv, const uint8_t* const* blocks,
+                          const uint32_t* counterLow, const uint32_t* counterHigh,
+                          const uint32_t* blockLengths, const uint32_t* flags) {
+    using Reg = typename V::Reg;
+    constexpr size_t L = V::LANES;
+
+    Reg m[16];
+    for (int i = 0; i < 16; i++) {
+        m[i] = V::gatherLE32(blocks, i * 4);
+    }
+
+    Reg v[16];
+    for (int i = 0; i < 8; i++) {
+        v[i] = V::load(cv + i * L);
+    }
+    for (int i = 0; i < 4; i++) {
+        v[8 + i] = V::set1(BLAKE3_IV[i]);
+    }
+    v[12] = V::load(counterLow);
+    v[13] = V::load(counterHigh);
+    v[14] = V::load(blockLengths);
+    v[15] = V::load(flags);
+
+    for (int r = 0; r < 7; r++) {
+        const uint8_t* s = BLAKE3_MSG_SCHEDULE[r];
+        blake3G<V>(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        blake3G<V>(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        blake3G<V>(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        blake3G<V>(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        blake3G<V>(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        blake3G<V>(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        blake3G<V>(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        blake3G<V>(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        V::store(cv + i * L, V::bxor(v[i], v[i + 8]));
+    }
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // BLAKE3_KERNELS_H
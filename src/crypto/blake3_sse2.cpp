@@ -0,0 +1,56 @@
+/**
+ * @file blake3_sse2.cpp
+ * @brief 4-lane SSE2 multi-buffer BLAKE3 kernel
+ */
+
+#include "blake3_kernels.h"
+
+#ifdef CRYPTO_X86_KERNELS
+
+#include <emmintrin.h>
+
+namespace crypto {
+namespace detail {
+
+namespace {
+
+struct Sse2 {
+    using Reg = __m128i;
+    static constexpr size_t LANES = 4;
+
+    static Reg load(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t* p, Reg x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+    static Reg set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static Reg add(Reg x, Reg y) { return _mm_add_epi32(x, y); }
+    static Reg bxor(Reg x, Reg y) { return _mm_xor_si128(x, y); }
+
+    template <int N>
+    static Reg rotr(Reg x) {
+        if constexpr (N == 16) {
+            // Swap the 16-bit halves of every word
+            return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+        } else {
+            return _mm_or_si128(_mm_srli_epi32(x, N), _mm_slli_epi32(x, 32 - N));
+        }
+    }
+
+    static Reg gatherLE32(const uint8_t* const* blocks, int offset) {
+        return _mm_setr_epi32(static_cast<int>(loadLE32(blocks[0] + offset)),
+                              static_cast<int>(loadLE32(blocks[1] + offset)),
+                              static_cast<int>(loadLE32(blocks[2] + offset)),
+                              static_cast<int>(loadLE32(blocks[3] + offset)));
+    }
+};
+
+} // namespace
+
+void blake3CompressSse2x4(uint32_t* cv, const uint8_t* const* blocks,
+                          const uint32_t* blockLengths, const uint32_t* flags) {
+    static const uint32_t zeros[Sse2::LANES] = {};
+    compressLanes<Sse2>(cv, blocks, zeros, zeros, blockLengths, flags);
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // CRYPTO_X86_KERNELS
@@ -0,0 +1,91 @@
+/**
+ * @file cpu_features.cpp
+ * @brief Implementation of runtime CPU feature detection
+ */
+
+#include "crypto/cpu_features.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define CRYPTO_HAVE_CPUID 1
+#endif
+
+namespace crypto {
+
+#ifdef CRYPTO_HAVE_CPUID
+namespace {
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) {
+        regs[i] = static_cast<uint32_t>(out[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+CpuFeatures detect() {
+    CpuFeatures features;
+    uint32_t regs[4];
+
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    const uint32_t ecx1 = regs[2];
+    const uint32_t edx1 = regs[3];
+    features.sse2 = (edx1 >> 26) & 1;
+    features.ssse3 = (ecx1 >> 9) & 1;
+    features.sse41 = (ecx1 >> 19) & 1;
+
+    // AVX state must be enabled by the OS (OSXSAVE + XCR0 bits)
+    const bool osxsave = (ecx1 >> 27) & 1;
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        const uint32_t ebx7 = regs[1];
+        features.avx2 = ymmEnabled && ((ebx7 >> 5) & 1);
+        features.avx512f = zmmEnabled && ((ebx7 >> 16) & 1);
+        features.sha = features.ssse3 && features.sse41 && ((ebx7 >> 29) & 1);
+    }
+
+    return features;
+}
+
+} // namespace
+#endif // CRYPTO_HAVE_CPUID
+
+const CpuFeatures& cpuFeatures() {
+#ifdef CRYPTO_HAVE_CPUID
+    static const CpuFeatures features = detect();
+#else
+    static const CpuFeatures features;
+#endif
+    return features;
+}
+
+} // namespace crypto
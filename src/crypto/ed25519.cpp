@@ -0,0 +1,807 @@
+/**
+ * @file ed25519.cpp
+ * @brief Implementation of Ed25519 signing and (batch) verification
+ *
+ * Field elements mod p = 2^255 - 19 use five 51-bit limbs; points use
+ * extended twisted Edwards coordinates (X:Y:Z:T) with the complete
+ * a = -1 formulas of Hisil et al., so no addition needs a special case.
+ */
+
+#include "crypto/ed25519.h"
+#include "crypto/sha512.h"
+#include "crypto/hex.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if !defined(__SIZEOF_INT128__)
+#error "Ed25519 field arithmetic requires unsigned __int128"
+#endif
+
+namespace crypto {
+
+namespace {
+
+__extension__ typedef unsigned __int128 uint128;
+
+// ---------------------------------------------------------------------------
+// Field arithmetic mod 2^255 - 19
+// ---------------------------------------------------------------------------
+
+constexpr uint64_t MASK51 = (uint64_t(1) << 51) - 1;
+
+struct Fe {
+    uint64_t v[5];
+};
+
+const Fe FE_ZERO = {{0, 0, 0, 0, 0}};
+const Fe FE_ONE = {{1, 0, 0, 0, 0}};
+// d = -121665 / 121666
+const Fe FE_D = {{0x34dca135978a3ULL, 0x1a8283b156ebdULL, 0x5e7a26001c029ULL,
+                  0x739c663a03cbbULL, 0x52036cee2b6ffULL}};
+const Fe FE_D2 = {{0x69b9426b2f159ULL, 0x35050762add7aULL, 0x3cf44c0038052ULL,
+                   0x6738cc7407977ULL, 0x2406d9dc56dffULL}};
+// sqrt(-1) = 2^((p - 1) / 4)
+const Fe FE_SQRTM1 = {{0x61b274a0ea0b0ULL, 0x0d5a5fc8f189dULL, 0x7ef5e9cbd0c60ULL,
+                       0x78595a6804c9eULL, 0x2b8324804fc1dULL}};
+
+inline uint64_t loadLE64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+inline void storeLE64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+/// Propagate carries so every limb is below 2^51 (limb 0 below 2^51 + 2^18)
+inline void feCarry(Fe& h) {
+    uint64_t c;
+    c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+    c = h.v[1] >> 51; h.v[1] &= MASK51; h.v[2] += c;
+    c = h.v[2] >> 51; h.v[2] &= MASK51; h.v[3] += c;
+    c = h.v[3] >> 51; h.v[3] &= MASK51; h.v[4] += c;
+    c = h.v[4] >> 51; h.v[4] &= MASK51; h.v[0] += c * 19;
+}
+
+inline void feAdd(Fe& h, const Fe& f, const Fe& g) {
+    for (int i = 0; i < 5; i++) {
+        h.v[i] = f.v[i] + g.v[i];
+    }
+    feCarry(h);
+}
+
+inline void feSub(Fe& h, const Fe& f, const Fe& g) {
+    // Add 2p first so no limb underflows
+    h.v[0] = f.v[0] + 0xFFFFFFFFFFFDAULL - g.v[0];
+    for (int i = 1; i < 5; i++) {
+        h.v[i] = f.v[i] + 0xFFFFFFFFFFFFEULL - g.v[i];
+    }
+    feCarry(h);
+}
+
+inline void feNeg(Fe& h, const Fe& f) {
+    feSub(h, FE_ZERO, f);
+}
+
+inline void feReduceProduct(Fe& h, uint128 r0, uint128 r1, uint128 r2, uint128 r3, uint128 r4) {
+    r1 += static_cast<uint64_t>(r0 >> 51);
+    r2 += static_cast<uint64_t>(r1 >> 51);
+    r3 += static_cast<uint64_t>(r2 >> 51);
+    r4 += static_cast<uint64_t>(r3 >> 51);
+    uint64_t h0 = (static_cast<uint64_t>(r0) & MASK51) + static_cast<uint64_t>(r4 >> 51) * 19;
+    h.v[1] = (static_cast<uint64_t>(r1) & MASK51) + (h0 >> 51);
+    h.v[0] = h0 & MASK51;
+    h.v[2] = static_cast<uint64_t>(r2) & MASK51;
+    h.v[3] = static_cast<uint64_t>(r3) & MASK51;
+    h.v[4] = static_cast<uint64_t>(r4) & MASK51;
+}
+
+void feMul(Fe& h, const Fe& f, const Fe& g) {
+    const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    const uint64_t g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+    const uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    uint128 r0 = (uint128)f0 * g0 + (uint128)f1 * g4_19 + (uint128)f2 * g3_19 +
+                 (uint128)f3 * g2_19 + (uint128)f4 * g1_19;
+    uint128 r1 = (uint128)f0 * g1 + (uint128)f1 * g0 + (uint128)f2 * g4_19 +
+                 (uint128)f3 * g3_19 + (uint128)f4 * g2_19;
+    uint128 r2 = (uint128)f0 * g2 + (uint128)f1 * g1 + (uint128)f2 * g0 +
+                 (uint128)f3 * g4_19 + (uint128)f4 * g3_19;
+    uint128 r3 = (uint128)f0 * g3 + (uint128)f1 * g2 + (uint128)f2 * g1 +
+                 (uint128)f3 * g0 + (uint128)f4 * g4_19;
+    uint128 r4 = (uint128)f0 * g4 + (uint128)f1 * g3 + (uint128)f2 * g2 +
+                 (uint128)f3 * g1 + (uint128)f4 * g0;
+    feReduceProduct(h, r0, r1, r2, r3, r4);
+}
+
+void feSq(Fe& h, const Fe& f) {
+    const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    const uint64_t f0_2 = 2 * f0, f1_2 = 2 * f1;
+    const uint64_t f3_19 = 19 * f3, f4_19 = 19 * f4, f3_38 = 38 * f3, f4_38 = 38 * f4;
+
+    uint128 r0 = (uint128)f0 * f0 + (uint128)f1 * f4_38 + (uint128)f2 * f3_38;
+    uint128 r1 = (uint128)f0_2 * f1 + (uint128)f2 * f4_38 + (uint128)f3 * f3_19;
+    uint128 r2 = (uint128)f0_2 * f2 + (uint128)f1 * f1 + (uint128)f3 * f4_38;
+    uint128 r3 = (uint128)f0_2 * f3 + (uint128)f1_2 * f2 + (uint128)f4 * f4_19;
+    uint128 r4 = (uint128)f0_2 * f4 + (uint128)f1_2 * f3 + (uint128)f2 * f2;
+    feReduceProduct(h, r0, r1, r2, r3, r4);
+}
+
+/// h = f^(2^n)
+void feSqn(Fe& h, const Fe& f, int n) {
+    feSq(h, f);
+    for (int i = 1; i < n; i++) {
+        feSq(h, h);
+    }
+}
+
+/// Shared prefix of the inversion and square-root chains: returns z^(2^250 - 1), and z^11 in z11
+void fePow2250m1(Fe& out, Fe& z11, const Fe& z) {
+    Fe t0, t1, t2;
+    feSq(t0, z);                // 2
+    feSqn(t1, t0, 2);           // 8
+    feMul(t1, z, t1);           // 9
+    feMul(z11, t0, t1);         // 11
+    feSq(t0, z11);              // 22
+    feMul(t0, t1, t0);          // 2^5 - 1
+    feSqn(t1, t0, 5);
+    feMul(t0, t1, t0);          // 2^10 - 1
+    feSqn(t1, t0, 10);
+    feMul(t1, t1, t0);          // 2^20 - 1
+    feSqn(t2, t1, 20);
+    feMul(t1, t2, t1);          // 2^40 - 1
+    feSqn(t1, t1, 10);
+    feMul(t0, t1, t0);          // 2^50 - 1
+    feSqn(t1, t0, 50);
+    feMul(t1, t1, t0);          // 2^100 - 1
+    feSqn(t2, t1, 100);
+    feMul(t1, t2, t1);          // 2^200 - 1
+    feSqn(t1, t1, 50);
+    feMul(out, t1, t0);         // 2^250 - 1
+}
+
+/// h = z^(p - 2) = 1 / z
+void feInvert(Fe& h, const Fe& z) {
+    Fe t, z11;
+    fePow2250m1(t, z11, z);
+    feSqn(t, t, 5);             // 2^255 - 32
+    feMul(h, t, z11);           // 2^255 - 21
+}
+
+/// h = z^((p - 5) / 8) = z^(2^252 - 3)
+void fePow22523(Fe& h, const Fe& z) {
+    Fe t, z11;
+    fePow2250m1(t, z11, z);
+    feSqn(t, t, 2);             // 2^252 - 4
+    feMul(h, t, z);             // 2^252 - 3
+}
+
+void feToBytes(uint8_t out[32], const Fe& f) {
+    Fe h = f;
+    feCarry(h);
+    feCarry(h);
+
+    // h < 2^255 now; subtract p once if h >= p
+    uint64_t q = (h.v[0] + 19) >> 51;
+    q = (h.v[1] + q) >> 51;
+    q = (h.v[2] + q) >> 51;
+    q = (h.v[3] + q) >> 51;
+    q = (h.v[4] + q) >> 51;
+    h.v[0] += 19 * q;
+    h.v[1] += h.v[0] >> 51; h.v[0] &= MASK51;
+    h.v[2] += h.v[1] >> 51; h.v[1] &= MASK51;
+    h.v[3] += h.v[2] >> 51; h.v[2] &= MASK51;
+    h.v[4] += h.v[3] >> 51; h.v[3] &= MASK51;
+    h.v[4] &= MASK51;
+
+    storeLE64(out, h.v[0] | (h.v[1] << 51));
+    storeLE64(out + 8, (h.v[1] >> 13) | (h.v[2] << 38));
+    storeLE64(out + 16, (h.v[2] >> 26) | (h.v[3] << 25));
+    storeLE64(out + 24, (h.v[3] >> 39) | (h.v[4] << 12));
+}
+
+/// Load 255 bits; the top bit of in[31] is ignored
+void feFromBytes(Fe& h, const uint8_t in[32]) {
+    const uint64_t w0 = loadLE64(in), w1 = loadLE64(in + 8);
+    const uint64_t w2 = loadLE64(in + 16), w3 = loadLE64(in + 24);
+    h.v[0] = w0 & MASK51;
+    h.v[1] = ((w0 >> 51) | (w1 << 13)) & MASK51;
+    h.v[2] = ((w1 >> 38) | (w2 << 26)) & MASK51;
+    h.v[3] = ((w2 >> 25) | (w3 << 39)) & MASK51;
+    h.v[4] = (w3 >> 12) & MASK51;
+}
+
+bool feIsZero(const Fe& f) {
+    uint8_t bytes[32];
+    feToBytes(bytes, f);
+    uint8_t acc = 0;
+    for (uint8_t b : bytes) {
+        acc |= b;
+    }
+    return acc == 0;
+}
+
+bool feIsNegative(const Fe& f) {
+    uint8_t bytes[32];
+    feToBytes(bytes, f);
+    return (bytes[0] & 1) != 0;
+}
+
+/// f = flag ? g : f, without branching on flag
+inline void feCmov(Fe& f, const Fe& g, uint64_t flag) {
+    const uint64_t mask = 0 - flag;
+    for (int i = 0; i < 5; i++) {
+        f.v[i] ^= mask & (f.v[i] ^ g.v[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group operations
+// ---------------------------------------------------------------------------
+
+/// Extended coordinates: x = X/Z, y = Y/Z, x*y = T/Z
+struct Point {
+    Fe X, Y, Z, T;
+};
+
+/// A point prepared as the right-hand operand of an addition
+struct Cached {
+    Fe YplusX, YminusX, T2d, Z2;
+};
+
+const Point POINT_IDENTITY = {FE_ZERO, FE_ONE, FE_ONE, FE_ZERO};
+const Cached CACHED_IDENTITY = {FE_ONE, FE_ONE, FE_ZERO, {{2, 0, 0, 0, 0}}};
+
+// Base point B
+const Point BASE_POINT = {
+    {{0x62d608f25d51aULL, 0x412a4b4f6592aULL, 0x75b7171a4b31dULL, 0x1ff60527118feULL, 0x216936d3cd6e5ULL}},
+    {{0x6666666666658ULL, 0x4ccccccccccccULL, 0x1999999999999ULL, 0x3333333333333ULL, 0x6666666666666ULL}},
+    {{1, 0, 0, 0, 0}},
+    {{0x68ab3a5b7dda3ULL, 0x00eea2a5eadbbULL, 0x2af8df483c27eULL, 0x332b375274732ULL, 0x67875f0fd78b7ULL}}
+};
+
+void toCached(Cached& c, const Point& p) {
+    feAdd(c.YplusX, p.Y, p.X);
+    feSub(c.YminusX, p.Y, p.X);
+    feMul(c.T2d, p.T, FE_D2);
+    feAdd(c.Z2, p.Z, p.Z);
+}
+
+void negateCached(Cached& c) {
+    std::swap(c.YplusX, c.YminusX);
+    feNeg(c.T2d, c.T2d);
+}
+
+/// r = p + q (r may alias p)
+void pointAdd(Point& r, const Point& p, const Cached& q) {
+    Fe a, b, c, d, e, f, g, h;
+    feSub(a, p.Y, p.X);
+    feMul(a, a, q.YminusX);
+    feAdd(b, p.Y, p.X);
+    feMul(b, b, q.YplusX);
+    feMul(c, p.T, q.T2d);
+    feMul(d, p.Z, q.Z2);
+    feSub(e, b, a);
+    feSub(f, d, c);
+    feAdd(g, d, c);
+    feAdd(h, b, a);
+    feMul(r.X, e, f);
+    feMul(r.Y, g, h);
+    feMul(r.T, e, h);
+    feMul(r.Z, f, g);
+}
+
+/// r = 2p (r may alias p)
+void pointDouble(Point& r, const Point& p) {
+    Fe a, b, c, e, f, g, h;
+    feSq(a, p.X);
+    feSq(b, p.Y);
+    feSq(c, p.Z);
+    feAdd(c, c, c);
+    feAdd(h, a, b);
+    feAdd(e, p.X, p.Y);
+    feSq(e, e);
+    feSub(e, h, e);
+    feSub(g, a, b);
+    feAdd(f, c, g);
+    feMul(r.X, e, f);
+    feMul(r.Y, g, h);
+    feMul(r.T, e, h);
+    feMul(r.Z, f, g);
+}
+
+bool pointIsIdentity(const Point& p) {
+    Fe diff;
+    feSub(diff, p.Y, p.Z);
+    return feIsZero(p.X) && feIsZero(diff);
+}
+
+/// r = [8]p, clearing any small-order component
+void pointMulByCofactor(Point& r, const Point& p) {
+    pointDouble(r, p);
+    pointDouble(r, r);
+    pointDouble(r, r);
+}
+
+void pointEncode(uint8_t out[32], const Point& p) {
+    Fe recip, x, y;
+    feInvert(recip, p.Z);
+    feMul(x, p.X, recip);
+    feMul(y, p.Y, recip);
+    feToBytes(out, y);
+    out[31] ^= static_cast<uint8_t>(feIsNegative(x) << 7);
+}
+
+/// Decode per RFC 8032 section 5.1.3, rejecting non-canonical y
+bool pointDecode(Point& p, const uint8_t in[32]) {
+    Fe y;
+    feFromBytes(y, in);
+
+    uint8_t canonical[32];
+    feToBytes(canonical, y);
+    canonical[31] |= in[31] & 0x80;
+    if (std::memcmp(canonical, in, 32) != 0) {
+        return false;
+    }
+    const bool sign = (in[31] >> 7) != 0;
+
+    // x^2 = u / v with u = y^2 - 1, v = d y^2 + 1
+    Fe u, v, v3, x, check;
+    feSq(u, y);
+    feMul(v, u, FE_D);
+    feSub(u, u, FE_ONE);
+    feAdd(v, v, FE_ONE);
+
+    // x = u v^3 (u v^7)^((p - 5) / 8)
+    feSq(v3, v);
+    feMul(v3, v3, v);
+    feSq(x, v3);
+    feMul(x, x, v);
+    feMul(x, x, u);
+    fePow22523(x, x);
+    feMul(x, x, v3);
+    feMul(x, x, u);
+
+    feSq(check, x);
+    feMul(check, check, v);
+    Fe diff;
+    feSub(diff, check, u);
+    if (!feIsZero(diff)) {
+        feAdd(diff, check, u);
+        if (!feIsZero(diff)) {
+            return false;
+        }
+        feMul(x, x, FE_SQRTM1);
+    }
+
+    if (feIsZero(x) && sign) {
+        return false;
+    }
+    if (feIsNegative(x) != sign) {
+        feNeg(x, x);
+    }
+
+    p.X = x;
+    p.Y = y;
+    p.Z = FE_ONE;
+    feMul(p.T, x, y);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493
+// ---------------------------------------------------------------------------
+
+struct Scalar {
+    uint64_t v[4];
+};
+
+const uint64_t GROUP_ORDER[4] = {
+    0x5812631a5cf5d3edULL, 0x14def9dea2f79cd6ULL, 0x0000000000000000ULL, 0x1000000000000000ULL
+};
+
+Scalar scalarFromBytes(const uint8_t in[32]) {
+    Scalar s;
+    for (int i = 0; i < 4; i++) {
+        s.v[i] = loadLE64(in + 8 * i);
+    }
+    return s;
+}
+
+void scalarToBytes(uint8_t out[32], const Scalar& s) {
+    for (int i = 0; i < 4; i++) {
+        storeLE64(out + 8 * i, s.v[i]);
+    }
+}
+
+bool scalarIsCanonical(const Scalar& s) {
+    for (int i = 3; i >= 0; i--) {
+        if (s.v[i] != GROUP_ORDER[i]) {
+            return s.v[i] < GROUP_ORDER[i];
+        }
+    }
+    return false;
+}
+
+/// s -= L if s >= L, without branching on s (requires s < 2L)
+inline void scalarCondSubtract(Scalar& s) {
+    uint64_t diff[4];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        const uint128 d = (uint128)s.v[i] - GROUP_ORDER[i] - borrow;
+        diff[i] = static_cast<uint64_t>(d);
+        borrow = static_cast<uint64_t>(d >> 64) & 1;
+    }
+    const uint64_t keep = borrow - 1;  // all ones if no borrow
+    for (int i = 0; i < 4; i++) {
+        s.v[i] = (diff[i] & keep) | (s.v[i] & ~keep);
+    }
+}
+
+/**
+ * @brief Reduce a little-endian multi-limb integer mod L
+ *
+ * Binary long division: the leading 252 bits are already below L, and
+ * each further bit costs one shift and one conditional subtraction.
+ */
+Scalar scalarReduce(const uint64_t* limbs, size_t count) {
+    const size_t bits = 64 * count;
+    Scalar r = {{0, 0, 0, 0}};
+    for (size_t bit = bits; bit-- > 0;) {
+        r.v[3] = (r.v[3] << 1) | (r.v[2] >> 63);
+        r.v[2] = (r.v[2] << 1) | (r.v[1] >> 63);
+        r.v[1] = (r.v[1] << 1) | (r.v[0] >> 63);
+        r.v[0] = (r.v[0] << 1) | ((limbs[bit / 64] >> (bit % 64)) & 1);
+        if (bits - bit > 252) {
+            scalarCondSubtract(r);
+        }
+    }
+    return r;
+}
+
+Scalar scalarFromDigest(const SHA512::Digest& digest) {
+    uint64_t limbs[8];
+    for (int i = 0; i < 8; i++) {
+        limbs[i] = loadLE64(digest.data() + 8 * i);
+    }
+    return scalarReduce(limbs, 8);
+}
+
+/// (a * b + c) mod L; a and b may be any 256-bit values
+Scalar scalarMulAdd(const Scalar& a, const Scalar& b, const Scalar& c) {
+    uint64_t wide[8] = {c.v[0], c.v[1], c.v[2], c.v[3], 0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            const uint128 t = (uint128)a.v[i] * b.v[j] + wide[i + j] + carry;
+            wide[i + j] = static_cast<uint64_t>(t);
+            carry = static_cast<uint64_t>(t >> 64);
+        }
+        for (int k = i + 4; carry != 0 && k < 8; k++) {
+            const uint128 t = (uint128)wide[k] + carry;
+            wide[k] = static_cast<uint64_t>(t);
+            carry = static_cast<uint64_t>(t >> 64);
+        }
+    }
+    return scalarReduce(wide, 8);
+}
+
+/// (-a) mod L for canonical a
+Scalar scalarNegate(const Scalar& a) {
+    Scalar r;
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        const uint128 d = (uint128)GROUP_ORDER[i] - a.v[i] - borrow;
+        r.v[i] = static_cast<uint64_t>(d);
+        borrow = static_cast<uint64_t>(d >> 64) & 1;
+    }
+    scalarCondSubtract(r);  // maps L back to 0
+    return r;
+}
+
+/// Bits [offset, offset + width) of a scalar (width <= 32)
+inline uint32_t scalarWindow(const Scalar& s, size_t offset, size_t width) {
+    const size_t limb = offset / 64, shift = offset % 64;
+    if (limb >= 4) {
+        return 0;
+    }
+    uint64_t bits = s.v[limb] >> shift;
+    if (shift + width > 64 && limb + 1 < 4) {
+        bits |= s.v[limb + 1] << (64 - shift);
+    }
+    return static_cast<uint32_t>(bits & ((uint64_t(1) << width) - 1));
+}
+
+// ---------------------------------------------------------------------------
+// Scalar multiplication
+// ---------------------------------------------------------------------------
+
+constexpr int BASE_TABLE_ROWS = 64;   ///< One row per 4-bit digit of a 256-bit scalar
+
+/**
+ * @brief Table of [j * 16^i]B for i < 64, j < 16
+ *
+ * Built once on first use (about 1000 additions, 160 KiB), after which
+ * a fixed-base multiplication is 64 additions and no doublings.
+ */
+struct BaseTable {
+    Cached rows[BASE_TABLE_ROWS][16];
+
+    BaseTable() {
+        Point base = BASE_POINT;
+        for (int i = 0; i < BASE_TABLE_ROWS; i++) {
+            Cached step;
+            toCached(step, base);
+            Point multiple = POINT_IDENTITY;
+            for (int j = 0; j < 16; j++) {
+                toCached(rows[i][j], multiple);
+                pointAdd(multiple, multiple, step);
+            }
+            for (int k = 0; k < 4; k++) {
+                pointDouble(base, base);
+            }
+        }
+    }
+};
+
+const BaseTable& baseTable() {
+    static const BaseTable table;
+    return table;
+}
+
+/// r = [s]B for a 256-bit little-endian scalar; runs in constant time
+void baseMul(Point& r, const uint8_t scalar[32]) {
+    const BaseTable& table = baseTable();
+    r = POINT_IDENTITY;
+    for (int i = 0; i < BASE_TABLE_ROWS; i++) {
+        const uint64_t digit = (scalar[i / 2] >> (4 * (i & 1))) & 15;
+
+        // Read every entry so the memory access pattern is independent of the digit
+        Cached selected = table.rows[i][0];
+        for (uint64_t j = 1; j < 16; j++) {
+            const uint64_t match = ((j ^ digit) - 1) >> 63;
+            feCmov(selected.YplusX, table.rows[i][j].YplusX, match);
+            feCmov(selected.YminusX, table.rows[i][j].YminusX, match);
+            feCmov(selected.T2d, table.rows[i][j].T2d, match);
+            feCmov(selected.Z2, table.rows[i][j].Z2, match);
+        }
+        pointAdd(r, r, selected);
+    }
+}
+
+/// r = [s]p with a 4-bit fixed window; variable time, for public data only
+void variableMul(Point& r, const Point& p, const Scalar& s) {
+    Cached multiples[16];
+    Point multiple = POINT_IDENTITY;
+    Cached step;
+    toCached(step, p);
+    for (int j = 0; j < 16; j++) {
+        toCached(multiples[j], multiple);
+        pointAdd(multiple, multiple, step);
+    }
+
+    r = POINT_IDENTITY;
+    for (int i = 63; i >= 0; i--) {
+        for (int k = 0; k < 4; k++) {
+            pointDouble(r, r);
+        }
+        pointAdd(r, r, multiples[scalarWindow(s, 4 * i, 4)]);
+    }
+}
+
+/**
+ * @brief Multi-scalar multiplication sum([scalars[i]]points[i]) (Pippenger)
+ *
+ * Each c-bit window of every scalar drops its point into one of 2^c - 1
+ * buckets; a running sum then weights bucket j by j. The total is about
+ * (253 / c) * (n + 2^(c+1)) additions instead of n * 253 doublings.
+ */
+void multiScalarMul(Point& r, const std::vector<Cached>& points, const std::vector<Scalar>& scalars) {
+    const size_t n = points.size();
+    size_t width = 2;
+    while (width < 16 && (size_t(1) << (width + 2)) < n) {
+        width++;
+    }
+    const size_t windows = (253 + width - 1) / width;
+    const size_t bucketCount = (size_t(1) << width) - 1;
+
+    std::vector<Point> buckets(bucketCount);
+    std::vector<bool> used(bucketCount);
+
+    r = POINT_IDENTITY;
+    for (size_t w = windows; w-- > 0;) {
+        for (size_t k = 0; k < width && w + 1 < windows; k++) {
+            pointDouble(r, r);
+        }
+
+        std::fill(used.begin(), used.end(), false);
+        for (size_t i = 0; i < n; i++) {
+            const uint32_t digit = scalarWindow(scalars[i], w * width, width);
+            if (digit == 0) {
+                continue;
+            }
+            if (!used[digit - 1]) {
+                buckets[digit - 1] = POINT_IDENTITY;
+                used[digit - 1] = true;
+            }
+            pointAdd(buckets[digit - 1], buckets[digit - 1], points[i]);
+        }
+
+        // sum = sum_j [j]bucket_j, via suffix sums
+        Point running = POINT_IDENTITY;
+        Point sum = POINT_IDENTITY;
+        bool started = false;
+        Cached addend;
+        for (size_t j = bucketCount; j-- > 0;) {
+            if (used[j]) {
+                toCached(addend, buckets[j]);
+                pointAdd(running, running, addend);
+                started = true;
+            }
+            if (started) {
+                toCached(addend, running);
+                pointAdd(sum, sum, addend);
+            }
+        }
+        toCached(addend, sum);
+        pointAdd(r, r, addend);
+    }
+}
+
+/// k = H(R || A || M) mod L
+Scalar challenge(const uint8_t R[32], const uint8_t A[32], const uint8_t* message, size_t length) {
+    SHA512 hasher;
+    hasher.update(R, 32);
+    hasher.update(A, 32);
+    hasher.update(message, length);
+    return scalarFromDigest(hasher.finalize());
+}
+
+/// Decoded, range-checked parts of one signature
+struct Decoded {
+    Point A;
+    Point R;
+    Scalar s;
+    Scalar k;
+};
+
+bool decodeEntry(const Ed25519::PublicKey& publicKey, const uint8_t* message, size_t length,
+                 const Ed25519::Signature& signature, Decoded& out) {
+    out.s = scalarFromBytes(signature.data() + 32);
+    if (!scalarIsCanonical(out.s)) {
+        return false;
+    }
+    if (!pointDecode(out.A, publicKey.data()) || !pointDecode(out.R, signature.data())) {
+        return false;
+    }
+    out.k = challenge(signature.data(), publicKey.data(), message, length);
+    return true;
+}
+
+} // namespace
+
+Ed25519::KeyPair::KeyPair(const Seed& seed) : seed(seed) {
+    const SHA512::Digest expanded = SHA512::digest(seed.data(), seed.size());
+    std::memcpy(scalar, expanded.data(), 32);
+    std::memcpy(prefix, expanded.data() + 32, 32);
+    scalar[0] &= 248;
+    scalar[31] &= 127;
+    scalar[31] |= 64;
+
+    Point A;
+    baseMul(A, scalar);
+    pointEncode(publicKey.data(), A);
+}
+
+Ed25519::KeyPair Ed25519::KeyPair::generate() {
+    std::random_device device;
+    Seed seed;
+    for (size_t i = 0; i < seed.size(); i += 4) {
+        const uint32_t word = device();
+        std::memcpy(seed.data() + i, &word, 4);
+    }
+    return KeyPair(seed);
+}
+
+Ed25519::Signature Ed25519::KeyPair::sign(const uint8_t* message, size_t length) const {
+    SHA512 hasher;
+    hasher.update(prefix, 32);
+    hasher.update(message, length);
+    const Scalar r = scalarFromDigest(hasher.finalize());
+
+    Signature signature;
+    uint8_t rBytes[32];
+    scalarToBytes(rBytes, r);
+    Point R;
+    baseMul(R, rBytes);
+    pointEncode(signature.data(), R);
+
+    const Scalar k = challenge(signature.data(), publicKey.data(), message, length);
+    const Scalar s = scalarMulAdd(k, scalarFromBytes(scalar), r);
+    scalarToBytes(signature.data() + 32, s);
+    return signature;
+}
+
+bool Ed25519::verify(const PublicKey& publicKey, const uint8_t* message, size_t length,
+                     const Signature& signature) {
+    Decoded d;
+    if (!decodeEntry(publicKey, message, length, signature, d)) {
+        return false;
+    }
+
+    // [8]([s]B - [k]A - R) == identity
+    Point check, kA;
+    baseMul(check, signature.data() + 32);
+    variableMul(kA, d.A, d.k);
+    Cached addend;
+    toCached(addend, kA);
+    negateCached(addend);
+    pointAdd(check, check, addend);
+    toCached(addend, d.R);
+    negateCached(addend);
+    pointAdd(check, check, addend);
+
+    pointMulByCofactor(check, check);
+    return pointIsIdentity(check);
+}
+
+bool Ed25519::verifyBatch(const BatchEntry* entries, size_t count) {
+    if (count == 0) {
+        return true;
+    }
+    if (count == 1) {
+        const BatchEntry& e = entries[0];
+        return verify(*e.publicKey, e.message, e.length, *e.signature);
+    }
+
+    // Weights z_i = H(secret seed || i), 128 bits each
+    std::random_device device;
+    uint8_t seed[40];
+    for (size_t i = 0; i < 32; i += 4) {
+        const uint32_t word = device();
+        std::memcpy(seed + i, &word, 4);
+    }
+
+    // sum_i [z_i]R_i + [z_i k_i]A_i - [sum_i z_i s_i]B must be of small order
+    std::vector<Cached> points(2 * count);
+    std::vector<Scalar> scalars(2 * count);
+    Scalar weightedS = {{0, 0, 0, 0}};
+    for (size_t i = 0; i < count; i++) {
+        const BatchEntry& e = entries[i];
+        Decoded d;
+        if (!decodeEntry(*e.publicKey, e.message, e.length, *e.signature, d)) {
+            return false;
+        }
+
+        storeLE64(seed + 32, static_cast<uint64_t>(i));
+        const SHA512::Digest weightDigest = SHA512::digest(seed, sizeof(seed));
+        const Scalar z = {{loadLE64(weightDigest.data()), loadLE64(weightDigest.data() + 8), 0, 0}};
+
+        weightedS = scalarMulAdd(z, d.s, weightedS);
+        toCached(points[2 * i], d.R);
+        scalars[2 * i] = z;
+        toCached(points[2 * i + 1], d.A);
+        scalars[2 * i + 1] = scalarMulAdd(z, d.k, Scalar{{0, 0, 0, 0}});
+    }
+
+    Point check, sB;
+    multiScalarMul(check, points, scalars);
+    uint8_t negated[32];
+    scalarToBytes(negated, scalarNegate(weightedS));
+    baseMul(sB, negated);
+    Cached addend;
+    toCached(addend, sB);
+    pointAdd(check, check, addend);
+
+    pointMulByCofactor(check, check);
+    return pointIsIdentity(check);
+}
+
+} // namespace crypto
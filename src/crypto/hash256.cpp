@@ -0,0 +1,28 @@
+/**
+ * @file hash256.cpp
+ * @brief Implementation of Hash256 hex conversion
+ */
+
+#include "crypto/hash256.h"
+#include "crypto/hex.h"
+#include <stdexcept>
+
+namespace crypto {
+
+bool Hash256::fromHex(const std::string& hex, Hash256& out) {
+    return crypto::fromHex(hex.data(), hex.size(), out.bytes.data(), SIZE);
+}
+
+Hash256 Hash256::fromHex(const std::string& hex) {
+    Hash256 result;
+    if (!fromHex(hex, result)) {
+        throw std::invalid_argument("Hash256: expected 64 hex characters");
+    }
+    return result;
+}
+
+std::string Hash256::toHex() const {
+    return crypto::toHex(bytes.data(), SIZE);
+}
+
+} // namespace crypto
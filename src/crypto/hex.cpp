@@ -0,0 +1,88 @@
+/**
+ * @file hex.cpp
+ * @brief Implementation of hexadecimal encoding
+ */
+
+#include "crypto/hex.h"
+
+namespace crypto {
+
+namespace {
+
+// "000102...feff": one two-character entry per byte value
+struct EncodeTable {
+    char pairs[512];
+    
+    constexpr EncodeTable() : pairs() {
+        const char digits[] = "0123456789abcdef";
+        for (int i = 0; i < 256; i++) {
+            pairs[i * 2] = digits[i >> 4];
+            pairs[i * 2 + 1] = digits[i & 0x0F];
+        }
+    }
+};
+
+// Nibble value per character, or -1 for non-hex characters
+struct DecodeTable {
+    int8_t values[256];
+    
+    constexpr DecodeTable() : values() {
+        for (int i = 0; i < 256; i++) {
+            values[i] = -1;
+        }
+        for (int i = 0; i < 10; i++) {
+            values['0' + i] = static_cast<int8_t>(i);
+        }
+        for (int i = 0; i < 6; i++) {
+            values['a' + i] = static_cast<int8_t>(10 + i);
+            values['A' + i] = static_cast<int8_t>(10 + i);
+        }
+    }
+};
+
+constexpr EncodeTable ENCODE;
+constexpr DecodeTable DECODE;
+
+} // namespace
+
+void toHex(const uint8_t* data, size_t length, char* out) {
+    for (size_t i = 0; i < length; i++) {
+        const char* pair = &ENCODE.pairs[data[i] * 2];
+        out[i * 2] = pair[0];
+        out[i * 2 + 1] = pair[1];
+    }
+}
+
+std::string toHex(const uint8_t* data, size_t length) {
+    std::string hex(length * 2, '\0');
+    toHex(data, length, &hex[0]);
+    return hex;
+}
+
+bool fromHex(const char* hex, size_t hexLength, uint8_t* out, size_t length) {
+    if (hexLength != length * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        int hi = DECODE.values[static_cast<uint8_t>(hex[i * 2])];
+        int lo = DECODE.values[static_cast<uint8_t>(hex[i * 2 + 1])];
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+int leadingZeroHexDigits(const uint8_t* data, size_t length) {
+    int zeros = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            return zeros + (data[i] < 0x10 ? 1 : 0);
+        }
+        zeros += 2;
+    }
+    return zeros;
+}
+
+} // namespace crypto
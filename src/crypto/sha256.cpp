@@ -4,15 +4,23 @@
  */
 
 #include "crypto/sha256.h"
+#include "crypto/cpu_features.h"
+#include "crypto/hex.h"
+#include "sha256_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
-#include <vector>
 
 namespace crypto {
 
-// Initialize K constants
-constexpr uint32_t SHA256::K[64];
+using detail::SHA256_K;
 
 SHA256::SHA256() {
+    reset();
+}
+
+void SHA256::reset() {
     // Initialize hash values (first 32 bits of fractional parts of square roots of first 8 primes)
     h[0] = 0x6a09e667;
     h[1] = 0xbb67ae85;
@@ -22,103 +30,489 @@ SHA256::SHA256() {
     h[5] = 0x9b05688c;
     h[6] = 0x1f83d9ab;
     h[7] = 0x5be0cd19;
+    bufferLength = 0;
+    totalLength = 0;
+}
+
+void SHA256::compressScalar(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    for (; blocks > 0; blocks--, data += 64) {
+        uint32_t w[64];
+        uint32_t a, b, c, d, e, f, g, h_temp;
+        uint32_t t1, t2;
+    
+        // Prepare message schedule
+        for (int i = 0; i < 16; i++) {
+            w[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | 
+                   (data[i * 4 + 2] << 8) | (data[i * 4 + 3]);
+        }
+    
+        for (int i = 16; i < 64; i++) {
+            w[i] = gamma1(w[i - 2]) + w[i - 7] + gamma0(w[i - 15]) + w[i - 16];
+        }
+    
+        // Initialize working variables
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h_temp = state[7];
+    
+        // Main compression loop
+        for (int i = 0; i < 64; i++) {
+            t1 = h_temp + sigma1(e) + ch(e, f, g) + SHA256_K[i] + w[i];
+            t2 = sigma0(a) + maj(a, b, c);
+            h_temp = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+    
+        // Add compressed chunk to current hash value
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h_temp;
+    }
+}
+
+// ============================================================================
+// Backend dispatch
+// ============================================================================
+
+namespace {
+
+detail::BlockFn backendFunction(HashBackend backend) {
+    switch (backend) {
+#ifdef CRYPTO_X86_KERNELS
+        case HashBackend::SHA_NI: return detail::sha256TransformShaNi;
+#endif
+        default: return nullptr;
+    }
+}
+
+HashBackend startupBackend() {
+    const char* forced = std::getenv("CRYPTO_SHA256_BACKEND");
+    if (forced != nullptr && std::strcmp(forced, "scalar") == 0) {
+        return HashBackend::SCALAR;
+    }
+    if (SHA256::isBackendSupported(HashBackend::SHA_NI)) {
+        return HashBackend::SHA_NI;
+    }
+    return HashBackend::SCALAR;
+}
+
+std::atomic<HashBackend>& selectedBackend() {
+    static std::atomic<HashBackend> backend(startupBackend());
+    return backend;
+}
+
+} // namespace
+
+bool SHA256::isBackendSupported(HashBackend backend) {
+    switch (backend) {
+        case HashBackend::SCALAR: return true;
+#ifdef CRYPTO_X86_KERNELS
+        case HashBackend::SHA_NI: return cpuFeatures().sha;
+#endif
+        default: return false;
+    }
+}
+
+HashBackend SHA256::getBackend() {
+    return selectedBackend().load(std::memory_order_relaxed);
+}
+
+bool SHA256::setBackend(HashBackend backend) {
+    if (!isBackendSupported(backend)) {
+        return false;
+    }
+    selectedBackend().store(backend, std::memory_order_relaxed);
+    return true;
 }
 
-void SHA256::transform(const uint8_t* data) {
-    uint32_t w[64];
-    uint32_t a, b, c, d, e, f, g, h_temp;
-    uint32_t t1, t2;
-    
-    // Prepare message schedule
-    for (int i = 0; i < 16; i++) {
-        w[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | 
-               (data[i * 4 + 2] << 8) | (data[i * 4 + 3]);
-    }
-    
-    for (int i = 16; i < 64; i++) {
-        w[i] = gamma1(w[i - 2]) + w[i - 7] + gamma0(w[i - 15]) + w[i - 16];
-    }
-    
-    // Initialize working variables
-    a = h[0];
-    b = h[1];
-    c = h[2];
-    d = h[3];
-    e = h[4];
-    f = h[5];
-    g = h[6];
-    h_temp = h[7];
-    
-    // Main compression loop
-    for (int i = 0; i < 64; i++) {
-        t1 = h_temp + sigma1(e) + ch(e, f, g) + K[i] + w[i];
-        t2 = sigma0(a) + maj(a, b, c);
-        h_temp = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
-    }
-    
-    // Add compressed chunk to current hash value
-    h[0] += a;
-    h[1] += b;
-    h[2] += c;
-    h[3] += d;
-    h[4] += e;
-    h[5] += f;
-    h[6] += g;
-    h[7] += h_temp;
+void SHA256::compress(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    detail::BlockFn fn = backendFunction(getBackend());
+    if (fn != nullptr) {
+        fn(state, data, blocks);
+    } else {
+        compressScalar(state, data, blocks);
+    }
 }
 
 void SHA256::update(const uint8_t* data, size_t length) {
-    for (size_t i = 0; i < length; i += 64) {
-        size_t blockSize = (length - i >= 64) ? 64 : length - i;
-        if (blockSize == 64) {
-            transform(data + i);
+    totalLength += length;
+    
+    // Top up a pending partial block first
+    if (bufferLength > 0) {
+        size_t take = std::min(BLOCK_SIZE - bufferLength, length);
+        std::memcpy(buffer + bufferLength, data, take);
+        bufferLength += take;
+        data += take;
+        length -= take;
+        
+        if (bufferLength < BLOCK_SIZE) {
+            return;
         }
+        compress(h, buffer, 1);
+        bufferLength = 0;
+    }
+    
+    // Compress whole blocks straight from the input
+    size_t blocks = length / BLOCK_SIZE;
+    if (blocks > 0) {
+        compress(h, data, blocks);
+        data += blocks * BLOCK_SIZE;
+        length -= blocks * BLOCK_SIZE;
+    }
+    
+    // Keep the remainder for the next call
+    if (length > 0) {
+        std::memcpy(buffer, data, length);
+        bufferLength = length;
     }
 }
 
-std::string SHA256::finalize() {
-    std::stringstream ss;
+void SHA256::update(const std::string& data) {
+    update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+SHA256::Digest SHA256::finalize() {
+    const uint64_t bitLength = totalLength * 8;
+    
+    // Append '1' bit (plus 0's)
+    buffer[bufferLength++] = 0x80;
+    if (bufferLength > 56) {
+        std::memset(buffer + bufferLength, 0, BLOCK_SIZE - bufferLength);
+        compress(h, buffer, 1);
+        bufferLength = 0;
+    }
+    
+    // Append 0's until message length ≡ 448 (mod 512)
+    std::memset(buffer + bufferLength, 0, 56 - bufferLength);
+    
+    // Append length as 64-bit big-endian integer
     for (int i = 0; i < 8; i++) {
-        ss << std::hex << std::setfill('0') << std::setw(8) << h[i];
+        buffer[56 + i] = static_cast<uint8_t>(bitLength >> ((7 - i) * 8));
     }
-    return ss.str();
+    compress(h, buffer, 1);
+    bufferLength = 0;
+    
+    Digest out;
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+    return out;
 }
 
-std::string SHA256::hash(const std::string& input) {
+SHA256::Digest SHA256::digest(const uint8_t* data, size_t length) {
     SHA256 sha;
+    sha.update(data, length);
+    return sha.finalize();
+}
+
+SHA256::Digest SHA256::digest(const std::string& input) {
+    return digest(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+std::string SHA256::hash(const std::string& input) {
+    return toHex(digest(input));
+}
+
+// ============================================================================
+// Batch hashing
+// ============================================================================
+
+namespace {
+
+constexpr size_t MAX_LANES = 16;
+
+/**
+ * @brief State shared by every message of a batch
+ * 
+ * The compression words after the whole blocks of a common prefix (its
+ * midstate), plus the prefix bytes still waiting in the buffer.
+ */
+struct Prefix {
+    const uint32_t* h;
+    const uint8_t* buffer;
+    size_t bufferLength;
+    uint64_t totalLength;
+};
+
+/**
+ * @brief Build the padded final block(s) of a message
+ * @param head Bytes preceding data in the final block(s)
+ * @param headLength Number of head bytes
+ * @param data Remaining message bytes (less than one block together with head)
+ * @param length Number of remaining bytes
+ * @param totalLength Total message length in bytes
+ * @param tail Output buffer
+ * @return Number of 64-byte tail blocks written (1 or 2)
+ */
+size_t padTail(const uint8_t* head, size_t headLength, const uint8_t* data, size_t length,
+               uint64_t totalLength, uint8_t tail[128]) {
+    size_t used = headLength + length;
+    size_t tailBlocks = (used + 9 <= 64) ? 1 : 2;
     
-    std::vector<uint8_t> data(input.begin(), input.end());
+    std::memset(tail, 0, tailBlocks * 64);
+    if (headLength > 0) {
+        std::memcpy(tail, head, headLength);
+    }
+    if (length > 0) {
+        std::memcpy(tail + headLength, data, length);
+    }
+    tail[used] = 0x80;
     
-    // Pre-processing: adding padding bits
-    size_t originalLength = data.size();
-    size_t bitLength = originalLength * 8;
+    uint64_t bitLength = totalLength * 8;
+    uint8_t* end = tail + tailBlocks * 64;
+    for (int i = 1; i <= 8; i++) {
+        end[-i] = static_cast<uint8_t>(bitLength >> ((i - 1) * 8));
+    }
+    return tailBlocks;
+}
+
+void storeDigest(const uint32_t* words, size_t stride, uint8_t* out) {
+    for (int i = 0; i < 8; i++) {
+        uint32_t word = words[i * stride];
+        out[i * 4] = static_cast<uint8_t>(word >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(word >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(word >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(word);
+    }
+}
+
+/**
+ * @brief One message in flight inside a multi-buffer lane
+ * 
+ * Blocks are taken in order from: head (the prefix buffer topped up with
+ * the start of the message), data, then the padded tail.
+ */
+struct Lane {
+    bool active = false;
+    size_t message = 0;           ///< Index of the message in the batch
+    const uint8_t* data = nullptr;
+    size_t headBlocks = 0;        ///< 0 or 1 block in head
+    size_t dataBlocks = 0;        ///< Blocks read straight from the input
+    size_t totalBlocks = 0;       ///< head + data + padded tail blocks
+    size_t next = 0;              ///< Next block to compress
+    uint8_t head[64];             ///< Prefix buffer + first message bytes
+    uint8_t tail[128];            ///< Padded final block(s)
     
-    // Append '1' bit (plus 0's)
-    data.push_back(0x80);
+    const uint8_t* block(size_t i) const {
+        if (i < headBlocks) {
+            return head;
+        }
+        i -= headBlocks;
+        if (i < dataBlocks) {
+            return data + i * 64;
+        }
+        return tail + (i - dataBlocks) * 64;
+    }
     
-    // Append 0's until message length ≡ 448 (mod 512)
-    while ((data.size() % 64) != 56) {
-        data.push_back(0x00);
+    void load(const Prefix& prefix, const uint8_t* message, size_t length) {
+        const uint64_t totalLength = prefix.totalLength + length;
+        headBlocks = 0;
+        
+        if (prefix.bufferLength + length < 64) {
+            // Prefix buffer and message both fit in the tail
+            data = message;
+            dataBlocks = 0;
+            totalBlocks = padTail(prefix.buffer, prefix.bufferLength, message, length,
+                                  totalLength, tail);
+            return;
+        }
+        
+        if (prefix.bufferLength > 0) {
+            size_t take = 64 - prefix.bufferLength;
+            std::memcpy(head, prefix.buffer, prefix.bufferLength);
+            std::memcpy(head + prefix.bufferLength, message, take);
+            headBlocks = 1;
+            message += take;
+            length -= take;
+        }
+        
+        data = message;
+        dataBlocks = length / 64;
+        size_t remainder = length % 64;
+        totalBlocks = headBlocks + dataBlocks +
+                      padTail(nullptr, 0, message + dataBlocks * 64, remainder, totalLength, tail);
     }
+};
+
+void runMultiBuffer(detail::MultiBlockFn kernel, size_t lanes, const Prefix& prefix,
+                    const uint8_t* const* messages, const size_t* lengths,
+                    size_t count, uint8_t* digests) {
+    static const uint8_t idleBlock[64] = {};
     
-    // Append length as 64-bit big-endian integer
-    for (int i = 7; i >= 0; i--) {
-        data.push_back((bitLength >> (i * 8)) & 0xFF);
+    uint32_t state[8 * MAX_LANES];
+    const uint8_t* blocks[MAX_LANES];
+    Lane lane[MAX_LANES];
+    size_t nextMessage = 0;
+    size_t active = 0;
+    
+    auto assign = [&](size_t l) {
+        if (nextMessage >= count) {
+            lane[l].active = false;
+            return;
+        }
+        Lane& ln = lane[l];
+        ln.active = true;
+        ln.message = nextMessage;
+        ln.load(prefix, messages[nextMessage], lengths[nextMessage]);
+        ln.next = 0;
+        for (int i = 0; i < 8; i++) {
+            state[i * lanes + l] = prefix.h[i];
+        }
+        nextMessage++;
+        active++;
+    };
+    
+    for (size_t l = 0; l < lanes; l++) {
+        assign(l);
+    }
+    
+    while (active > 0) {
+        for (size_t l = 0; l < lanes; l++) {
+            blocks[l] = lane[l].active ? lane[l].block(lane[l].next) : idleBlock;
+        }
+        
+        kernel(state, blocks);
+        
+        for (size_t l = 0; l < lanes; l++) {
+            Lane& ln = lane[l];
+            if (!ln.active || ++ln.next < ln.totalBlocks) {
+                continue;
+            }
+            storeDigest(state + l, lanes, digests + ln.message * 32);
+            active--;
+            assign(l);
+        }
     }
+}
+
+void runScalar(const SHA256& prefix, const uint8_t* const* messages, const size_t* lengths,
+               size_t count, uint8_t* digests) {
+    for (size_t m = 0; m < count; m++) {
+        SHA256 sha = prefix;
+        sha.update(messages[m], lengths[m]);
+        SHA256::Digest digest = sha.finalize();
+        std::memcpy(digests + m * SHA256::DIGEST_SIZE, digest.data(), SHA256::DIGEST_SIZE);
+    }
+}
+
+BatchKernel bestBatchKernel() {
+    if (SHA256::isBatchKernelSupported(BatchKernel::AVX512)) return BatchKernel::AVX512;
+    // One SHA-NI stream outruns the 4- and 8-lane software kernels
+    if (SHA256::isBackendSupported(HashBackend::SHA_NI)) return BatchKernel::SCALAR;
+    if (SHA256::isBatchKernelSupported(BatchKernel::AVX2)) return BatchKernel::AVX2;
+    if (SHA256::isBatchKernelSupported(BatchKernel::SSE2)) return BatchKernel::SSE2;
+    return BatchKernel::SCALAR;
+}
+
+std::atomic<BatchKernel>& selectedBatchKernel() {
+    static std::atomic<BatchKernel> kernel(bestBatchKernel());
+    return kernel;
+}
+
+} // namespace
+
+bool SHA256::isBatchKernelSupported(BatchKernel kernel) {
+    switch (kernel) {
+        case BatchKernel::SCALAR: return true;
+#ifdef CRYPTO_X86_KERNELS
+        case BatchKernel::SSE2: return cpuFeatures().sse2;
+        case BatchKernel::AVX2: return cpuFeatures().avx2;
+        case BatchKernel::AVX512: return cpuFeatures().avx512f;
+#endif
+        default: return false;
+    }
+}
+
+BatchKernel SHA256::getBatchKernel() {
+    return selectedBatchKernel().load(std::memory_order_relaxed);
+}
+
+bool SHA256::setBatchKernel(BatchKernel kernel) {
+    if (!isBatchKernelSupported(kernel)) {
+        return false;
+    }
+    selectedBatchKernel().store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+size_t SHA256::getBatchLanes() {
+    switch (getBatchKernel()) {
+        case BatchKernel::SSE2: return 4;
+        case BatchKernel::AVX2: return 8;
+        case BatchKernel::AVX512: return 16;
+        default: return 1;
+    }
+}
+
+void SHA256::hashBatch(const uint8_t* const* messages, const size_t* lengths,
+                       size_t count, uint8_t* digests) {
+    SHA256().hashSuffixBatch(messages, lengths, count, digests);
+}
+
+void SHA256::hashSuffixBatch(const uint8_t* const* suffixes, const size_t* lengths,
+                             size_t count, uint8_t* digests) const {
+    BatchKernel kernel = getBatchKernel();
     
-    // Process each 512-bit chunk
-    for (size_t i = 0; i < data.size(); i += 64) {
-        sha.transform(data.data() + i);
+    // A single message gains nothing from idle lanes
+    if (count < 2) {
+        kernel = BatchKernel::SCALAR;
     }
     
-    return sha.finalize();
+    const Prefix prefix = {h, buffer, bufferLength, totalLength};
+    
+    switch (kernel) {
+#ifdef CRYPTO_X86_KERNELS
+        case BatchKernel::SSE2:
+            runMultiBuffer(detail::sha256TransformSse2x4, 4, prefix, suffixes, lengths, count, digests);
+            return;
+        case BatchKernel::AVX2:
+            runMultiBuffer(detail::sha256TransformAvx2x8, 8, prefix, suffixes, lengths, count, digests);
+            return;
+        case BatchKernel::AVX512:
+            runMultiBuffer(detail::sha256TransformAvx512x16, 16, prefix, suffixes, lengths, count, digests);
+            return;
+#endif
+        default:
+            runScalar(*this, suffixes, lengths, count, digests);
+            return;
+    }
+}
+
+std::vector<std::string> SHA256::hashBatch(const std::vector<std::string>& inputs) {
+    std::vector<const uint8_t*> messages(inputs.size());
+    std::vector<size_t> lengths(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        messages[i] = reinterpret_cast<const uint8_t*>(inputs[i].data());
+        lengths[i] = inputs[i].size();
+    }
+    
+    std::vector<uint8_t> digests(inputs.size() * DIGEST_SIZE);
+    hashBatch(messages.data(), lengths.data(), inputs.size(), digests.data());
+    
+    std::vector<std::string> result(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        result[i] = toHex(digests.data() + i * DIGEST_SIZE, DIGEST_SIZE);
+    }
+    return result;
 }
 
 } // namespace crypto
\ No newline at end of file
@@ -0,0 +1,65 @@
+/**
+ * @file sha256_avx2.cpp
+ * @brief 8-lane AVX2 multi-buffer SHA-256 kernel
+ *
+ * Built with AVX2 code generation enabled; only called after the
+ * runtime CPU check in cpu_features.cpp succeeds.
+ */
+
+#include "sha256_kernels.h"
+
+#ifdef CRYPTO_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace crypto {
+namespace detail {
+
+namespace {
+
+struct Avx2 {
+    using Reg = __m256i;
+    static constexpr size_t LANES = 8;
+
+    static Reg load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t* p, Reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+    static Reg set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static Reg add(Reg x, Reg y) { return _mm256_add_epi32(x, y); }
+    static Reg bxor(Reg x, Reg y) { return _mm256_xor_si256(x, y); }
+
+    template <int N>
+    static Reg shr(Reg x) { return _mm256_srli_epi32(x, N); }
+
+    template <int N>
+    static Reg rotr(Reg x) { return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N)); }
+
+    static Reg ch(Reg x, Reg y, Reg z) {
+        return _mm256_xor_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z));
+    }
+
+    static Reg maj(Reg x, Reg y, Reg z) {
+        return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)));
+    }
+
+    static Reg gatherBE32(const uint8_t* const* blocks, int offset) {
+        return _mm256_setr_epi32(static_cast<int>(loadBE32(blocks[0] + offset)),
+                                 static_cast<int>(loadBE32(blocks[1] + offset)),
+                                 static_cast<int>(loadBE32(blocks[2] + offset)),
+                                 static_cast<int>(loadBE32(blocks[3] + offset)),
+                                 static_cast<int>(loadBE32(blocks[4] + offset)),
+                                 static_cast<int>(loadBE32(blocks[5] + offset)),
+                                 static_cast<int>(loadBE32(blocks[6] + offset)),
+                                 static_cast<int>(loadBE32(blocks[7] + offset)));
+    }
+};
+
+} // namespace
+
+void sha256TransformAvx2x8(uint32_t* state, const uint8_t* const* blocks) {
+    transformLanes<Avx2>(state, blocks);
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // CRYPTO_X86_KERNELS
@@ -0,0 +1,140 @@
+/**
+ * @file sha256_kernels.h
+ * @brief Internal SHA-256 compression kernels (not installed)
+ *
+ * Single-stream kernels compress consecutive blocks of one message
+ * (scalar or SHA-NI). The multi-buffer kernels compress one 64-byte
+ * block for each of N independent messages at once; every ISA-specific
+ * translation unit instantiates transformLanes() with its own vector
+ * wrapper, so the round logic is written exactly once.
+ */
+
+#ifndef SHA256_KERNELS_H
+#define SHA256_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRYPTO_X86_KERNELS 1
+#endif
+
+namespace crypto {
+namespace detail {
+
+// SHA-256 constants (first 32 bits of fractional parts of cube roots of first 64 primes)
+constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// SHA-256 initial hash values (first 32 bits of fractional parts of square roots of first 8 primes)
+constexpr uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * @brief Multi-buffer compression function
+ * @param state Lane states, word-major: state[word * lanes + lane]
+ * @param blocks One 64-byte block pointer per lane
+ */
+using MultiBlockFn = void (*)(uint32_t* state, const uint8_t* const* blocks);
+
+/**
+ * @brief Single-stream compression over consecutive blocks
+ * @param state Eight working hash words
+ * @param data Message blocks (blocks * 64 bytes)
+ * @param blocks Number of blocks
+ */
+using BlockFn = void (*)(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+#ifdef CRYPTO_X86_KERNELS
+void sha256TransformShaNi(uint32_t state[8], const uint8_t* data, size_t blocks);
+void sha256TransformSse2x4(uint32_t* state, const uint8_t* const* blocks);
+void sha256TransformAvx2x8(uint32_t* state, const uint8_t* const* blocks);
+void sha256TransformAvx512x16(uint32_t* state, const uint8_t* const* blocks);
+#endif
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/**
+ * @brief Generic lane-parallel SHA-256 compression
+ *
+ * V wraps one SIMD register type and must provide LANES, Reg, load,
+ * store, set1, add, bxor, shr<N>, rotr<N>, ch, maj and gatherBE32.
+ */
+template <typename V>
+inline void transformLanes(uint32_t* state, const uint8_t* const* blocks) {
+    using Reg = typename V::Reg;
+    constexpr size_t L = V::LANES;
+
+    Reg w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = V::gatherBE32(blocks, i * 4);
+    }
+    for (int i = 16; i < 64; i++) {
+        Reg s0 = V::bxor(V::bxor(V::template rotr<7>(w[i - 15]), V::template rotr<18>(w[i - 15])),
+                         V::template shr<3>(w[i - 15]));
+        Reg s1 = V::bxor(V::bxor(V::template rotr<17>(w[i - 2]), V::template rotr<19>(w[i - 2])),
+                         V::template shr<10>(w[i - 2]));
+        w[i] = V::add(V::add(s1, w[i - 7]), V::add(s0, w[i - 16]));
+    }
+
+    Reg a = V::load(state + 0 * L);
+    Reg b = V::load(state + 1 * L);
+    Reg c = V::load(state + 2 * L);
+    Reg d = V::load(state + 3 * L);
+    Reg e = V::load(state + 4 * L);
+    Reg f = V::load(state + 5 * L);
+    Reg g = V::load(state + 6 * L);
+    Reg h = V::load(state + 7 * L);
+
+    for (int i = 0; i < 64; i++) {
+        Reg sigma1 = V::bxor(V::bxor(V::template rotr<6>(e), V::template rotr<11>(e)),
+                             V::template rotr<25>(e));
+        Reg t1 = V::add(V::add(h, sigma1), V::add(V::ch(e, f, g), V::add(V::set1(SHA256_K[i]), w[i])));
+        Reg sigma0 = V::bxor(V::bxor(V::template rotr<2>(a), V::template rotr<13>(a)),
+                             V::template rotr<22>(a));
+        Reg t2 = V::add(sigma0, V::maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = V::add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = V::add(t1, t2);
+    }
+
+    V::store(state + 0 * L, V::add(V::load(state + 0 * L), a));
+    V::store(state + 1 * L, V::add(V::load(state + 1 * L), b));
+    V::store(state + 2 * L, V::add(V::load(state + 2 * L), c));
+    V::store(state + 3 * L, V::add(V::load(state + 3 * L), d));
+    V::store(state + 4 * L, V::add(V::load(state + 4 * L), e));
+    V::store(state + 5 * L, V::add(V::load(state + 5 * L), f));
+    V::store(state + 6 * L, V::add(V::load(state + 6 * L), g));
+    V::store(state + 7 * L, V::add(V::load(state + 7 * L), h));
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // SHA256_KERNELS_H
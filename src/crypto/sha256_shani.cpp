@@ -0,0 +1,83 @@
+/**
+ * @file sha256_shani.cpp
+ * @brief SHA-256 compression using the Intel SHA extensions (SHA-NI)
+ *
+ * Built with SHA/SSE4.1 code generation enabled; only called after the
+ * runtime CPU check in cpu_features.cpp reports SHA-NI support.
+ */
+
+#include "sha256_kernels.h"
+
+#ifdef CRYPTO_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace crypto {
+namespace detail {
+
+namespace {
+
+// Four rounds: sha256rnds2 consumes two message words per call
+inline void rounds4(__m128i& abef, __m128i& cdgh, __m128i msg, int group) {
+    msg = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_K[group * 4])));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E));
+}
+
+// Next four message schedule words from the previous sixteen
+inline __m128i nextMessage(__m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+    __m128i t = _mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), _mm_alignr_epi8(m3, m2, 4));
+    return _mm_sha256msg2_epu32(t, m3);
+}
+
+} // namespace
+
+void sha256TransformShaNi(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    
+    // Repack a..h into the ABEF / CDGH register layout used by sha256rnds2
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+    
+    for (; blocks > 0; blocks--, data += 64) {
+        const __m128i abefSave = abef;
+        const __m128i cdghSave = cdgh;
+        
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0)), byteSwap);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), byteSwap);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), byteSwap);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), byteSwap);
+        
+        rounds4(abef, cdgh, m0, 0);
+        rounds4(abef, cdgh, m1, 1);
+        rounds4(abef, cdgh, m2, 2);
+        rounds4(abef, cdgh, m3, 3);
+        
+        for (int group = 4; group < 16; group += 4) {
+            m0 = nextMessage(m0, m1, m2, m3);
+            rounds4(abef, cdgh, m0, group);
+            m1 = nextMessage(m1, m2, m3, m0);
+            rounds4(abef, cdgh, m1, group + 1);
+            m2 = nextMessage(m2, m3, m0, m1);
+            rounds4(abef, cdgh, m2, group + 2);
+            m3 = nextMessage(m3, m0, m1, m2);
+            rounds4(abef, cdgh, m3, group + 3);
+        }
+        
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+    
+    // Back to a..h order
+    tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, cdgh, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // CRYPTO_X86_KERNELS
@@ -0,0 +1,58 @@
+/**
+ * @file sha256_sse2.cpp
+ * @brief 4-lane SSE2 multi-buffer SHA-256 kernel
+ */
+
+#include "sha256_kernels.h"
+
+#ifdef CRYPTO_X86_KERNELS
+
+#include <emmintrin.h>
+
+namespace crypto {
+namespace detail {
+
+namespace {
+
+struct Sse2 {
+    using Reg = __m128i;
+    static constexpr size_t LANES = 4;
+
+    static Reg load(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t* p, Reg x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+    static Reg set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static Reg add(Reg x, Reg y) { return _mm_add_epi32(x, y); }
+    static Reg bxor(Reg x, Reg y) { return _mm_xor_si128(x, y); }
+
+    template <int N>
+    static Reg shr(Reg x) { return _mm_srli_epi32(x, N); }
+
+    template <int N>
+    static Reg rotr(Reg x) { return _mm_or_si128(_mm_srli_epi32(x, N), _mm_slli_epi32(x, 32 - N)); }
+
+    static Reg ch(Reg x, Reg y, Reg z) {
+        return _mm_xor_si128(_mm_and_si128(x, y), _mm_andnot_si128(x, z));
+    }
+
+    static Reg maj(Reg x, Reg y, Reg z) {
+        return _mm_or_si128(_mm_and_si128(x, y), _mm_and_si128(z, _mm_or_si128(x, y)));
+    }
+
+    static Reg gatherBE32(const uint8_t* const* blocks, int offset) {
+        return _mm_setr_epi32(static_cast<int>(loadBE32(blocks[0] + offset)),
+                              static_cast<int>(loadBE32(blocks[1] + offset)),
+                              static_cast<int>(loadBE32(blocks[2] + offset)),
+                              static_cast<int>(loadBE32(blocks[3] + offset)));
+    }
+};
+
+} // namespace
+
+void sha256TransformSse2x4(uint32_t* state, const uint8_t* const* blocks) {
+    transformLanes<Sse2>(state, blocks);
+}
+
+} // namespace detail
+} // namespace crypto
+
+#endif // CRYPTO_X86_KERNELS
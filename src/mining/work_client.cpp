@@ -0,0 +1,129 @@
+/**
+ * @file work_client.cpp
+ * @brief Implementation of the miner-side get-work client
+ */
+
+#include "mining/work_client.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace blockchain {
+namespace mining {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool sendAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = ::send(fd, data, length, SEND_FLAGS);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool receiveAll(int fd, uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = ::recv(fd, data, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+} // namespace
+
+WorkClient::WorkClient() : fd(-1) {
+}
+
+WorkClient::~WorkClient() {
+    close();
+}
+
+bool WorkClient::connect(const std::string& socketPath) {
+    close();
+
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void WorkClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool WorkClient::exchange(MessageType request, const uint8_t* payload, size_t length,
+                          MessageType reply, uint8_t* replyPayload, size_t replyLength) {
+    if (fd < 0) {
+        return false;
+    }
+
+    uint8_t type = static_cast<uint8_t>(request);
+    uint8_t replyType = 0;
+    if (!sendAll(fd, &type, 1) || !sendAll(fd, payload, length) ||
+        !receiveAll(fd, &replyType, 1) || replyType != static_cast<uint8_t>(reply) ||
+        !receiveAll(fd, replyPayload, replyLength)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool WorkClient::getWork(WorkUnit& work) {
+    uint8_t reply[WorkUnit::SIZE];
+    if (!exchange(MessageType::GET_WORK, nullptr, 0, MessageType::WORK, reply, sizeof(reply))) {
+        return false;
+    }
+    work = WorkUnit::decode(reply);
+    return true;
+}
+
+bool WorkClient::submit(const Submission& submission, SubmitStatus& status) {
+    uint8_t request[Submission::SIZE];
+    submission.encode(request);
+    uint8_t reply = 0;
+    if (!exchange(MessageType::SUBMIT, request, sizeof(request), MessageType::SUBMIT_RESULT, &reply, 1)) {
+        return false;
+    }
+    status = static_cast<SubmitStatus>(reply);
+    return true;
+}
+
+} // namespace mining
+} // namespace blockchain
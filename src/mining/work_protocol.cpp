@@ -0,0 +1,77 @@
+/**
+ * @file work_protocol.cpp
+ * @brief Implementation of the get-work wire format
+ */
+
+#include "mining/work_protocol.h"
+
+namespace blockchain {
+namespace mining {
+
+namespace {
+
+void storeLE32(uint8_t* out, uint32_t value) {
+    for (size_t i = 0; i < 4; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+uint32_t loadLE32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+void WorkUnit::encode(uint8_t* out) const {
+    storeLE32(out, jobId);
+    header.encode(out + 4);
+    storeLE32(out + 4 + BlockHeader::SIZE, nonceStart);
+    storeLE32(out + 8 + BlockHeader::SIZE, nonceCount);
+}
+
+WorkUnit WorkUnit::decode(const uint8_t* in) {
+    WorkUnit work;
+    work.jobId = loadLE32(in);
+    work.header = BlockHeader::decode(in + 4);
+    work.nonceStart = loadLE32(in + 4 + BlockHeader::SIZE);
+    work.nonceCount = loadLE32(in + 8 + BlockHeader::SIZE);
+    return work;
+}
+
+void Submission::encode(uint8_t* out) const {
+    storeLE32(out, jobId);
+    storeLE32(out + 4, nonce);
+}
+
+Submission Submission::decode(const uint8_t* in) {
+    Submission submission;
+    submission.jobId = loadLE32(in);
+    submission.nonce = loadLE32(in + 4);
+    return submission;
+}
+
+bool payloadSize(uint8_t type, size_t& size) {
+    switch (static_cast<MessageType>(type)) {
+        case MessageType::GET_WORK: size = 0; return true;
+        case MessageType::WORK: size = WorkUnit::SIZE; return true;
+        case MessageType::SUBMIT: size = Submission::SIZE; return true;
+        case MessageType::SUBMIT_RESULT: size = 1; return true;
+    }
+    return false;
+}
+
+const char* toString(SubmitStatus status) {
+    switch (status) {
+        case SubmitStatus::ACCEPTED: return "accepted";
+        case SubmitStatus::STALE: return "stale";
+        case SubmitStatus::INVALID: return "invalid";
+    }
+    return "unknown";
+}
+
+} // namespace mining
+} // namespace blockchain
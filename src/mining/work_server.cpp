@@ -0,0 +1,270 @@
+/**
+ * @file work_server.cpp
+ * @brief Implementation of the get-work server
+ */
+
+#include "mining/work_server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace blockchain {
+namespace mining {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+// The header nonce is 32 bits; a job is replaced once all of them are handed out
+constexpr uint64_t NONCE_LIMIT = static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) + 1;
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Send a whole message; replies are small, so a full socket
+ *        buffer means the miner stopped reading
+ */
+bool sendMessage(int fd, MessageType type, const uint8_t* payload, size_t length) {
+    uint8_t message[1 + WorkUnit::SIZE];
+    message[0] = static_cast<uint8_t>(type);
+    std::memcpy(message + 1, payload, length);
+    ssize_t sent = ::send(fd, message, 1 + length, SEND_FLAGS);
+    return sent == static_cast<ssize_t>(1 + length);
+}
+
+} // namespace
+
+WorkServer::WorkServer(Blockchain& chain, const std::string& socketPath, TransactionSource source,
+                       uint32_t nonceRange)
+    : chain(chain), socketPath(socketPath), source(std::move(source)),
+      nonceRange(std::max(1u, nonceRange)), listenFd(-1), nextJobId(1), jobsTip(0),
+      blocksAccepted(0), submissionsRejected(0) {
+}
+
+WorkServer::~WorkServer() {
+    shutdown();
+}
+
+bool WorkServer::start() {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "✗ Socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "✗ socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "✗ Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    std::cout << "✓ Work server listening on " << socketPath << std::endl;
+    return true;
+}
+
+void WorkServer::shutdown() {
+    for (auto& client : clients) {
+        ::close(client.fd);
+    }
+    clients.clear();
+
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+        listenFd = -1;
+    }
+}
+
+void WorkServer::run(const std::atomic<bool>& stop) {
+    while (!stop.load(std::memory_order_relaxed)) {
+        poll(100);
+    }
+}
+
+void WorkServer::poll(int timeoutMs) {
+    if (listenFd < 0) {
+        return;
+    }
+
+    std::vector<pollfd> fds;
+    fds.reserve(clients.size() + 1);
+    fds.push_back({listenFd, POLLIN, 0});
+    for (const auto& client : clients) {
+        fds.push_back({client.fd, POLLIN, 0});
+    }
+
+    if (::poll(fds.data(), fds.size(), timeoutMs) <= 0) {
+        return;
+    }
+
+    // Serve existing clients first; fds[i + 1] belongs to clients[i]
+    std::vector<Client> remaining;
+    remaining.reserve(clients.size());
+    for (size_t i = 0; i < clients.size(); i++) {
+        if (fds[i + 1].revents != 0 && !serviceClient(clients[i])) {
+            ::close(clients[i].fd);
+            continue;
+        }
+        remaining.push_back(std::move(clients[i]));
+    }
+    clients.swap(remaining);
+
+    if (fds[0].revents & POLLIN) {
+        acceptClients();
+    }
+}
+
+void WorkServer::acceptClients() {
+    for (;;) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        if (!setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+        clients.push_back({fd, {}});
+    }
+}
+
+bool WorkServer::serviceClient(Client& client) {
+    uint8_t buffer[512];
+    for (;;) {
+        ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            client.inbox.insert(client.inbox.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < client.inbox.size()) {
+        size_t length = 0;
+        if (!payloadSize(client.inbox[offset], length)) {
+            return false;
+        }
+        if (client.inbox.size() - offset < 1 + length) {
+            break;
+        }
+
+        const MessageType type = static_cast<MessageType>(client.inbox[offset]);
+        const uint8_t* payload = client.inbox.data() + offset + 1;
+        offset += 1 + length;
+
+        if (type == MessageType::GET_WORK) {
+            uint8_t reply[WorkUnit::SIZE];
+            assignWork().encode(reply);
+            if (!sendMessage(client.fd, MessageType::WORK, reply, sizeof(reply))) {
+                return false;
+            }
+        } else if (type == MessageType::SUBMIT) {
+            uint8_t reply = static_cast<uint8_t>(acceptSubmission(Submission::decode(payload)));
+            if (!sendMessage(client.fd, MessageType::SUBMIT_RESULT, &reply, 1)) {
+                return false;
+            }
+        } else {
+            // Server-to-client messages are never valid requests
+            return false;
+        }
+    }
+
+    client.inbox.erase(client.inbox.begin(), client.inbox.begin() + offset);
+    return true;
+}
+
+WorkUnit WorkServer::assignWork() {
+    // A new tip invalidates every template built on the old one
+    if (jobsTip != chain.getChainLength()) {
+        jobs.clear();
+        jobsTip = chain.getChainLength();
+    }
+
+    auto current = jobs.empty() ? jobs.end() : std::prev(jobs.end());
+    if (current == jobs.end() || current->second.nextNonce >= NONCE_LIMIT) {
+        Job job{chain.createBlockTemplate(source ? source() : std::vector<Transaction>()), 0};
+        
+        // A template from the same second would repeat the exhausted header
+        if (current != jobs.end()) {
+            while (job.block.getTimestamp() <= current->second.block.getTimestamp()) {
+                job.block.rollTimestamp();
+            }
+        }
+        current = jobs.emplace(nextJobId++, std::move(job)).first;
+        if (jobs.size() > MAX_JOBS) {
+            jobs.erase(jobs.begin());
+        }
+    }
+
+    Job& job = current->second;
+    WorkUnit work;
+    work.jobId = current->first;
+    work.header = job.block.getHeader();
+    work.nonceStart = static_cast<uint32_t>(job.nextNonce);
+    work.nonceCount = static_cast<uint32_t>(std::min<uint64_t>(nonceRange, NONCE_LIMIT - job.nextNonce));
+    job.nextNonce += work.nonceCount;
+    return work;
+}
+
+SubmitStatus WorkServer::acceptSubmission(const Submission& submission) {
+    auto it = jobs.find(submission.jobId);
+    if (it == jobs.end() || jobsTip != chain.getChainLength()) {
+        submissionsRejected++;
+        return SubmitStatus::STALE;
+    }
+
+    if (submission.nonce >= it->second.nextNonce) {
+        submissionsRejected++;
+        return SubmitStatus::INVALID;
+    }
+
+    Block block = it->second.block;
+    block.setProofOfWork(submission.nonce);
+    if (!chain.submitBlock(block)) {
+        submissionsRejected++;
+        return SubmitStatus::INVALID;
+    }
+
+    blocksAccepted++;
+    std::cout << "  ✓ Block #" << block.getIndex() << " accepted from miner | Job: "
+              << submission.jobId << " | Nonce: " << submission.nonce << std::endl;
+    return SubmitStatus::ACCEPTED;
+}
+
+} // namespace mining
+} // namespace blockchain
@@ -0,0 +1,461 @@
+/**
+ * @file block_store.cpp
+ * @brief Implementation of BlockStore
+ */
+
+#include "storage/block_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace blockchain {
+namespace storage {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t ENTRY_SIZE = 48;
+constexpr size_t COUNT_OFFSET = 8;
+constexpr size_t SLOTS_OFFSET = 16;
+constexpr size_t INITIAL_ENTRIES = 1024;
+constexpr size_t INITIAL_SLOTS = 2048;
+const char INDEX_MAGIC[8] = {'B', 'L', 'K', 'I', 'D', 'X', '0', '1'};
+const char HASHES_MAGIC[8] = {'B', 'L', 'K', 'H', 'S', 'H', '0', '1'};
+
+void storeLE(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+/// Index entry: hash, segment, length, offset
+struct Entry {
+    crypto::Hash256 hash;
+    uint32_t segment;
+    uint32_t length;
+    uint64_t offset;
+};
+
+Entry readEntry(const uint8_t* index, size_t height) {
+    const uint8_t* in = index + HEADER_SIZE + height * ENTRY_SIZE;
+    Entry entry;
+    std::memcpy(entry.hash.data(), in, crypto::Hash256::SIZE);
+    entry.segment = static_cast<uint32_t>(loadLE(in + 32, 4));
+    entry.length = static_cast<uint32_t>(loadLE(in + 36, 4));
+    entry.offset = loadLE(in + 40, 8);
+    return entry;
+}
+
+void writeEntry(uint8_t* index, size_t height, const Entry& entry) {
+    uint8_t* out = index + HEADER_SIZE + height * ENTRY_SIZE;
+    std::memcpy(out, entry.hash.data(), crypto::Hash256::SIZE);
+    storeLE(out + 32, entry.segment, 4);
+    storeLE(out + 36, entry.length, 4);
+    storeLE(out + 40, entry.offset, 8);
+}
+
+bool reportError(const std::string& what, const std::string& path) {
+    std::cerr << "  ✗ Error: " << what << " " << path << ": " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+/**
+ * @brief Map a whole file read-write, resizing it first
+ */
+uint8_t* mapFile(int fd, size_t length) {
+    if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        return nullptr;
+    }
+    void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return mapped == MAP_FAILED ? nullptr : static_cast<uint8_t*>(mapped);
+}
+
+off_t fileSize(int fd) {
+    struct stat info;
+    return fstat(fd, &info) == 0 ? info.st_size : -1;
+}
+
+/**
+ * @brief Make the directory entries of newly created files durable
+ */
+bool syncDirectory(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+} // namespace
+
+BlockStore::BlockStore(uint64_t segmentSize)
+    : segmentSize(std::max<uint64_t>(segmentSize, Block::MIN_ENCODED_SIZE)) {
+}
+
+BlockStore::~BlockStore() {
+    close();
+}
+
+std::string BlockStore::segmentPath(size_t segment) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "blocks-%05zu.dat", segment);
+    return directory + "/" + name;
+}
+
+size_t BlockStore::size() const {
+    return index != nullptr ? static_cast<size_t>(loadLE(index + COUNT_OFFSET, 8)) : 0;
+}
+
+void BlockStore::setCount(size_t count) {
+    storeLE(index + COUNT_OFFSET, count, 8);
+    storeLE(hashes + COUNT_OFFSET, count, 8);
+}
+
+bool BlockStore::open(const std::string& path) {
+    close();
+    directory = path;
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return reportError("Cannot create", directory);
+    }
+    if (!openIndex() || !openSegments() || !openHashes()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool BlockStore::openIndex() {
+    const std::string path = directory + "/index.dat";
+    indexFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (indexFd < 0) {
+        return reportError("Cannot open", path);
+    }
+
+    const off_t existing = fileSize(indexFd);
+    const bool fresh = existing < static_cast<off_t>(HEADER_SIZE);
+    indexCapacity = fresh ? INITIAL_ENTRIES : (static_cast<size_t>(existing) - HEADER_SIZE) / ENTRY_SIZE;
+    index = mapFile(indexFd, HEADER_SIZE + indexCapacity * ENTRY_SIZE);
+    if (index == nullptr) {
+        return reportError("Cannot map", path);
+    }
+
+    if (fresh) {
+        std::memcpy(index, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        storeLE(index + COUNT_OFFSET, 0, 8);
+    } else if (std::memcmp(index, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || size() > indexCapacity) {
+        std::cerr << "  ✗ Error: " << path << " is not a block index" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BlockStore::openSegments() {
+    size_t count = size();
+    std::vector<off_t> sizes;
+
+    // Drop entries an interrupted append left without a complete, matching block
+    while (count > 0) {
+        const Entry last = readEntry(index, count - 1);
+        while (sizes.size() <= last.segment) {
+            int fd = ::open(segmentPath(sizes.size()).c_str(), O_RDONLY);
+            sizes.push_back(fd >= 0 ? fileSize(fd) : -1);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        if (segments.size() <= last.segment) {
+            segments.resize(last.segment + 1);
+        }
+        BlockView view;
+        const Segment* segment = nullptr;
+        if (sizes[last.segment] >= static_cast<off_t>(last.offset + last.length) &&
+            (segment = mapSegment(last.segment)) != nullptr &&
+            BlockView::parse(segment->data + last.offset, last.length, view) &&
+            view.getEncodedSize() == last.length && view.computeHash() == last.hash) {
+            break;
+        }
+        std::cerr << "  ✗ Block store: dropping incomplete block #" << count - 1 << std::endl;
+        count--;
+    }
+    for (auto& segment : segments) {
+        if (segment.data != nullptr) {
+            munmap(const_cast<uint8_t*>(segment.data), segment.mappedLength);
+        }
+    }
+    storeLE(index + COUNT_OFFSET, count, 8);
+
+    // Reopen the tail for appending, cut after the last indexed block
+    size_t tail = 0;
+    tailSize = 0;
+    if (count > 0) {
+        const Entry last = readEntry(index, count - 1);
+        tail = last.segment;
+        tailSize = last.offset + last.length;
+    }
+    segments.assign(tail + 1, Segment());
+    const std::string path = segmentPath(tail);
+    tailFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (tailFd < 0) {
+        return reportError("Cannot open", path);
+    }
+    if (ftruncate(tailFd, static_cast<off_t>(tailSize)) != 0) {
+        return reportError("Cannot truncate", path);
+    }
+    for (size_t next = tail + 1; ::unlink(segmentPath(next).c_str()) == 0; next++) {
+    }
+    return true;
+}
+
+bool BlockStore::openHashes() {
+    const std::string path = directory + "/hashes.idx";
+    hashFd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (hashFd < 0) {
+        return reportError("Cannot open", path);
+    }
+
+    const off_t existing = fileSize(hashFd);
+    if (existing > static_cast<off_t>(HEADER_SIZE)) {
+        hashSlots = (static_cast<size_t>(existing) - HEADER_SIZE) / 4;
+        hashes = mapFile(hashFd, static_cast<size_t>(existing));
+        if (hashes == nullptr) {
+            return reportError("Cannot map", path);
+        }
+        // Trust the table only if it describes exactly the surviving index
+        if (std::memcmp(hashes, HASHES_MAGIC, sizeof(HASHES_MAGIC)) == 0 &&
+            loadLE(hashes + SLOTS_OFFSET, 8) == hashSlots && (hashSlots & (hashSlots - 1)) == 0 &&
+            loadLE(hashes + COUNT_OFFSET, 8) == size()) {
+            return true;
+        }
+    }
+
+    size_t slots = INITIAL_SLOTS;
+    while (slots < 2 * size() + 2) {
+        slots <<= 1;
+    }
+    return rebuildHashes(slots);
+}
+
+bool BlockStore::rebuildHashes(size_t slots) {
+    if (hashes != nullptr) {
+        munmap(hashes, HEADER_SIZE + hashSlots * 4);
+    }
+    hashSlots = slots;
+    hashes = mapFile(hashFd, HEADER_SIZE + hashSlots * 4);
+    if (hashes == nullptr) {
+        return reportError("Cannot map", directory + "/hashes.idx");
+    }
+
+    std::memset(hashes, 0, HEADER_SIZE + hashSlots * 4);
+    std::memcpy(hashes, HASHES_MAGIC, sizeof(HASHES_MAGIC));
+    storeLE(hashes + SLOTS_OFFSET, hashSlots, 8);
+    const size_t count = size();
+    for (size_t height = 0; height < count; height++) {
+        insertHash(readEntry(index, height).hash, height);
+    }
+    storeLE(hashes + COUNT_OFFSET, count, 8);
+    return true;
+}
+
+void BlockStore::insertHash(const crypto::Hash256& hash, size_t height) {
+    // Block hashes are uniformly distributed, so linear probing stays short
+    const size_t mask = hashSlots - 1;
+    size_t slot = static_cast<size_t>(loadLE(hash.data(), 8)) & mask;
+    while (loadLE(hashes + HEADER_SIZE + slot * 4, 4) != 0) {
+        slot = (slot + 1) & mask;
+    }
+    storeLE(hashes + HEADER_SIZE + slot * 4, height + 1, 4);
+}
+
+bool BlockStore::growIndex(size_t entries) {
+    size_t capacity = std::max(indexCapacity * 2, entries);
+    munmap(index, HEADER_SIZE + indexCapacity * ENTRY_SIZE);
+    index = mapFile(indexFd, HEADER_SIZE + capacity * ENTRY_SIZE);
+    if (index == nullptr) {
+        return reportError("Cannot grow", directory + "/index.dat");
+    }
+    indexCapacity = capacity;
+    return true;
+}
+
+bool BlockStore::startSegment() {
+    // sync() only reaches the tail, so the full segment is flushed before it is let go
+    if (fdatasync(tailFd) != 0) {
+        return reportError("Cannot sync", segmentPath(segments.size() - 1));
+    }
+    ::close(tailFd);
+    segments.emplace_back();
+    const std::string path = segmentPath(segments.size() - 1);
+    tailFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    tailSize = 0;
+    if (tailFd < 0) {
+        return reportError("Cannot create", path);
+    }
+    return syncDirectory(directory) || reportError("Cannot sync", directory);
+}
+
+bool BlockStore::append(const Block& block) {
+    const size_t height = size();
+    if (!isOpen() || tailFd < 0 || static_cast<size_t>(block.getIndex()) != height) {
+        std::cerr << "  ✗ Error: Block #" << block.getIndex() << " is not the next block in the store" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> encoded(block.encodedSize());
+    block.encode(encoded.data());
+    if (encoded.size() > UINT32_MAX) {
+        std::cerr << "  ✗ Error: Block #" << height << " is too large to store" << std::endl;
+        return false;
+    }
+    if (tailSize > 0 && tailSize + encoded.size() > segmentSize && !startSegment()) {
+        return false;
+    }
+
+    // Block first, then its index entry, then the count that publishes it
+    size_t written = 0;
+    while (written < encoded.size()) {
+        ssize_t n = pwrite(tailFd, encoded.data() + written, encoded.size() - written,
+                           static_cast<off_t>(tailSize + written));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            // The partial record is overwritten by the next append or cut by open()
+            return reportError("Cannot write", segmentPath(segments.size() - 1));
+        }
+        written += static_cast<size_t>(n);
+    }
+
+    if (height >= indexCapacity && !growIndex(height + 1)) {
+        return false;
+    }
+    writeEntry(index, height, {block.getHash(), static_cast<uint32_t>(segments.size() - 1),
+                               static_cast<uint32_t>(encoded.size()), tailSize});
+    if (2 * (height + 1) > hashSlots) {
+        if (!rebuildHashes(hashSlots * 2)) {
+            return false;
+        }
+    }
+    insertHash(block.getHash(), height);
+    setCount(height + 1);
+    tailSize += encoded.size();
+    return true;
+}
+
+const BlockStore::Segment* BlockStore::mapSegment(size_t segment) const {
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    Segment& mapping = segments[segment];
+    if (mapping.data != nullptr) {
+        return &mapping;
+    }
+    int fd = ::open(segmentPath(segment).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // The tail keeps growing into the reserved range; only written pages are read
+    const off_t length = fileSize(fd);
+    const size_t mappedLength = std::max<size_t>(segmentSize, length > 0 ? static_cast<size_t>(length) : 0);
+    void* mapped = mmap(nullptr, mappedLength, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    mapping.data = static_cast<const uint8_t*>(mapped);
+    mapping.mappedLength = mappedLength;
+    return &mapping;
+}
+
+bool BlockStore::get(size_t height, BlockView& view) const {
+    if (height >= size()) {
+        return false;
+    }
+    const Entry entry = readEntry(index, height);
+    const Segment* segment = entry.segment < segments.size() ? mapSegment(entry.segment) : nullptr;
+    if (segment == nullptr || entry.offset + entry.length > segment->mappedLength) {
+        return false;
+    }
+    return BlockView::parse(segment->data + entry.offset, entry.length, view);
+}
+
+bool BlockStore::getHash(size_t height, crypto::Hash256& hash) const {
+    if (height >= size()) {
+        return false;
+    }
+    hash = readEntry(index, height).hash;
+    return true;
+}
+
+bool BlockStore::findHeight(const crypto::Hash256& hash, size_t& height) const {
+    if (hashes == nullptr) {
+        return false;
+    }
+    const size_t mask = hashSlots - 1;
+    const size_t count = size();
+    for (size_t slot = static_cast<size_t>(loadLE(hash.data(), 8)) & mask;; slot = (slot + 1) & mask) {
+        const uint64_t stored = loadLE(hashes + HEADER_SIZE + slot * 4, 4);
+        if (stored == 0) {
+            return false;
+        }
+        if (stored - 1 < count && readEntry(index, stored - 1).hash == hash) {
+            height = static_cast<size_t>(stored - 1);
+            return true;
+        }
+    }
+}
+
+bool BlockStore::sync() {
+    if (!isOpen()) {
+        return false;
+    }
+    if (fdatasync(tailFd) != 0 ||
+        msync(index, HEADER_SIZE + indexCapacity * ENTRY_SIZE, MS_SYNC) != 0 ||
+        msync(hashes, HEADER_SIZE + hashSlots * 4, MS_SYNC) != 0) {
+        return reportError("Cannot sync", directory);
+    }
+    // Files created by open() must be reachable from the directory too
+    return syncDirectory(directory) || reportError("Cannot sync", directory);
+}
+
+void BlockStore::close() {
+    for (auto& segment : segments) {
+        if (segment.data != nullptr) {
+            munmap(const_cast<uint8_t*>(segment.data), segment.mappedLength);
+        }
+    }
+    segments.clear();
+    if (index != nullptr) {
+        munmap(index, HEADER_SIZE + indexCapacity * ENTRY_SIZE);
+        index = nullptr;
+    }
+    if (hashes != nullptr) {
+        munmap(hashes, HEADER_SIZE + hashSlots * 4);
+        hashes = nullptr;
+    }
+    for (int* fd : {&indexFd, &hashFd, &tailFd}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    indexCapacity = 0;
+    hashSlots = 0;
+    tailSize = 0;
+}
+
+} // namespace storage
+} // namespace blockchain
@@ -0,0 +1,438 @@
+/**
+ * @file journal.cpp
+ * @brief Implementation of the write-ahead Journal
+ */
+
+#include "storage/journal.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace blockchain {
+namespace storage {
+
+namespace {
+
+const char MAGIC[8] = {'B', 'L', 'K', 'W', 'A', 'L', '0', '1'};
+
+struct Crc32cTable {
+    uint32_t entries[256];
+
+    constexpr Crc32cTable() : entries() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+constexpr Crc32cTable CRC_TABLE;
+
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t length) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = CRC_TABLE.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void storeLE(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+uint32_t recordChecksum(const uint8_t* record, const uint8_t* payload, size_t length) {
+    uint32_t crc = crc32c(0, record, 4);
+    crc = crc32c(crc, record + 8, 1);
+    return crc32c(crc, payload, length);
+}
+
+/**
+ * @brief Walk the records after the magic
+ * @param handler Called per record if not null; returning false stops the walk
+ * @param stopped Output: whether handler stopped the walk
+ * @return Offset just past the last complete, intact record
+ */
+size_t walkRecords(const uint8_t* data, size_t size, const Journal::Handler* handler, bool& stopped) {
+    stopped = false;
+    size_t offset = sizeof(MAGIC);
+    while (size - offset >= Journal::RECORD_HEADER_SIZE) {
+        const uint8_t* record = data + offset;
+        const size_t length = static_cast<size_t>(loadLE(record, 4));
+        if (length > Journal::MAX_RECORD_SIZE || size - offset - Journal::RECORD_HEADER_SIZE < length) {
+            break;
+        }
+        const uint8_t* payload = record + Journal::RECORD_HEADER_SIZE;
+        if (loadLE(record + 4, 4) != recordChecksum(record, payload, length)) {
+            break;
+        }
+        if (handler != nullptr && !(*handler)(static_cast<RecordType>(record[8]), payload, length)) {
+            stopped = true;
+            break;
+        }
+        offset += Journal::RECORD_HEADER_SIZE + length;
+    }
+    return offset;
+}
+
+/**
+ * @brief Append the header and payload of one record to a buffer
+ */
+void encodeRecord(std::vector<uint8_t>& out, RecordType type, const uint8_t* payload, size_t length) {
+    uint8_t header[Journal::RECORD_HEADER_SIZE];
+    storeLE(header, length, 4);
+    header[8] = static_cast<uint8_t>(type);
+    storeLE(header + 4, recordChecksum(header, payload, length), 4);
+    out.insert(out.end(), header, header + Journal::RECORD_HEADER_SIZE);
+    out.insert(out.end(), payload, payload + length);
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readAll(int fd, uint8_t* data, size_t length, uint64_t offset) {
+    while (length > 0) {
+        ssize_t n = ::pread(fd, data, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string parentDirectory(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+bool reportError(const std::string& what, const std::string& path) {
+    std::cerr << "  ✗ Error: " << what << " " << path << ": " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+} // namespace
+
+Journal::Journal(std::chrono::microseconds maxDelay, size_t maxBatchBytes)
+    : maxDelay(maxDelay), maxBatchBytes(maxBatchBytes), records(0), batches(0), fileSize(0) {
+}
+
+Journal::~Journal() {
+    close();
+}
+
+bool Journal::open(const std::string& file) {
+    close();
+    path = file;
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return reportError("Cannot open", path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        reportError("Cannot stat", path);
+        close();
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+
+    if (size < sizeof(MAGIC)) {
+        // New file, or the crash came before the magic was complete
+        if (ftruncate(fd, 0) != 0 || ::write(fd, MAGIC, sizeof(MAGIC)) != static_cast<ssize_t>(sizeof(MAGIC)) ||
+            fdatasync(fd) != 0) {
+            reportError("Cannot initialise", path);
+            close();
+            return false;
+        }
+        size = sizeof(MAGIC);
+    } else {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            reportError("Cannot map", path);
+            close();
+            return false;
+        }
+        const uint8_t* data = static_cast<const uint8_t*>(mapped);
+        bool stopped = false;
+        const bool isJournal = std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+        const size_t validEnd = isJournal ? walkRecords(data, size, nullptr, stopped) : 0;
+        munmap(mapped, size);
+        if (!isJournal) {
+            std::cerr << "  ✗ Error: " << path << " is not a journal" << std::endl;
+            close();
+            return false;
+        }
+
+        // Cut the torn tail so new records follow the last intact one
+        if (validEnd < size) {
+            std::cerr << "  ✗ Journal: dropping " << size - validEnd << " bytes of torn tail" << std::endl;
+            if (ftruncate(fd, static_cast<off_t>(validEnd)) != 0 || fdatasync(fd) != 0) {
+                reportError("Cannot truncate", path);
+                close();
+                return false;
+            }
+            size = validEnd;
+        }
+    }
+
+    fileSize = size;
+    records = 0;
+    batches = 0;
+    appended = 0;
+    durable = 0;
+    failed = false;
+    stopping = false;
+    flusher = std::thread(&Journal::flushLoop, this);
+    return true;
+}
+
+void Journal::close() {
+    if (flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        queued.notify_one();
+        flusher.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool Journal::replay(const Handler& handler) const {
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        return reportError("Cannot stat", path);
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return reportError("Cannot map", path);
+    }
+    bool stopped = false;
+    walkRecords(static_cast<const uint8_t*>(mapped), size, &handler, stopped);
+    munmap(mapped, size);
+    return !stopped;
+}
+
+uint64_t Journal::appendAsync(RecordType type, const uint8_t* payload, size_t length) {
+    if (length > MAX_RECORD_SIZE) {
+        return 0;
+    }
+
+    bool wake = false;
+    uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0 || failed || stopping) {
+            return 0;
+        }
+        if (pending.empty()) {
+            pendingSince = std::chrono::steady_clock::now();
+            wake = true;
+        }
+        encodeRecord(pending, type, payload, length);
+        wake = wake || pending.size() >= maxBatchBytes;
+        sequence = ++appended;
+    }
+    if (wake) {
+        queued.notify_one();
+    }
+    return sequence;
+}
+
+bool Journal::waitDurable(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushed.wait(lock, [&]() { return durable >= sequence || failed; });
+    return durable >= sequence;
+}
+
+bool Journal::append(RecordType type, const uint8_t* payload, size_t length) {
+    const uint64_t sequence = appendAsync(type, payload, length);
+    return sequence != 0 && waitDurable(sequence);
+}
+
+bool Journal::appendBlock(const Block& block) {
+    std::vector<uint8_t> encoded(block.encodedSize());
+    block.encode(encoded.data());
+    return append(RecordType::BLOCK, encoded.data(), encoded.size());
+}
+
+bool Journal::appendTransaction(const Transaction& tx, Amount fee) {
+    std::vector<uint8_t> encoded = encodeTransaction(tx, fee);
+    return append(RecordType::TRANSACTION, encoded.data(), encoded.size());
+}
+
+std::vector<uint8_t> Journal::encodeTransaction(const Transaction& tx, Amount fee) {
+    std::vector<uint8_t> encoded(8 + tx.encodedSize());
+    storeLE(encoded.data(), static_cast<uint64_t>(fee), 8);
+    tx.encode(encoded.data() + 8);
+    return encoded;
+}
+
+bool Journal::decodeTransaction(const uint8_t* payload, size_t length, TransactionView& view, Amount& fee) {
+    if (length < 8 || !TransactionView::parse(payload + 8, length - 8, view) ||
+        view.getEncodedSize() != length - 8) {
+        return false;
+    }
+    fee = static_cast<Amount>(loadLE(payload, 8));
+    return true;
+}
+
+bool Journal::truncate() {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushed.wait(lock, [&]() { return durable >= appended || failed; });
+    if (fd < 0 || failed) {
+        return false;
+    }
+    // Nothing is queued and the lock keeps it that way, so the flusher is idle
+    if (ftruncate(fd, static_cast<off_t>(sizeof(MAGIC))) != 0 || fdatasync(fd) != 0) {
+        failed = true;
+        flushed.notify_all();
+        return reportError("Cannot truncate", path);
+    }
+    fileSize = sizeof(MAGIC);
+    return true;
+}
+
+bool Journal::compact(const std::vector<std::vector<uint8_t>>& transactions, uint64_t mark) {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushed.wait(lock, [&]() { return durable >= appended || failed; });
+    if (fd < 0 || failed) {
+        return false;
+    }
+    const uint64_t end = fileSize;
+    if (mark < sizeof(MAGIC) || mark > end) {
+        std::cerr << "  ✗ Error: Journal mark " << mark << " is outside " << path << std::endl;
+        return false;
+    }
+
+    // Nothing is queued and the lock keeps it that way, so the file stops at end
+    std::vector<uint8_t> data(MAGIC, MAGIC + sizeof(MAGIC));
+    for (const auto& payload : transactions) {
+        encodeRecord(data, RecordType::TRANSACTION, payload.data(), payload.size());
+    }
+    const size_t kept = data.size();
+    data.resize(kept + static_cast<size_t>(end - mark));
+    if (!readAll(fd, data.data() + kept, data.size() - kept, mark)) {
+        return reportError("Cannot read", path);
+    }
+
+    // Write beside the journal, then rename over it
+    const std::string temporary = path + ".tmp";
+    int out = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (out < 0) {
+        return reportError("Cannot create", temporary);
+    }
+    if (!writeAll(out, data.data(), data.size()) || fdatasync(out) != 0) {
+        reportError("Cannot write", temporary);
+        ::close(out);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        reportError("Cannot rename", temporary);
+        ::close(out);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    int dirFd = ::open(parentDirectory(path).c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+
+    // The flusher is idle, so it picks up the new file with its next batch
+    ::close(fd);
+    fd = out;
+    fileSize = data.size();
+    return true;
+}
+
+void Journal::flushLoop() {
+    std::vector<uint8_t> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [&]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            break;
+        }
+        if (failed) {
+            // Nothing after a failed batch may become durable
+            pending.clear();
+            flushed.notify_all();
+            continue;
+        }
+
+        // Let more appends join the batch, up to the latency bound
+        queued.wait_until(lock, pendingSince + maxDelay,
+                          [&]() { return stopping || pending.size() >= maxBatchBytes; });
+        batch.swap(pending);
+        const uint64_t last = appended;
+        const uint64_t count = last - durable;
+        lock.unlock();
+
+        const bool ok = writeAll(fd, batch.data(), batch.size()) && fdatasync(fd) == 0;
+        if (!ok) {
+            reportError("Cannot write", path);
+        }
+
+        lock.lock();
+        if (ok) {
+            durable = last;
+            records += count;
+            batches++;
+            fileSize += batch.size();
+        } else {
+            failed = true;
+        }
+        batch.clear();
+        flushed.notify_all();
+    }
+}
+
+} // namespace storage
+} // namespace blockchain
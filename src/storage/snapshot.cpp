@@ -0,0 +1,327 @@
+/**
+ * @file snapshot.cpp
+ * @brief Implementation of ChainSnapshot
+ */
+
+#include "storage/snapshot.h"
+#include "core/block_view.h"
+#include "crypto/hash_policy.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace blockchain {
+namespace storage {
+
+namespace {
+
+const char MAGIC[8] = {'B', 'L', 'K', 'S', 'N', 'P', '0', '2'};
+const size_t PREFIX_SIZE = sizeof(MAGIC) + 8 + crypto::Hash256::SIZE;
+const size_t HEADER_RECORD_SIZE = BlockHeader::SIZE + 1;
+
+void storeLE(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (i * 8);
+    }
+    return value;
+}
+
+/**
+ * @brief Bounds-checked reader over the snapshot body
+ */
+struct Reader {
+    const uint8_t* data;
+    size_t length;
+    size_t offset = 0;
+
+    bool has(uint64_t bytes) const { return length - offset >= bytes; }
+
+    bool read(size_t bytes, uint64_t& value) {
+        if (!has(bytes)) {
+            return false;
+        }
+        value = loadLE(data + offset, bytes);
+        offset += bytes;
+        return true;
+    }
+};
+
+bool reportError(const std::string& what, const std::string& path) {
+    std::cerr << "  ✗ Error: " << what << " " << path << ": " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+bool reportCorrupt(const std::string& path, const std::string& reason) {
+    std::cerr << "  ✗ Error: Snapshot " << path << " is corrupt (" << reason << ")" << std::endl;
+    return false;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string parentDirectory(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+bool ChainSnapshot::save(const std::string& path) const {
+    std::vector<uint8_t> body;
+    body.reserve(headers.size() * HEADER_RECORD_SIZE + replayFilter.size() + 4096);
+
+    storeLE(body, headers.size(), 8);
+    for (const auto& entry : headers) {
+        const size_t at = body.size();
+        body.resize(at + BlockHeader::SIZE);
+        entry.header.encode(body.data() + at);
+        body.push_back(static_cast<uint8_t>(entry.consensusType));
+    }
+
+    storeLE(body, blocks.size(), 4);
+    for (const auto& block : blocks) {
+        const size_t size = block.encodedSize();
+        storeLE(body, size, 4);
+        const size_t at = body.size();
+        body.resize(at + size);
+        try {
+            block.encode(body.data() + at);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "  ✗ Error: Block #" << block.getIndex() << " cannot be encoded: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    storeLE(body, validators.size(), 4);
+    for (const auto& validator : validators) {
+        if (validator.name.size() > 0xFFFF) {
+            std::cerr << "  ✗ Error: Validator name too long for a snapshot" << std::endl;
+            return false;
+        }
+        storeLE(body, validator.name.size(), 2);
+        body.insert(body.end(), validator.name.begin(), validator.name.end());
+        storeLE(body, static_cast<uint64_t>(static_cast<int64_t>(validator.stake)), 8);
+    }
+
+    storeLE(body, bits, 4);
+    storeLE(body, static_cast<uint32_t>(retargetInterval), 4);
+    storeLE(body, static_cast<uint64_t>(targetBlockTime), 8);
+    storeLE(body, requireSignatures ? 1 : 0, 1);
+
+    storeLE(body, confirmedBase, 8);
+    storeLE(body, confirmed.size(), 8);
+    for (const auto& ids : confirmed) {
+        storeLE(body, ids.size(), 4);
+        for (const auto& id : ids) {
+            body.insert(body.end(), id.bytes.begin(), id.bytes.end());
+        }
+    }
+
+    storeLE(body, replayFilter.size(), 8);
+    body.insert(body.end(), replayFilter.begin(), replayFilter.end());
+
+    std::vector<uint8_t> prefix(MAGIC, MAGIC + sizeof(MAGIC));
+    storeLE(prefix, body.size(), 8);
+    const crypto::Hash256 checksum = crypto::ChainHasher::digest(body.data(), body.size());
+    prefix.insert(prefix.end(), checksum.bytes.begin(), checksum.bytes.end());
+
+    // Write beside the target, then rename over it
+    const std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return reportError("Cannot create", temporary);
+    }
+    if (!writeAll(fd, prefix.data(), prefix.size()) || !writeAll(fd, body.data(), body.size()) || fsync(fd) != 0) {
+        reportError("Cannot write", temporary);
+        ::close(fd);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    ::close(fd);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        reportError("Cannot rename", temporary);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    int dirFd = ::open(parentDirectory(path).c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool ChainSnapshot::load(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return reportError("Cannot open", path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        reportError("Cannot stat", path);
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size < PREFIX_SIZE) {
+        ::close(fd);
+        return reportCorrupt(path, "too short");
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return reportError("Cannot map", path);
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+
+    struct Unmap {
+        void* address;
+        size_t size;
+        ~Unmap() { munmap(address, size); }
+    } unmap{mapped, size};
+
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "  ✗ Error: " << path << " is not a snapshot" << std::endl;
+        return false;
+    }
+    const uint64_t bodySize = loadLE(data + sizeof(MAGIC), 8);
+    if (bodySize != size - PREFIX_SIZE) {
+        return reportCorrupt(path, "truncated");
+    }
+    Reader in{data + PREFIX_SIZE, static_cast<size_t>(bodySize)};
+    const crypto::Hash256 checksum = crypto::ChainHasher::digest(in.data, in.length);
+    if (!std::equal(checksum.bytes.begin(), checksum.bytes.end(), data + sizeof(MAGIC) + 8)) {
+        return reportCorrupt(path, "checksum mismatch");
+    }
+
+    uint64_t count = 0;
+    if (!in.read(8, count) || count == 0 || !in.has(count * HEADER_RECORD_SIZE) ||
+        count > in.length / HEADER_RECORD_SIZE) {
+        return reportCorrupt(path, "header chain");
+    }
+    headers.assign(static_cast<size_t>(count), SnapshotHeader());
+    for (auto& entry : headers) {
+        entry.header = BlockHeader::decode(in.data + in.offset);
+        const uint8_t type = in.data[in.offset + BlockHeader::SIZE];
+        if (type > static_cast<uint8_t>(ConsensusType::PROOF_OF_STAKE)) {
+            return reportCorrupt(path, "consensus type");
+        }
+        entry.consensusType = static_cast<ConsensusType>(type);
+        in.offset += HEADER_RECORD_SIZE;
+    }
+
+    if (!in.read(4, count) || count == 0 || count > headers.size()) {
+        return reportCorrupt(path, "block count");
+    }
+    blocks.clear();
+    blocks.reserve(static_cast<size_t>(count));
+    const size_t firstBlock = headers.size() - static_cast<size_t>(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t length = 0;
+        BlockView view;
+        if (!in.read(4, length) || !in.has(length) ||
+            !BlockView::parse(in.data + in.offset, static_cast<size_t>(length), view)) {
+            return reportCorrupt(path, "block encoding");
+        }
+        in.offset += static_cast<size_t>(length);
+        const SnapshotHeader& expected = headers[firstBlock + i];
+        if (view.computeHash() != expected.header.hash() || view.getConsensusType() != expected.consensusType) {
+            return reportCorrupt(path, "block does not match its header");
+        }
+        blocks.push_back(view.toBlock());
+    }
+
+    if (!in.read(4, count)) {
+        return reportCorrupt(path, "validators");
+    }
+    validators.clear();
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t nameLength = 0;
+        uint64_t stake = 0;
+        if (!in.read(2, nameLength) || !in.has(nameLength)) {
+            return reportCorrupt(path, "validators");
+        }
+        std::string name(reinterpret_cast<const char*>(in.data + in.offset), static_cast<size_t>(nameLength));
+        in.offset += static_cast<size_t>(nameLength);
+        if (!in.read(8, stake)) {
+            return reportCorrupt(path, "validators");
+        }
+        validators.emplace_back(name, static_cast<int>(static_cast<int64_t>(stake)));
+    }
+
+    uint64_t fields[4];
+    const size_t widths[4] = {4, 4, 8, 1};
+    for (size_t i = 0; i < 4; i++) {
+        if (!in.read(widths[i], fields[i])) {
+            return reportCorrupt(path, "PoW settings");
+        }
+    }
+    bits = static_cast<uint32_t>(fields[0]);
+    retargetInterval = static_cast<int>(static_cast<int32_t>(fields[1]));
+    targetBlockTime = static_cast<int64_t>(fields[2]);
+    requireSignatures = fields[3] != 0;
+
+    uint64_t base = 0;
+    if (!in.read(8, base) || !in.read(8, count) || base > firstBlock || count > firstBlock - base) {
+        return reportCorrupt(path, "confirmed IDs");
+    }
+    confirmedBase = static_cast<size_t>(base);
+    confirmed.assign(static_cast<size_t>(count), {});
+    for (auto& ids : confirmed) {
+        uint64_t idCount = 0;
+        if (!in.read(4, idCount) || !in.has(idCount * crypto::Hash256::SIZE)) {
+            return reportCorrupt(path, "confirmed IDs");
+        }
+        ids.resize(static_cast<size_t>(idCount));
+        for (auto& id : ids) {
+            std::copy(in.data + in.offset, in.data + in.offset + crypto::Hash256::SIZE, id.bytes.begin());
+            in.offset += crypto::Hash256::SIZE;
+        }
+    }
+
+    if (!in.read(8, count) || !in.has(count) || in.length - in.offset != count) {
+        return reportCorrupt(path, "replay filter");
+    }
+    replayFilter.assign(in.data + in.offset, in.data + in.offset + count);
+
+    // The headers must form one chain ending at the blocks
+    for (size_t height = 0; height < headers.size(); height++) {
+        if (headers[height].header.index != height ||
+            (height > 0 && headers[height].header.previousHash != headers[height - 1].header.hash())) {
+            return reportCorrupt(path, "header chain broken at block " + std::to_string(height));
+        }
+    }
+    return true;
+}
+
+} // namespace storage
+} // namespace blockchain
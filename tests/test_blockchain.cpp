@@ -0,0 +1,1312 @@
+/**
+ * @file test_blockchain.cpp
+ * @brief Test suite for the blockchain library
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Each test is a function that records failed checks; main() runs them
+ * all and exits non-zero if any check failed.
+ */
+
+#include "core/address_table.h"
+#include "core/blockchain.h"
+#include "core/mempool.h"
+#include "core/merkle_tree.h"
+#include "core/replay_filter.h"
+#include "core/transaction_validator.h"
+#include "core/transaction_view.h"
+#include "consensus/proof_of_work.h"
+#include "storage/block_store.h"
+#include "storage/journal.h"
+#include "storage/snapshot.h"
+#include "crypto/sha256.h"
+#include "crypto/blake3.h"
+#include "crypto/sha512.h"
+#include "crypto/ed25519.h"
+#include "crypto/hex.h"
+#include "crypto/hash_policy.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        failures++;
+        std::cerr << "    ✗ " << file << ":" << line << ": " << expression << std::endl;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * @brief Silence the chain's progress output for the lifetime of the guard
+ */
+struct QuietOutput {
+    QuietOutput() { std::cout.setstate(std::ios::failbit); }
+    ~QuietOutput() { std::cout.clear(); }
+};
+
+/**
+ * @brief Collect what the chain reports on std::cerr for the lifetime of the guard
+ */
+struct CapturedErrors {
+    std::ostringstream text;
+    std::streambuf* previous;
+    CapturedErrors() : previous(std::cerr.rdbuf(text.rdbuf())) {}
+    ~CapturedErrors() { std::cerr.rdbuf(previous); }
+};
+
+/**
+ * @brief Empty scratch directory under the system temp directory, removed after the test
+ */
+struct ScratchDirectory {
+    std::string path;
+    explicit ScratchDirectory(const std::string& name)
+        : path((std::filesystem::temp_directory_path() / ("blockchain_test_" + name)).string()) {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+        std::filesystem::create_directories(path, error);
+    }
+    ~ScratchDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+};
+
+std::vector<blockchain::Transaction> makeTransactions(size_t height, size_t count) {
+    std::vector<blockchain::Transaction> txs;
+    for (size_t i = 0; i < count; i++) {
+        txs.push_back(blockchain::Transaction::fromUnits("User" + std::to_string(height), "Shop",
+                                                         static_cast<blockchain::Amount>(1000 + i)));
+    }
+    return txs;
+}
+
+std::vector<crypto::Hash256> makeLeaves(size_t count) {
+    std::vector<crypto::Hash256> leaves;
+    for (const auto& tx : makeTransactions(count, count)) {
+        leaves.push_back(tx.getHash());
+    }
+    return leaves;
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+/**
+ * @brief Write a PoS chain to a new store, every block at the genesis target
+ *
+ * Heights in forged are validated by "Mallory", who is never registered;
+ * the block at relinked (0 = none) names its grandparent as its parent.
+ *
+ * @return Hash of every block, genesis first
+ */
+std::vector<crypto::Hash256> writeStakeChain(const std::string& path, size_t length,
+                                             const std::vector<size_t>& forged, size_t relinked) {
+    using namespace blockchain;
+    Blockchain genesisSource(1);
+    storage::BlockStore store;
+    CHECK(store.open(path));
+    std::vector<Block> blocks{genesisSource.getLastBlock()};
+    CHECK(store.append(blocks[0]));
+    for (size_t height = 1; height < length; height++) {
+        const Block& parent = blocks[height == relinked ? height - 2 : height - 1];
+        Block block(static_cast<int>(height), parent.getHash(), makeTransactions(height, 2));
+        block.setBits(parent.getBits());
+        const bool mallory = std::find(forged.begin(), forged.end(), height) != forged.end();
+        block.validateBlock(mallory ? "Mallory" : "Alice");
+        CHECK(store.append(block));
+        blocks.push_back(block);
+    }
+    std::vector<crypto::Hash256> hashes;
+    for (const auto& block : blocks) {
+        hashes.push_back(block.getHash());
+    }
+    return hashes;
+}
+
+/**
+ * @brief Attach a store to a node that adopts (and so validates) its chain
+ * @return What the node reported on std::cerr
+ */
+std::string attachErrors(blockchain::Blockchain& node, const std::string& path, bool& attached) {
+    CapturedErrors errors;
+    attached = node.attachStore(path);
+    return errors.text.str();
+}
+#endif
+
+/**
+ * @brief Merkle root built the textbook way: one level vector at a time, pairing neighbours
+ */
+crypto::Hash256 referenceMerkleRoot(std::vector<crypto::Hash256> level) {
+    while (level.size() > 1) {
+        if (level.size() % 2 != 0) {
+            level.push_back(level.back());
+        }
+        std::vector<crypto::Hash256> parents;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            uint8_t pair[2 * crypto::Hash256::SIZE];
+            std::memcpy(pair, level[i].data(), crypto::Hash256::SIZE);
+            std::memcpy(pair + crypto::Hash256::SIZE, level[i + 1].data(), crypto::Hash256::SIZE);
+            parents.push_back(crypto::ChainHasher::digest(pair, sizeof(pair)));
+        }
+        level.swap(parents);
+    }
+    return level.empty() ? crypto::Hash256() : level.front();
+}
+
+/**
+ * @brief Feed a message to a hasher in 7-byte pieces
+ */
+template <typename Hasher>
+void updateInPieces(Hasher& hasher, const std::string& message) {
+    for (size_t offset = 0; offset < message.size(); offset += 7) {
+        size_t piece = std::min<size_t>(7, message.size() - offset);
+        hasher.update(reinterpret_cast<const uint8_t*>(message.data()) + offset, piece);
+    }
+}
+
+// ============================================================================
+// Hash functions
+// ============================================================================
+
+void testSha256KnownAnswers() {
+    // FIPS 180-4 / NIST CAVP example messages
+    const std::vector<std::string> messages = {
+        "abc",
+        "",
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+        std::string(1000000, 'a')
+    };
+    const std::vector<std::string> expected = {
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+        "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1",
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"
+    };
+
+    using crypto::SHA256;
+    const crypto::HashBackend savedBackend = SHA256::getBackend();
+    const crypto::BatchKernel savedKernel = SHA256::getBatchKernel();
+
+    // Every supported backend and batch kernel must give the same digests
+    for (crypto::HashBackend backend : {crypto::HashBackend::SCALAR, crypto::HashBackend::SHA_NI}) {
+        if (!SHA256::setBackend(backend)) {
+            continue;
+        }
+        for (size_t i = 0; i < messages.size(); i++) {
+            CHECK(SHA256::hash(messages[i]) == expected[i]);
+
+            SHA256 streamed;
+            updateInPieces(streamed, messages[i]);
+            CHECK(crypto::toHex(streamed.finalize()) == expected[i]);
+        }
+        for (crypto::BatchKernel kernel : {crypto::BatchKernel::SCALAR, crypto::BatchKernel::SSE2,
+                                           crypto::BatchKernel::AVX2, crypto::BatchKernel::AVX512}) {
+            if (SHA256::setBatchKernel(kernel)) {
+                CHECK(SHA256::hashBatch(messages) == expected);
+            }
+        }
+    }
+
+    SHA256::setBackend(savedBackend);
+    SHA256::setBatchKernel(savedKernel);
+}
+
+void testBlake3KnownAnswers() {
+    // Official test vectors: input byte i is i % 251
+    const size_t lengths[] = {0, 1, 64, 65, 1023, 1024, 1025, 2049, 8193};
+    const std::vector<std::string> expected = {
+        "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262",
+        "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213",
+        "4eed7141ea4a5cd4b788606bd23f46e212af9cacebacdc7d1f4c6dc7f2511b98",
+        "de1e5fa0be70df6d2be8fffd0e99ceaa8eb6e8c93a63f2d8d1c30ecb6b263dee",
+        "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11",
+        "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7",
+        "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444",
+        "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030",
+        "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b"
+    };
+
+    std::vector<std::string> messages;
+    for (size_t length : lengths) {
+        std::string m(length, '\0');
+        for (size_t i = 0; i < length; i++) {
+            m[i] = static_cast<char>(i % 251);
+        }
+        messages.push_back(m);
+    }
+
+    using crypto::Blake3;
+    for (size_t i = 0; i < messages.size(); i++) {
+        CHECK(Blake3::hash(messages[i]) == expected[i]);
+
+        Blake3 streamed;
+        updateInPieces(streamed, messages[i]);
+        CHECK(crypto::toHex(streamed.finalize()) == expected[i]);
+    }
+
+    const crypto::BatchKernel savedKernel = Blake3::getBatchKernel();
+    for (crypto::BatchKernel kernel : {crypto::BatchKernel::SCALAR, crypto::BatchKernel::SSE2,
+                                       crypto::BatchKernel::AVX2, crypto::BatchKernel::AVX512}) {
+        if (!Blake3::setBatchKernel(kernel)) {
+            continue;
+        }
+        CHECK(Blake3::hashBatch(messages) == expected);
+
+        // Continuing from a shared midstate must match as well
+        for (size_t split : {size_t(1), size_t(64), size_t(100)}) {
+            Blake3 prefix;
+            prefix.update(reinterpret_cast<const uint8_t*>(messages.back().data()), split);
+            std::vector<const uint8_t*> suffixes;
+            std::vector<size_t> suffixLengths;
+            std::vector<size_t> indices;
+            for (size_t i = 0; i < messages.size(); i++) {
+                if (messages[i].size() >= split) {
+                    suffixes.push_back(reinterpret_cast<const uint8_t*>(messages[i].data()) + split);
+                    suffixLengths.push_back(messages[i].size() - split);
+                    indices.push_back(i);
+                }
+            }
+            std::vector<uint8_t> digests(indices.size() * Blake3::DIGEST_SIZE);
+            prefix.hashSuffixBatch(suffixes.data(), suffixLengths.data(), indices.size(), digests.data());
+            for (size_t k = 0; k < indices.size(); k++) {
+                CHECK(crypto::toHex(digests.data() + k * Blake3::DIGEST_SIZE, Blake3::DIGEST_SIZE) ==
+                      expected[indices[k]]);
+            }
+        }
+    }
+    Blake3::setBatchKernel(savedKernel);
+}
+
+void testSha512KnownAnswers() {
+    const std::vector<std::string> messages = {
+        "",
+        "abc",
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopq"
+        "klmnopqrlmnopqrsmnopqrstnopqrstu"
+    };
+    const std::vector<std::string> expected = {
+        "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+        "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e",
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+        "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+        "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+        "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"
+    };
+
+    for (size_t i = 0; i < messages.size(); i++) {
+        CHECK(crypto::SHA512::hash(messages[i]) == expected[i]);
+
+        crypto::SHA512 streamed;
+        updateInPieces(streamed, messages[i]);
+        CHECK(crypto::toHex(streamed.finalize()) == expected[i]);
+    }
+
+    // Several blocks streamed in pieces match the one-shot digest
+    const std::string longMessage(1000, 'a');
+    crypto::SHA512 streamed;
+    updateInPieces(streamed, longMessage);
+    CHECK(crypto::toHex(streamed.finalize()) == crypto::SHA512::hash(longMessage));
+}
+
+// ============================================================================
+// Signatures
+// ============================================================================
+
+void testEd25519KnownAnswers() {
+    using crypto::Ed25519;
+    struct Vector {
+        const char* seed;
+        const char* publicKey;
+        const char* message;
+        const char* signature;
+    };
+    // RFC 8032 section 7.1, tests 1 to 3 (the first signature is checked by round trip)
+    const Vector vectors[] = {
+        {"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+         "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+         "", nullptr},
+        {"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+         "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+         "72",
+         "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+         "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+        {"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+         "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+         "af82",
+         "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+         "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"},
+    };
+    constexpr size_t COUNT = sizeof(vectors) / sizeof(vectors[0]);
+
+    Ed25519::PublicKey keys[COUNT];
+    Ed25519::Signature signatures[COUNT];
+    std::vector<uint8_t> messages[COUNT];
+    Ed25519::BatchEntry batch[COUNT];
+
+    for (size_t i = 0; i < COUNT; i++) {
+        const Vector& v = vectors[i];
+        Ed25519::Seed seed;
+        messages[i].resize(std::strlen(v.message) / 2);
+        CHECK(crypto::fromHex(v.seed, 64, seed.data(), seed.size()));
+        CHECK(crypto::fromHex(v.message, std::strlen(v.message), messages[i].data(), messages[i].size()));
+
+        const Ed25519::KeyPair pair(seed);
+        keys[i] = pair.getPublicKey();
+        signatures[i] = pair.sign(messages[i].data(), messages[i].size());
+        CHECK(crypto::toHex(keys[i]) == v.publicKey);
+        CHECK(v.signature == nullptr || crypto::toHex(signatures[i]) == v.signature);
+        CHECK(Ed25519::verify(keys[i], messages[i].data(), messages[i].size(), signatures[i]));
+        batch[i] = {&keys[i], &signatures[i], messages[i].data(), messages[i].size()};
+    }
+    CHECK(Ed25519::verifyBatch(batch, COUNT));
+
+    // A single corrupted signature must fail both ways
+    signatures[1][5] ^= 1;
+    CHECK(!Ed25519::verify(keys[1], messages[1].data(), messages[1].size(), signatures[1]));
+    CHECK(!Ed25519::verifyBatch(batch, COUNT));
+}
+
+// ============================================================================
+// Blockchain
+// ============================================================================
+
+void testTransactionEncoding() {
+    using namespace blockchain;
+    crypto::Ed25519::Seed seed;
+    seed.fill(7);
+    const crypto::Ed25519::KeyPair key(seed);
+    Transaction plain = Transaction::fromUnits("Alice", "Bob", 123456789);
+    Transaction signedTx = Transaction::fromUnits(Transaction::addressOf(key.getPublicKey()), "Shop", 42);
+    signedTx.sign(key);
+
+    for (const Transaction* tx : {&plain, &signedTx}) {
+        std::vector<uint8_t> encoded(tx->encodedSize());
+        tx->encode(encoded.data());
+
+        // Every field survives the round trip, and the ID is the digest
+        TransactionView view;
+        CHECK(TransactionView::parse(encoded.data(), encoded.size(), view));
+        CHECK(view.getEncodedSize() == encoded.size());
+        CHECK(view.getBodySize() == tx->bodySize());
+        CHECK(view.computeHash() == tx->getHash());
+        const Transaction decoded = view.toTransaction();
+        CHECK(decoded.getHash() == tx->getHash());
+        CHECK(decoded.getSender() == tx->getSender() && decoded.getReceiver() == tx->getReceiver());
+        CHECK(decoded.getAmount() == tx->getAmount() && decoded.getTimestamp() == tx->getTimestamp());
+        CHECK(decoded.getSequence() == tx->getSequence());
+        CHECK(decoded.isSigned() == tx->isSigned() && decoded.getSignature() == tx->getSignature());
+        CHECK(decoded.getId() == tx->getHash().toHex());
+
+        // Any truncation is refused; trailing bytes belong to the next transaction
+        for (size_t length = 0; length < encoded.size(); length++) {
+            CHECK(!TransactionView::parse(encoded.data(), length, view));
+        }
+        encoded.resize(encoded.size() + 10, 0xFF);
+        CHECK(TransactionView::parse(encoded.data(), encoded.size(), view));
+        CHECK(view.getEncodedSize() == tx->encodedSize());
+
+        // An unknown version or signature flag is not a transaction
+        std::vector<uint8_t> bad(encoded.begin(), encoded.begin() + tx->encodedSize());
+        bad[0] = Transaction::ENCODING_VERSION + 1;
+        CHECK(!TransactionView::parse(bad.data(), bad.size(), view));
+        bad[0] = Transaction::ENCODING_VERSION;
+        bad[tx->bodySize()] = 2;
+        CHECK(!TransactionView::parse(bad.data(), bad.size(), view));
+    }
+    CHECK(signedTx.verifySignature());
+
+    // An address too long for its one-byte length is refused up front
+    bool refused = false;
+    try {
+        Transaction::fromUnits(std::string(Transaction::MAX_ADDRESS_LENGTH + 1, 'a'), "Bob", 1);
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    CHECK(refused);
+}
+
+void testAddressInterning() {
+    using namespace blockchain;
+    AddressTable& table = AddressTable::instance();
+    CHECK(table.intern("") == AddressTable::EMPTY);
+    CHECK(table.resolve(AddressTable::EMPTY).empty());
+
+    // Enough addresses to fill more than one chunk
+    const std::string prefix = "address-interning-test-";
+    const size_t count = 70000;
+    std::vector<AddressId> ids(count);
+    for (size_t i = 0; i < count; i++) {
+        ids[i] = table.intern(prefix + std::to_string(i));
+    }
+    const std::string& first = table.resolve(ids[0]);
+    const std::string* firstAddress = &first;
+
+    // Concurrent interning of the same strings agrees with the first pass
+    std::vector<std::thread> workers;
+    std::vector<int> mismatches(4, 0);
+    for (size_t t = 0; t < mismatches.size(); t++) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < count; i += mismatches.size()) {
+                if (table.intern(prefix + std::to_string(i)) != ids[i]) mismatches[t]++;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    for (int mismatch : mismatches) CHECK(mismatch == 0);
+
+    for (size_t i = 0; i < count; i += 997) {
+        AddressId found = AddressTable::EMPTY;
+        CHECK(table.find(prefix + std::to_string(i), found) && found == ids[i]);
+        CHECK(table.resolve(ids[i]) == prefix + std::to_string(i));
+    }
+    AddressId missing = AddressTable::EMPTY;
+    CHECK(!table.find(prefix + "never-interned", missing));
+
+    // Growing the table never moves a stored address
+    CHECK(&table.resolve(ids[0]) == firstAddress);
+    CHECK(*firstAddress == prefix + "0");
+}
+
+void testParallelValidation() {
+    using namespace blockchain;
+    crypto::Ed25519::Seed seed;
+    seed.fill(9);
+    const crypto::Ed25519::KeyPair key(seed);
+    const std::string sender = Transaction::addressOf(key.getPublicKey());
+    const size_t count = 3 * TransactionValidator::PARALLEL_GRAIN + 17;
+    std::vector<Transaction> good;
+    for (size_t i = 0; i < count; i++) {
+        good.push_back(Transaction::fromUnits(sender, "Shop", static_cast<Amount>(1 + i)));
+        good.back().sign(key);
+    }
+
+    // Same digest, damaged signature
+    auto forge = [](const Transaction& tx) {
+        std::vector<uint8_t> encoded(tx.encodedSize());
+        tx.encode(encoded.data());
+        encoded.back() ^= 0x01;
+        TransactionView view;
+        TransactionView::parse(encoded.data(), encoded.size(), view);
+        return view.toTransaction();
+    };
+    const Transaction forged = forge(good[0]);
+    CHECK(forged.getHash() == good[0].getHash() && !forged.verifySignature());
+
+    // Faults of each kind, alone and with a later one in another chunk
+    const size_t grain = TransactionValidator::PARALLEL_GRAIN;
+    const std::vector<std::vector<std::pair<size_t, int>>> layouts = {
+        {}, {{2 * grain + 5, 0}}, {{grain + 3, 1}, {3 * grain + 2, 0}}, {{grain - 1, 2}, {grain + 1, 1}}, {{0, 0}},
+    };
+    for (const auto& layout : layouts) {
+        std::vector<Transaction> txs = good;
+        for (const auto& fault : layout) {
+            if (fault.second == 0) {
+                txs[fault.first] = forge(good[fault.first]);
+            } else if (fault.second == 1) {
+                txs[fault.first] = Transaction::fromUnits("Shop", "Shop", 1);
+            } else {
+                txs[fault.first] = Transaction::fromUnits("Alice", "Shop", 1);
+            }
+        }
+        TransactionValidator serial(1);
+        const ValidationResult expected = serial.validate(txs, true);
+        CHECK(expected.valid == layout.empty());
+        if (!layout.empty()) {
+            CHECK(expected.failedIndex == layout[0].first);
+        }
+        for (unsigned threads : {2u, 4u, 8u}) {
+            TransactionValidator parallel(threads);
+            for (const ValidationResult& result : {parallel.validate(txs, true), parallel.validateSerial(txs, true)}) {
+                CHECK(result.valid == expected.valid);
+                CHECK(result.failedIndex == expected.failedIndex);
+                CHECK(result.reason == expected.reason);
+            }
+        }
+    }
+
+    // Failures never enter the cache; a passing transaction does, keyed with its signature
+    TransactionValidator cached(4, 1024);
+    const std::vector<Transaction> bad{forged};
+    CHECK(!cached.validate(bad, false).valid);
+    CHECK(!cached.getCache()->contains(forged));
+    const ValidationResult again = cached.validate(bad, false);
+    CHECK(!again.valid && again.cacheHits == 0);
+
+    const std::vector<Transaction> fixed{good[0]};
+    CHECK(cached.validate(fixed, false).valid);
+    CHECK(cached.getCache()->contains(good[0]) && !cached.getCache()->contains(forged));
+    CHECK(cached.validate(fixed, false).cacheHits == 1);
+    CHECK(!cached.validate(bad, false).valid);
+
+    // Transactions ahead of a failure in the same chunk are not recorded either
+    std::vector<Transaction> chunk(good.begin() + 1, good.begin() + 11);
+    chunk.push_back(forged);
+    CHECK(!cached.validate(chunk, false).valid);
+    CHECK(!cached.getCache()->contains(good[1]));
+}
+
+void testMerkleFlatLayout() {
+    using namespace blockchain;
+    // Includes a tree wide enough to hash its leaf level on several threads
+    for (size_t count : {1, 2, 3, 5, 4, 8, 16, 1024, 20000}) {
+        const std::vector<crypto::Hash256> leaves = makeLeaves(count);
+        const MerkleTree tree(leaves);
+        CHECK(tree.getRoot() == referenceMerkleRoot(leaves));
+        CHECK(tree.getLeaves() == leaves);
+    }
+    CHECK(MerkleTree(std::vector<crypto::Hash256>()).getRoot() == crypto::Hash256());
+}
+
+void testMerkleAppendReplace() {
+    using namespace blockchain;
+    const std::vector<crypto::Hash256> leaves = makeLeaves(40);
+    const std::vector<crypto::Hash256> others = makeLeaves(41);
+
+    // Every prefix grown by append() has the root of a fresh tree
+    MerkleTree grown;
+    for (size_t count = 1; count <= leaves.size(); count++) {
+        grown.append(leaves[count - 1]);
+        const std::vector<crypto::Hash256> prefix(leaves.begin(), leaves.begin() + count);
+        CHECK(grown.getLeafCount() == count);
+        CHECK(grown.getRoot() == MerkleTree(prefix).getRoot());
+    }
+
+    // Replacing any leaf, including the last of an odd level, matches a rebuild
+    std::vector<crypto::Hash256> edited(leaves.begin(), leaves.begin() + 37);
+    MerkleTree tree(edited);
+    size_t index = 0;
+    CHECK(tree.findLeaf(edited[5], index) && index == 5);
+    for (size_t i : {size_t(0), size_t(5), size_t(36), size_t(17)}) {
+        edited[i] = others[i];
+        tree.replace(i, others[i]);
+        CHECK(tree.getRoot() == MerkleTree(edited).getRoot());
+        CHECK(tree.findLeaf(others[i], index) && index == i);
+    }
+    CHECK(!tree.verifyTransaction(leaves[5]));
+    tree.append(leaves[37]);
+    edited.push_back(leaves[37]);
+    CHECK(tree.getRoot() == MerkleTree(edited).getRoot());
+    CHECK(tree.findLeaf(leaves[37], index) && index == 37);
+}
+
+void testMerkleProofs() {
+    using namespace blockchain;
+    for (size_t count : {1, 2, 3, 5, 6, 7, 8, 13}) {
+        const std::vector<crypto::Hash256> leaves = makeLeaves(count);
+        const crypto::Hash256 outsider = makeLeaves(count + 100)[0];
+        const MerkleTree tree(leaves);
+        for (size_t i = 0; i < count; i++) {
+            const MerkleProof proof = tree.getProof(i);
+            CHECK(MerkleTree::verifyProof(leaves[i], proof, tree.getRoot()));
+            size_t index = count;
+            CHECK(tree.findLeaf(leaves[i], index) && index == i);
+
+            if (count > 1) {
+                MerkleProof wrongIndex = proof;
+                wrongIndex.leafIndex ^= 1;
+                CHECK(!MerkleTree::verifyProof(leaves[i], wrongIndex, tree.getRoot()));
+                MerkleProof wrongSibling = proof;
+                wrongSibling.siblings[0] = outsider;
+                CHECK(!MerkleTree::verifyProof(leaves[i], wrongSibling, tree.getRoot()));
+            }
+            MerkleProof longer = proof;
+            longer.siblings.push_back(tree.getRoot());
+            CHECK(!MerkleTree::verifyProof(leaves[i], longer, tree.getRoot()));
+        }
+        CHECK(!tree.verifyTransaction(outsider));
+
+        // The padded copy of an odd tree's last leaf is not a leaf
+        if (count % 2 != 0 && count > 1) {
+            MerkleProof padded = tree.getProof(count - 1);
+            padded.leafIndex = static_cast<uint32_t>(count);
+            CHECK(!MerkleTree::verifyProof(leaves[count - 1], padded, tree.getRoot()));
+        }
+    }
+
+    // [a, b, c] and [a, b, c, c] share a root; the duplicate must not prove a fourth leaf
+    const std::vector<crypto::Hash256> three = makeLeaves(3);
+    const MerkleTree odd(three);
+    MerkleTree mutated(std::vector<crypto::Hash256>{three[0], three[1], three[2], three[2]});
+    CHECK(mutated.getRoot() == odd.getRoot());
+    MerkleProof forged = mutated.getProof(3);
+    CHECK(!MerkleTree::verifyProof(three[2], forged, odd.getRoot()));
+}
+
+void testMiningThreads() {
+    QuietOutput quiet;
+    blockchain::Blockchain chain(2);
+    chain.setMiningThreads(4);
+    CHECK(chain.getMiningThreads() == 4);
+    for (size_t height = 1; height <= 3; height++) {
+        CHECK(chain.addBlockPoW(makeTransactions(height, 4)));
+    }
+    CHECK(chain.getChainLength() == 4);
+    CHECK(chain.isChainValid());
+}
+
+void testNonceRange() {
+    using blockchain::consensus::ProofOfWork;
+    using blockchain::consensus::Target;
+    crypto::ChainHasher prefix;
+    prefix.update(std::string("nonce range"));
+
+    // The top of the 32-bit space is searched without wrapping or stopping early
+    const Target unreachable = Target::fromDifficulty(Target::MAX_DIFFICULTY);
+    const uint64_t top = std::numeric_limits<uint32_t>::max();
+    for (unsigned threads : {1u, 3u}) {
+        auto result = ProofOfWork::searchNonce(prefix, "", top - 99, unreachable, threads, nullptr,
+                                               blockchain::consensus::NonceFormat::UINT32_LE);
+        CHECK(!result.found);
+        CHECK(result.hashes == 100);
+    }
+
+    // Nonces above 2^31 are found
+    const Target easy = Target::fromDifficulty(1);
+    auto result = ProofOfWork::searchNonce(prefix, "", top - 10000, easy, 1, nullptr,
+                                           blockchain::consensus::NonceFormat::UINT32_LE);
+    CHECK(result.found);
+    CHECK(result.nonce > static_cast<uint64_t>(std::numeric_limits<int>::max()));
+
+    // ProofOfWork::mine returns the winning hash, never a placeholder digest
+    ProofOfWork pow(1);
+    int nonce = -1;
+    const std::string hash = pow.mine("nonce range", nonce);
+    CHECK(hash.size() == 64 && hash[0] == '0');
+    CHECK(nonce > 0);
+
+    // A block whose nonce space runs out rolls its timestamp and keeps going
+    QuietOutput quiet;
+    blockchain::Block block(1, crypto::Hash256(), makeTransactions(1, 2));
+    block.setBits(easy.toCompact());
+    block.setProofOfWork(static_cast<uint32_t>(top));
+    const time_t timestamp = block.getTimestamp();
+    CHECK(block.mine(1).found);
+    CHECK(block.isValid());
+    CHECK(block.getNonce() == top || block.getTimestamp() > timestamp);
+}
+
+void testPowTargetSchedule() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    const uint32_t easyBits = consensus::Target::fromDifficulty(0).toCompact();
+
+    Blockchain chain(4);
+    chain.setRetarget(0, 600);
+    const Block genesis = chain.getLastBlock();
+
+    // A block that picks its own (easier) target outside a retarget height
+    Block cheap(1, genesis.getHash(), makeTransactions(1, 2));
+    cheap.setBits(easyBits);
+    CHECK(cheap.mine(1).found);
+    CHECK(cheap.isValid());
+    CHECK(!chain.recoverBlock(cheap));
+    CHECK(!chain.submitBlock(cheap));
+    CHECK(chain.getChainLength() == 1);
+
+    Block fair(1, genesis.getHash(), makeTransactions(1, 2));
+    fair.setBits(genesis.getBits());
+    CHECK(fair.mine(1).found);
+    CHECK(chain.recoverBlock(fair));
+    CHECK(chain.isChainValid());
+
+#ifdef BLOCKCHAIN_STORAGE
+    // The same block is refused when adopted from a store...
+    ScratchDirectory directory("pow_schedule");
+    {
+        storage::BlockStore store;
+        CHECK(store.open(directory.path));
+        CHECK(store.append(genesis));
+        CHECK(store.append(cheap));
+    }
+    Blockchain stored(4);
+    stored.setRetarget(0, 600);
+    CHECK(!stored.attachStore(directory.path));
+    CHECK(stored.getChainLength() == 1);
+
+    // ...and caught by isChainValid() when only its header is known from a snapshot
+    Block next(2, cheap.getHash(), makeTransactions(2, 2));
+    next.setBits(easyBits);
+    CHECK(next.mine(1).found);
+    storage::ChainSnapshot snapshot;
+    snapshot.headers.push_back({genesis.getHeader(), genesis.getConsensusType()});
+    snapshot.headers.push_back({cheap.getHeader(), ConsensusType::PROOF_OF_WORK});
+    snapshot.headers.push_back({next.getHeader(), ConsensusType::PROOF_OF_WORK});
+    snapshot.blocks.push_back(next);
+    snapshot.bits = easyBits;
+    snapshot.targetBlockTime = 600;
+    ReplayFilter().encode(snapshot.replayFilter);
+    const std::string snapshotPath = directory.path + "/chain.snap";
+    CHECK(snapshot.save(snapshotPath));
+
+    Blockchain restored(4);
+    restored.setRetarget(0, 600);
+    CHECK(restored.loadSnapshot(snapshotPath));
+    CHECK(!restored.isChainValid());
+#endif
+}
+
+void testMempoolGlobalLimits() {
+    using namespace blockchain;
+    const std::vector<Transaction> txs = makeTransactions(1, Mempool::SHARDS * 2);
+
+    // The count limit is pool-wide, however the IDs fall across shards
+    Mempool pool(Mempool::SHARDS);
+    for (size_t i = 0; i < Mempool::SHARDS; i++) {
+        CHECK(pool.submit(txs[i], 10) == SubmitStatus::ACCEPTED);
+    }
+    CHECK(pool.size() == Mempool::SHARDS);
+    CHECK(pool.submit(txs[Mempool::SHARDS], 10) == SubmitStatus::POOL_FULL);
+    CHECK(pool.submit(txs[0], 50) == SubmitStatus::DUPLICATE);
+
+    // A higher fee evicts the cheapest entry, whichever shard holds it
+    pool.clear();
+    for (size_t i = 0; i < Mempool::SHARDS; i++) {
+        CHECK(pool.submit(txs[i], static_cast<Amount>(100 + i)) == SubmitStatus::ACCEPTED);
+    }
+    CHECK(pool.submit(txs[Mempool::SHARDS], 101) == SubmitStatus::ACCEPTED);
+    CHECK(pool.size() == Mempool::SHARDS);
+    CHECK(!pool.contains(txs[0].getHash()));
+    CHECK(pool.contains(txs[1].getHash()));
+
+    // The byte limit is pool-wide too
+    Mempool small(1000, txs[0].encodedSize() * 3);
+    for (size_t i = 0; i < 3; i++) {
+        CHECK(small.submit(txs[i], 10) == SubmitStatus::ACCEPTED);
+    }
+    CHECK(small.submit(txs[3], 10) == SubmitStatus::POOL_FULL);
+    CHECK(small.getBytes() == txs[0].encodedSize() * 3);
+
+    Amount fees = 0;
+    CHECK(pool.takeBest(Mempool::SHARDS, &fees).size() == Mempool::SHARDS);
+    CHECK(pool.size() == 0 && pool.getBytes() == 0);
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+void testMempoolJournalsAdmissions() {
+    using namespace blockchain;
+    ScratchDirectory directory("mempool_journal");
+    const std::vector<Transaction> txs = makeTransactions(2, 4);
+
+    storage::Journal journal;
+    CHECK(journal.open(directory.path + "/pool.wal"));
+    Mempool pool(2);
+    pool.setJournal(&journal);
+    CHECK(pool.submit(txs[0], 10) == SubmitStatus::ACCEPTED);
+    CHECK(pool.submit(txs[0], 10) == SubmitStatus::DUPLICATE);
+    CHECK(pool.submit(txs[1], 20) == SubmitStatus::ACCEPTED);
+    CHECK(pool.submit(txs[2], 5) == SubmitStatus::POOL_FULL);
+    CHECK(pool.submit(txs[3], 30) == SubmitStatus::ACCEPTED);
+
+    // Only the three admissions were logged, in order
+    std::vector<Amount> fees;
+    CHECK(journal.replay([&](storage::RecordType type, const uint8_t* payload, size_t) {
+        Amount fee = 0;
+        for (int i = 7; i >= 0; i--) {
+            fee = (fee << 8) | payload[i];
+        }
+        fees.push_back(type == storage::RecordType::TRANSACTION ? fee : -1);
+        return true;
+    }));
+    CHECK((fees == std::vector<Amount>{10, 20, 30}));
+    CHECK(journal.getRecords() == 3);
+
+    // A closed journal refuses the record, so nothing is admitted
+    journal.close();
+    CHECK(pool.submit(txs[2], 50) == SubmitStatus::NOT_DURABLE);
+    CHECK(!pool.contains(txs[2].getHash()));
+    CHECK(pool.size() == 2);
+}
+
+void testCheckpointAndRecover() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("checkpoint");
+    const std::string storePath = directory.path + "/blocks";
+    const std::string journalPath = directory.path + "/node.wal";
+    const std::vector<Transaction> txs = makeTransactions(20, 7);
+
+    {
+        storage::Journal journal;
+        Blockchain node(1);
+        node.addValidator("Alice", 100);
+        CHECK(journal.open(journalPath));
+        CHECK(node.attachStore(storePath));
+        node.setJournal(&journal);
+        Mempool pool;
+        pool.setJournal(&journal);
+        for (size_t i = 0; i < 6; i++) {
+            CHECK(pool.submit(txs[i], static_cast<Amount>(10 * (i + 1))) == SubmitStatus::ACCEPTED);
+        }
+        CHECK(node.addBlockPoS(pool.takeBest(2)));
+        CHECK(node.addBlockPoS(pool.takeBest(2)));
+
+        // The stored blocks leave the journal; the two pending transactions stay
+        CHECK(node.checkpoint(&pool));
+        size_t blockRecords = 0;
+        size_t transactionRecords = 0;
+        CHECK(journal.replay([&](storage::RecordType type, const uint8_t*, size_t) {
+            (type == storage::RecordType::BLOCK ? blockRecords : transactionRecords)++;
+            return true;
+        }));
+        CHECK(blockRecords == 0 && transactionRecords == 2);
+
+        // Then a transaction and a block that only reach the journal before the crash
+        CHECK(pool.submit(txs[6], 100) == SubmitStatus::ACCEPTED);
+        Block next(3, node.getLastBlock().getHash(), pool.takeBest(1));
+        next.setBits(node.getLastBlock().getBits());
+        next.validateBlock("Alice");
+        CHECK(journal.appendBlock(next));
+    }
+
+    storage::Journal journal;
+    Blockchain restored(1);
+    restored.addValidator("Alice", 100);
+    CHECK(journal.open(journalPath));
+    CHECK(restored.attachStore(storePath));
+    CHECK(restored.getChainLength() == 3);
+    Mempool pool;
+    RecoveryStats stats;
+    CHECK(restored.recover(journal, &pool, &stats));
+    CHECK(stats.blocks == 1 && stats.transactions == 3);
+    CHECK(restored.getChainLength() == 4);
+    CHECK(restored.isChainValid());
+    CHECK(pool.size() == 2);
+    CHECK(pool.contains(txs[0].getHash()) && pool.contains(txs[1].getHash()));
+    CHECK(!pool.contains(txs[6].getHash()));
+
+    // A checkpoint needs somewhere durable to put the blocks
+    Blockchain memoryOnly(1);
+    memoryOnly.setJournal(&journal);
+    CHECK(!memoryOnly.checkpoint());
+}
+
+void testCheckpointAcrossSegments() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("checkpoint_segments");
+    const std::string storePath = directory.path + "/blocks";
+    const std::string journalPath = directory.path + "/node.wal";
+    const uint64_t segmentSize = 2048;
+
+    crypto::Hash256 tipHash;
+    {
+        storage::Journal journal;
+        Blockchain node(1);
+        node.addValidator("Alice", 100);
+        CHECK(journal.open(journalPath));
+        CHECK(node.attachStore(storePath, Blockchain::DEFAULT_RESIDENT_BLOCKS, segmentSize));
+        node.setJournal(&journal);
+        CHECK(node.addBlockPoS(makeTransactions(1, 4)));
+        CHECK(node.checkpoint());
+
+        // Enough blocks after the checkpoint to fill several segments
+        for (size_t height = 2; height <= 24; height++) {
+            CHECK(node.addBlockPoS(makeTransactions(height, 4)));
+        }
+        CHECK(node.checkpoint());
+        size_t records = 0;
+        CHECK(journal.replay([&](storage::RecordType, const uint8_t*, size_t) {
+            records++;
+            return true;
+        }));
+        CHECK(records == 0);
+        tipHash = node.getLastBlock().getHash();
+    }
+
+    storage::BlockStore store(segmentSize);
+    CHECK(store.open(storePath));
+    CHECK(store.getSegmentCount() > 2);
+    CHECK(store.size() == 25);
+    store.close();
+
+    // Every segment written before the checkpoint reads back in full
+    Blockchain restored(1);
+    restored.addValidator("Alice", 100);
+    CHECK(restored.attachStore(storePath));
+    CHECK(restored.getChainLength() == 25);
+    CHECK(restored.getLastBlock().getHash() == tipHash);
+    CHECK(restored.isChainValid());
+}
+
+void testRecoverAfterCrash() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("recover");
+    const std::string storePath = directory.path + "/blocks";
+    const std::string journalPath = directory.path + "/node.wal";
+    const std::vector<Transaction> txs = makeTransactions(30, 3);
+
+    crypto::Hash256 tipHash;
+    {
+        storage::Journal journal;
+        Blockchain node(1);
+        node.addValidator("Alice", 100);
+        CHECK(journal.open(journalPath));
+        CHECK(node.attachStore(storePath));
+        node.setJournal(&journal);
+        Mempool pool;
+        pool.setJournal(&journal);
+        for (size_t i = 0; i < txs.size(); i++) {
+            CHECK(pool.submit(txs[i], static_cast<Amount>(10 + i)) == SubmitStatus::ACCEPTED);
+        }
+        CHECK(node.addBlockPoS(pool.takeBest(2)));
+        tipHash = node.getLastBlock().getHash();
+    }
+
+    // Power loss in the middle of the next record
+    {
+        std::FILE* file = std::fopen(journalPath.c_str(), "ab");
+        const uint8_t torn[12] = {64, 0, 0, 0, 1, 2, 3, 4, 2, 9, 9, 9};
+        CHECK(file != nullptr && std::fwrite(torn, 1, sizeof(torn), file) == sizeof(torn));
+        std::fclose(file);
+    }
+
+    // Every acknowledged transaction comes back, confirmed or pending
+    {
+        storage::Journal journal;
+        Blockchain restored(1);
+        restored.addValidator("Alice", 100);
+        CHECK(journal.open(journalPath));
+        CHECK(restored.attachStore(storePath));
+        Mempool pool;
+        RecoveryStats stats;
+        CHECK(restored.recover(journal, &pool, &stats));
+        CHECK(stats.blocks == 1 && stats.transactions == 3);
+        CHECK(restored.getChainLength() == 2);
+        CHECK(restored.getLastBlock().getHash() == tipHash);
+        CHECK(restored.isChainValid());
+        CHECK(pool.size() == 1 && pool.contains(txs[0].getHash()));
+    }
+
+    // A journal from another chain does not fit and is refused
+    Blockchain stranger(1);
+    stranger.addValidator("Alice", 100);
+    storage::Journal journal;
+    CHECK(journal.open(journalPath));
+    CHECK(!stranger.recover(journal));
+    CHECK(stranger.getChainLength() == 1);
+}
+#endif
+
+void testReplayFilterCoverage() {
+    using namespace blockchain;
+    std::vector<std::vector<crypto::Hash256>> blockIds(40);
+    for (size_t block = 0; block < blockIds.size(); block++) {
+        for (const auto& tx : makeTransactions(block, 3)) {
+            blockIds[block].push_back(tx.getHash());
+        }
+    }
+    auto idsOf = [&](size_t block) { return blockIds[block]; };
+
+    // Window of 2 blocks, 8 IDs per generation, 3 IDs per block
+    ReplayFilter filter(2, 8);
+    for (size_t block = 0; block < 2; block++) {
+        filter.recordBlock(idsOf(block));
+    }
+    CHECK(filter.getFilteredBlocks() == 0);
+    CHECK(filter.check(idsOf(0)[0]) == ReplayCheck::CONFIRMED);
+
+    for (size_t block = 2; block < 5; block++) {
+        filter.recordBlock(idsOf(block));
+    }
+    // Block 2 fills the first generation and spills into the next, so it counts twice
+    CHECK(filter.getFilteredBlocks() == 4);
+    CHECK(filter.check(idsOf(0)[0]) == ReplayCheck::POSSIBLE);
+
+    // Once the first generation is dropped, coverage stops growing
+    for (size_t block = 5; block < 40; block++) {
+        filter.recordBlock(idsOf(block));
+    }
+    CHECK(filter.getFilteredBlocks() <= 2 * 8 / 3 + 2);
+    CHECK(filter.check(idsOf(37)[1]) == ReplayCheck::POSSIBLE);
+
+    // The coverage survives encoding
+    std::vector<uint8_t> encoded;
+    filter.encode(encoded);
+    ReplayFilter restored;
+    size_t offset = 0;
+    CHECK(restored.decode(encoded.data(), encoded.size(), offset));
+    CHECK(offset == encoded.size());
+    CHECK(restored.getFilteredBlocks() == filter.getFilteredBlocks());
+}
+
+void testReplayBelowWindow() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    Blockchain chain(1);
+    chain.addValidator("Alice", 100);
+    const size_t blocks = ReplayFilter::DEFAULT_WINDOW_BLOCKS + 10;
+    std::vector<std::vector<Transaction>> history;
+    for (size_t height = 1; height <= blocks; height++) {
+        history.push_back(makeTransactions(height, 2));
+        CHECK(chain.addBlockPoS(history.back()));
+    }
+    CHECK(!chain.addBlockPoS(history.front()));
+    CHECK(!chain.addBlockPoS(history.back()));
+    CHECK(chain.addBlockPoS(makeTransactions(blocks + 1, 2)));
+}
+
+#ifdef BLOCKCHAIN_STORAGE
+void testSnapshotReplayDecisions() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("snapshot_replay");
+    const std::string storePath = directory.path + "/blocks";
+    const std::string snapshotPath = directory.path + "/chain.snap";
+    const std::string resavedPath = directory.path + "/again.snap";
+
+    // Long enough that the oldest blocks are neither in the window nor saved in full
+    const size_t blocks = Blockchain::SNAPSHOT_BLOCKS + ReplayFilter::DEFAULT_WINDOW_BLOCKS + 10;
+    std::vector<std::vector<Transaction>> history;
+    Blockchain stored(1);
+    stored.addValidator("Alice", 100);
+    CHECK(stored.attachStore(storePath));
+    for (size_t height = 1; height <= blocks; height++) {
+        history.push_back(makeTransactions(height, 2));
+        CHECK(stored.addBlockPoS(history.back()));
+    }
+    CHECK(stored.saveSnapshot(snapshotPath));
+
+    Blockchain restored(1);
+    CHECK(restored.loadSnapshot(snapshotPath));
+    CHECK(restored.saveSnapshot(resavedPath));
+    Blockchain resaved(1);
+    CHECK(resaved.loadSnapshot(resavedPath));
+
+    // Header-only blocks decide like stored ones: confirmed IDs are refused, new ones taken
+    for (size_t height : {size_t(1), size_t(2), size_t(10), blocks - Blockchain::SNAPSHOT_BLOCKS}) {
+        const std::vector<Transaction>& replay = history[height - 1];
+        CHECK(!stored.addBlockPoS(replay));
+        CHECK(!restored.addBlockPoS(replay));
+        CHECK(!resaved.addBlockPoS(replay));
+    }
+    const std::vector<Transaction> fresh = makeTransactions(blocks + 1, 2);
+    CHECK(stored.addBlockPoS(fresh));
+    CHECK(restored.addBlockPoS(fresh));
+    CHECK(resaved.addBlockPoS(fresh));
+    CHECK(restored.getChainLength() == stored.getChainLength());
+}
+
+void testChainValidationRuns() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("validation_runs");
+    const size_t length = 3 * Blockchain::VALIDATION_GRAIN + 10;
+
+    // Adopting a store runs isChainValid() on the validation threads
+    auto adoptErrors = [](const std::string& path, bool& adopted) {
+        Blockchain node(1);
+        node.setRetarget(0, 600);
+        node.addValidator("Alice", 100);
+        node.setValidationThreads(4);
+        return attachErrors(node, path, adopted);
+    };
+
+    bool adopted = false;
+    writeStakeChain(directory.path + "/valid", length, {}, 0);
+    std::string report = adoptErrors(directory.path + "/valid", adopted);
+    CHECK(report.empty() && adopted);
+
+    // Two faults in later runs: the lower one is reported
+    const size_t grain = Blockchain::VALIDATION_GRAIN;
+    writeStakeChain(directory.path + "/forged", length, {2 * grain + 20, grain + 30}, 0);
+    report = adoptErrors(directory.path + "/forged", adopted);
+    CHECK(!adopted);
+    CHECK(report.find("Error at block " + std::to_string(grain + 30) + ": Invalid validator") != std::string::npos);
+
+    // A broken link at the first block of a run is only seen when the runs are stitched,
+    // and it outranks a fault found later inside that run
+    writeStakeChain(directory.path + "/relinked", length, {2 * grain + 20}, 2 * grain + 1);
+    report = adoptErrors(directory.path + "/relinked", adopted);
+    CHECK(!adopted);
+    CHECK(report.find("Error at block " + std::to_string(2 * grain + 1) + ": Previous hash mismatch") !=
+          std::string::npos);
+    CHECK(report.find("Invalid validator") == std::string::npos);
+}
+
+void testCheckpointShortcut() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("checkpoint_shortcut");
+    const size_t length = 40;
+    const size_t checkpointHeight = 20;
+    auto makeNode = [](Blockchain& node, const crypto::Hash256& checkpointHash, bool full) {
+        node.setRetarget(0, 600);
+        node.addValidator("Alice", 100);
+        node.addCheckpoint(checkpointHeight, checkpointHash);
+        node.setFullValidation(full);
+    };
+    bool attached = false;
+
+    // A forged block below the checkpoint is not re-validated...
+    const std::string forgedPath = directory.path + "/forged";
+    const std::vector<crypto::Hash256> forged = writeStakeChain(forgedPath, length, {5}, 0);
+    {
+        Blockchain node(1);
+        makeNode(node, forged[checkpointHeight], false);
+        CHECK(attachErrors(node, forgedPath, attached).empty() && attached);
+        CHECK(node.isChainValid());
+
+        // ...until full validation is forced on the same chain
+        node.setFullValidation(true);
+        CHECK(!node.isChainValid());
+    }
+    {
+        Blockchain node(1);
+        makeNode(node, forged[checkpointHeight], true);
+        CHECK(attachErrors(node, forgedPath, attached).find("Error at block 5: Invalid validator") != std::string::npos);
+        CHECK(!attached);
+    }
+
+    // Links below the checkpoint are still checked
+    const std::string relinkedPath = directory.path + "/relinked";
+    const std::vector<crypto::Hash256> relinked = writeStakeChain(relinkedPath, length, {}, 7);
+    {
+        Blockchain node(1);
+        makeNode(node, relinked[checkpointHeight], false);
+        CHECK(attachErrors(node, relinkedPath, attached).find("Error at block 7: Previous hash mismatch") !=
+              std::string::npos);
+        CHECK(!attached);
+    }
+
+    // The checkpoint itself and the blocks above it are fully validated
+    for (size_t height : {checkpointHeight, checkpointHeight + 5}) {
+        const std::string path = directory.path + "/above" + std::to_string(height);
+        const std::vector<crypto::Hash256> hashes = writeStakeChain(path, length, {height}, 0);
+        Blockchain node(1);
+        makeNode(node, hashes[checkpointHeight], false);
+        const std::string report = attachErrors(node, path, attached);
+        CHECK(report.find("Error at block " + std::to_string(height) + ": Invalid validator") != std::string::npos);
+        CHECK(!attached);
+    }
+
+    // A checkpoint that does not match the chain is an error, not a shortcut
+    Blockchain mismatched(1);
+    makeNode(mismatched, forged[checkpointHeight - 1], false);
+    CHECK(attachErrors(mismatched, forgedPath, attached).find("Checkpoint mismatch") != std::string::npos);
+    CHECK(!attached);
+}
+
+void testAttachStoreChecks() {
+    using namespace blockchain;
+    QuietOutput quiet;
+    ScratchDirectory directory("attach_store");
+    const std::string storePath = directory.path + "/blocks";
+    const std::string snapshotPath = directory.path + "/chain.snap";
+
+    crypto::Hash256 tipHash;
+    uint32_t tipBits = 0;
+    {
+        Blockchain node(1);
+        node.addValidator("Alice", 100);
+        CHECK(node.attachStore(storePath));
+        for (size_t height = 1; height <= 3; height++) {
+            CHECK(node.addBlockPoS(makeTransactions(height, 2)));
+        }
+        CHECK(node.saveSnapshot(snapshotPath));
+        tipHash = node.getLastBlock().getHash();
+        tipBits = node.getLastBlock().getBits();
+    }
+
+    // A store never replaces a chain that has grown past genesis
+    Blockchain other(1);
+    other.addValidator("Alice", 100);
+    CHECK(other.addBlockPoS(makeTransactions(10, 2)));
+    CHECK(!other.attachStore(storePath));
+    CHECK(other.getChainLength() == 2);
+
+    // Adopting a valid store works, with the validator registered first
+    Blockchain adopted(1);
+    adopted.addValidator("Alice", 100);
+    CHECK(adopted.attachStore(storePath));
+    CHECK(adopted.getChainLength() == 4);
+
+    // A block stored beyond the snapshot is checked before it is applied
+    {
+        storage::BlockStore store;
+        CHECK(store.open(storePath));
+        Block forged(4, tipHash, makeTransactions(4, 2));
+        forged.setBits(tipBits);
+        forged.validateBlock("Mallory");
+        CHECK(store.append(forged));
+    }
+    Blockchain restored(1);
+    CHECK(restored.loadSnapshot(snapshotPath));
+    CHECK(!restored.attachStore(storePath));
+    CHECK(restored.getChainLength() == 4);
+
+    // ...and a stored chain containing it is not adopted
+    Blockchain fresh(1);
+    fresh.addValidator("Alice", 100);
+    CHECK(!fresh.attachStore(storePath));
+    CHECK(fresh.getChainLength() == 1);
+}
+#endif
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+const TestCase TESTS[] = {
+    {"SHA-256 known answers", testSha256KnownAnswers},
+    {"BLAKE3 known answers", testBlake3KnownAnswers},
+    {"SHA-512 known answers", testSha512KnownAnswers},
+    {"Ed25519 known answers", testEd25519KnownAnswers},
+    {"Transactions round-trip through the binary encoding", testTransactionEncoding},
+    {"Interned addresses keep stable IDs", testAddressInterning},
+    {"Parallel transaction validation matches a serial pass", testParallelValidation},
+    {"Flat Merkle trees match a pairwise build", testMerkleFlatLayout},
+    {"Merkle append and replace match a rebuild", testMerkleAppendReplace},
+    {"Merkle proofs verify every leaf and nothing else", testMerkleProofs},
+    {"PoW blocks mined on several threads", testMiningThreads},
+    {"Nonce search covers 32 bits", testNonceRange},
+    {"PoW targets follow the schedule", testPowTargetSchedule},
+    {"Mempool limits are pool-wide", testMempoolGlobalLimits},
+#ifdef BLOCKCHAIN_STORAGE
+    {"Mempool journals only admitted transactions", testMempoolJournalsAdmissions},
+    {"Checkpoints keep pending transactions for recovery", testCheckpointAndRecover},
+    {"Checkpoints cover blocks across segment rollovers", testCheckpointAcrossSegments},
+    {"Recovery survives a torn journal", testRecoverAfterCrash},
+#endif
+    {"Replay filter tracks the blocks it covers", testReplayFilterCoverage},
+    {"Replays below the exact window are rejected", testReplayBelowWindow},
+#ifdef BLOCKCHAIN_STORAGE
+    {"Snapshot nodes decide replays like stored nodes", testSnapshotReplayDecisions},
+    {"Chain validation reports the lowest fault across runs", testChainValidationRuns},
+    {"Checkpoints skip full validation below them only", testCheckpointShortcut},
+    {"Stored blocks are validated when attached", testAttachStoreChecks},
+#endif
+};
+
+} // namespace
+
+int main() {
+    size_t failedTests = 0;
+    for (const TestCase& test : TESTS) {
+        const int before = failures;
+        test.run();
+        const bool passed = failures == before;
+        failedTests += passed ? 0 : 1;
+        std::cout << "  " << (passed ? "✓ " : "✗ ") << test.name << std::endl;
+    }
+
+    const size_t total = sizeof(TESTS) / sizeof(TESTS[0]);
+    std::cout << "\n  " << total - failedTests << "/" << total << " tests passed" << std::endl;
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file miner.cpp
+ * @brief Stand-alone miner for a get-work server
+ * @author Blockchain Project
+ * @date 2025
+ *
+ * Usage: miner [socket-path] [threads] [blocks]
+ *
+ * Repeatedly fetches a header template and nonce range, searches it
+ * with the midstate-cached nonce search and submits any solution.
+ * threads = 0 uses every core; blocks = 0 mines until interrupted.
+ */
+
+#include "mining/work_client.h"
+#include "consensus/proof_of_work.h"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace blockchain;
+
+namespace {
+
+std::atomic<bool> interrupted(false);
+
+void onSignal(int) {
+    interrupted.store(true);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string socketPath = argc > 1 ? argv[1] : mining::DEFAULT_SOCKET_PATH;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+    const unsigned long blocks = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    mining::WorkClient client;
+    if (!client.connect(socketPath)) {
+        std::cerr << "✗ Cannot connect to work server at " << socketPath << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Connected to " << socketPath << std::endl;
+
+    unsigned long accepted = 0;
+    while (!interrupted.load() && (blocks == 0 || accepted < blocks)) {
+        mining::WorkUnit work;
+        if (!client.getWork(work)) {
+            std::cerr << "✗ Lost connection to work server" << std::endl;
+            return 1;
+        }
+
+        consensus::Target target;
+        if (!consensus::Target::fromCompact(work.header.bits, target) || target.isZero() ||
+            work.nonceCount == 0) {
+            std::cerr << "✗ Job " << work.jobId << ": unusable work unit" << std::endl;
+            return 1;
+        }
+
+        // Absorb the fixed header prefix once for the whole range
+        uint8_t encoded[BlockHeader::SIZE];
+        work.header.encode(encoded);
+        crypto::ChainHasher prefix;
+        prefix.update(encoded, BlockHeader::NONCE_OFFSET);
+
+        const uint64_t lastNonce = static_cast<uint64_t>(work.nonceStart) + (work.nonceCount - 1);
+        consensus::MiningResult result = consensus::ProofOfWork::searchNonce(
+            prefix, "", work.nonceStart, target, threads, &interrupted,
+            consensus::NonceFormat::UINT32_LE, lastNonce);
+
+        std::cout << "  → Job " << work.jobId << " block #" << work.header.index
+                  << " | Nonces " << work.nonceStart << "-" << lastNonce
+                  << " | Rate: " << std::fixed << std::setprecision(2)
+                  << result.hashRate() / 1e6 << " MH/s" << std::endl;
+
+        if (!result.found) {
+            continue;
+        }
+
+        mining::SubmitStatus status;
+        if (!client.submit({work.jobId, static_cast<uint32_t>(result.nonce)}, status)) {
+            std::cerr << "✗ Lost connection to work server" << std::endl;
+            return 1;
+        }
+        std::cout << "  ✓ Nonce " << result.nonce << " " << mining::toString(status) << std::endl;
+        if (status == mining::SubmitStatus::ACCEPTED) {
+            accepted++;
+        }
+    }
+
+    std::cout << "Blocks accepted: " << accepted << std::endl;
+    return 0;
+}